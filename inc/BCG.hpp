@@ -26,6 +26,9 @@
  * - @subpage BCG_Console
  * - @subpage BCG_Files
  * - @subpage BCG_Types
+ * - @subpage BCG_Parallel
+ * - @subpage BCG_MonteCarlo
+ * - @subpage BCG_Matrix
  *
  * All symbols and functions of the <em>Blue Chameleon Globals</em> module are
  * defined in the BCG namespace.
@@ -34,15 +37,18 @@
  * binary size, you may opt to include only some of the submodules. Do so by
  * #defining either of these flags before #including BCG:
  *
- * * \c BCG_RANDOM
- * * \c BCG_MATHS
+ * * \c BCG_RANDOM (will load \c BCG_PARALLEL as well)
+ * * \c BCG_MATHS (will load \c BCG_PARALLEL as well)
  * * \c BCG_VECTOR
  * * \c BCG_STRING
  * * \c BCG_CONSOLE (will load \c BCG_STRING as well)
  * * \c BCG_FILES
  * * \c BCG_TYPES
+ * * \c BCG_PARALLEL
+ * * \c BCG_MONTECARLO (will load \c BCG_RANDOM, \c BCG_PARALLEL and \c BCG_CONSOLE as well)
+ * * \c BCG_MATRIX (will load \c BCG_MATHS and \c BCG_PARALLEL as well)
  *
- * @todo BCG.hpp: include GSL wrapper and matrix
+ * @todo BCG.hpp: include GSL wrapper
  * @}
  */
 
@@ -52,13 +58,16 @@
 // ========================================================================= //
 // component selector
 
-# if  !defined(BCG_RANDOM)  && \
-      !defined(BCG_MATHS)   && \
-      !defined(BCG_VECTOR)  && \
-      !defined(BCG_STRING)  && \
-      !defined(BCG_CONSOLE) && \
-      !defined(BCG_FILES)   && \
-      !defined(BCG_TYPES)
+# if  !defined(BCG_RANDOM)     && \
+      !defined(BCG_MATHS)      && \
+      !defined(BCG_VECTOR)     && \
+      !defined(BCG_STRING)     && \
+      !defined(BCG_CONSOLE)    && \
+      !defined(BCG_FILES)      && \
+      !defined(BCG_TYPES)      && \
+      !defined(BCG_PARALLEL)   && \
+      !defined(BCG_MONTECARLO) && \
+      !defined(BCG_MATRIX)
 #   define BCG_ALL
 # endif
 
@@ -70,11 +79,38 @@
 #   define BCG_CONSOLE
 #   define BCG_FILES
 #   define BCG_TYPES
+#   define BCG_PARALLEL
+#   define BCG_MONTECARLO
+#   define BCG_MATRIX
 # endif
 
 // -------------------------------------------------------------------------- //
 // dependency resolution
 
+# if defined(BCG_MONTECARLO)
+#   if !defined(BCG_RANDOM)
+#     define BCG_RANDOM
+#   endif
+#   if !defined(BCG_PARALLEL)
+#     define BCG_PARALLEL
+#   endif
+#   if !defined(BCG_CONSOLE)
+#     define BCG_CONSOLE
+#   endif
+# endif
+
+# if defined(BCG_MATRIX) && !defined(BCG_MATHS)
+#   define BCG_MATHS
+# endif
+
+# if defined(BCG_RANDOM) && !defined(BCG_PARALLEL)
+#   define BCG_PARALLEL
+# endif
+
+# if defined(BCG_MATHS) && !defined(BCG_PARALLEL)
+#   define BCG_PARALLEL
+# endif
+
 # if defined(BCG_CONSOLE) && !defined(BCG_STRING)
 #   define BCG_STRING
 # endif
@@ -86,6 +122,10 @@
 // ========================================================================= //
 // component loader
 
+# if defined(BCG_PARALLEL)
+#   include "BCG/Parallel.hpp"
+# endif
+
 # if defined(BCG_RANDOM)
 #   include "BCG/Random.hpp"
 # endif
@@ -114,6 +154,14 @@
 #   include "BCG/Types.hpp"
 # endif
 
+# if defined(BCG_MONTECARLO)
+#   include "BCG/MonteCarlo.hpp"
+# endif
+
+# if defined(BCG_MATRIX)
+#   include "BCG/Matrix.hpp"
+# endif
+
 // ========================================================================= //
 // core components
 
@@ -124,8 +172,9 @@ namespace BCG {
   /**
    * @brief initializes various some of the constants used by BCG.
    *
-   * This will update the value or state of \c isTTY, \c PRGN, \c RNGseed,
-   * \c rand_percentage_distribution and \c rand_phase_distribution.
+   * This will update the value or state of \c isTTY, \c PRGN, \c CBRNG,
+   * \c RNGseed, \c rand_percentage_distribution,
+   * \c rand_phase_distribution and \c nThreads.
    */
   void init();
 
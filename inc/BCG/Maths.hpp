@@ -2,9 +2,6 @@
  * @defgroup BCG_Maths BCG Maths Module
  *
  * @brief commonly used extensions to the STL maths library
- *
- * @todo include multinomial
- *
  */
 
 #ifndef BCG_MATHS_HPP
@@ -18,11 +15,18 @@
 #include <sstream>
 #include <complex>
 #include <vector>
+#include <array>
 #include <iterator>
+#include <ranges>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
 
 #include <functional>
+#include <algorithm>
 
 #include <cmath>
+#include <limits>
 #include <numeric>
 
 // ========================================================================== //
@@ -40,6 +44,42 @@ namespace BCG {
   //! @brief the numerical value of @f$\pi@f$
   constexpr double PI = std::atan(1.0) * 4;
 
+  /**
+   * @brief the number of values that the norms compute at once from a range
+   *  that is not contiguous in memory. See norm_Euclidean_real().
+   */
+  constexpr size_t lazyChunkSize = 512;
+
+  // ------------------------------------------------------------------------ //
+  // type traits
+
+  //! @brief \c value is \c true if \c T is an instance of \c std::complex
+  template<class T> struct is_complex                  : std::false_type {};
+  template<class T> struct is_complex<std::complex<T>> : std::true_type  {};
+
+  //! @brief shorthand for is_complex<T>::value
+  template<class T>
+  constexpr bool is_complex_v = is_complex<std::remove_cv_t<T>>::value;
+
+  // ------------------------------------------------------------------------ //
+  // enums and structs
+
+  /**
+   * @brief how the norms and summation() add up their terms
+   *
+   * For @f$N@f$ terms, the error of the result is bounded by
+   * @f$\epsilon \sum_i |x_i|@f$ times a factor of about @f$N@f$ for
+   * \c Naive, @f$\log_2 N@f$ for \c Pairwise and 2 for \c Neumaier, where
+   * @f$\epsilon@f$ is the machine precision. The SIMD kernels of the
+   * \c _real norms on contiguous \c double and \c float ranges run all three
+   * modes at a comparable speed.
+   */
+  enum class SummationMode {
+    Naive,                                                                      //!< one running sum per SIMD lane
+    Pairwise,                                                                   //!< naive sums of blocks of 1024 terms, added as a binary tree
+    Neumaier                                                                    //!< compensated summation (Kahan-Babuska-Neumaier)
+  };
+
   // ------------------------------------------------------------------------ //
   // type conversion
 
@@ -53,6 +93,23 @@ namespace BCG {
   // ------------------------------------------------------------------------ //
   // vector norm and distance
 
+  /**
+   * @brief computes @f$\sum_i \mathrm{term}(x_i)@f$ over the range
+   *  <tt>[begin, end)</tt>, adding up as selected by \c mode
+   *
+   * This is the scalar fallback of the norms for ranges that cannot be handed
+   * to the SIMD kernels, e.g. \c std::list or complex values. It works with
+   * input iterators, i.e. makes a single pass over the range.
+   *
+   * @param begin iterator to the first value
+   * @param end iterator past the last value
+   * @param term a callable, taking a value of the range and returning a
+   *  \c double
+   * @param mode see SummationMode
+   */
+  template<class Iterator, class Term>
+  double summation(Iterator begin, Iterator end, Term term, const SummationMode mode = SummationMode::Naive);
+
   /**
    * @brief compute the Euclidean norm of a vector, given by an arbitrary STL
    *  container
@@ -63,15 +120,16 @@ namespace BCG {
    *  || x || = \sqrt{ \sum_i x_i \cdot x_i^*}
    * @f]
    *
-   * @attention this function is implemented in terms of \c BCG::complex_d_t and
-   *  will implicitly cast its operands to that type. While the result is
-   *  mathematically correct when used with reals or integers, the type
-   *  conversion can take considerable time. Use norm_Euclidean_real() when
-   *  handling a \c double vector or implement your own version based on
-   *  \c std::transform_reduce.
+   * The implementation is chosen at compile time from the \c value_type of
+   * \c Iterator: complex values are reduced via \c std::norm, floating point
+   * values are forwarded to norm_Euclidean_real(), and all other values are
+   * converted to \c double one at a time. No value is promoted to
+   * \c BCG::complex_d_t.
+   *
+   * The squares are added up as selected by \c mode, see SummationMode.
    */
   template<class Iterator>
-  double norm_Euclidean(Iterator begin, Iterator end);
+  double norm_Euclidean(Iterator begin, Iterator end, const SummationMode mode = SummationMode::Naive);
 
   /**
    * @brief computes the square of the Euclidean norm of a vector, given by an
@@ -83,15 +141,11 @@ namespace BCG {
    *  || x || = \sum_i x_i \cdot x_i^*
    * @f]
    *
-   * @attention this function is implemented in terms of \c BCG::complex_d_t and
-   *  will implicitly cast its operands to that type. While the result is
-   *  mathematically correct when used with reals or integers, the type
-   *  conversion can take considerable time. Use norm_modSquareSum_real() when
-   *  handling a \c double vector or implement your own version based on
-   *  \c std::transform_reduce.
+   * Like norm_Euclidean(), this dispatches on the \c value_type of
+   * \c Iterator at compile time.
    */
   template<class Iterator>
-  double norm_modSquareSum(Iterator begin, Iterator end);
+  double norm_modSquareSum(Iterator begin, Iterator end, const SummationMode mode = SummationMode::Naive);
 
   /**
    * @brief computes the taxicab norm of a vector, given by an arbitrary STL
@@ -102,15 +156,12 @@ namespace BCG {
    *  || x || = \sum_i |x_i|
    * @f]
    *
-   * @attention this function is implemented in terms of \c BCG::complex_d_t and
-   *  will implicitly cast its operands to that type. While the result is
-   *  mathematically correct when used with reals or integers, the type
-   *  conversion can take considerable time. Use norm_absSum_real() when
-   *  handling a \c double vector or implement your own version based on
-   *  \c std::transform_reduce.
+   * Like norm_Euclidean(), this dispatches on the \c value_type of
+   * \c Iterator at compile time. For complex values, @f$|x_i|@f$ is the
+   * modulus.
    */
   template<class Iterator>
-  double norm_absSum(Iterator begin, Iterator end);
+  double norm_absSum(Iterator begin, Iterator end, const SummationMode mode = SummationMode::Naive);
 
   /**
    * @brief computes the maximum norm of a vector, given by an arbitrary STL
@@ -121,74 +172,475 @@ namespace BCG {
    *  || x || = \max |x_i|
    * @f]
    *
-   * @attention this function is implemented in terms of \c BCG::complex_d_t and
-   *  will implicitly cast its operands to that type. While the result is
-   *  mathematically correct when used with reals or integers, the type
-   *  conversion can take considerable time. Use std::max_element() when
-   *  handling real valued vectors.
+   * Like norm_Euclidean(), this dispatches on the \c value_type of
+   * \c Iterator at compile time. For complex values, @f$|x_i|@f$ is the
+   * modulus. The norm of an empty range is 0.
    */
   template<class Iterator>
   double norm_max(Iterator begin, Iterator end);
 
+  /**
+   * @brief computes norm_Euclidean() of a whole range, such as a
+   *  \c std::vector or a lazy vector expression of the Vector module
+   *
+   * \b Example:
+   * @code
+   * const double distance = BCG::norm_Euclidean(BCG::lazy(x) - y);         // no temporary vector
+   * @endcode
+   */
+  template<std::ranges::range Range>
+  double norm_Euclidean(const Range & x, const SummationMode mode = SummationMode::Naive);
+
+  //! @brief computes norm_modSquareSum() of a whole range. See norm_Euclidean(const Range &, const SummationMode).
+  template<std::ranges::range Range>
+  double norm_modSquareSum(const Range & x, const SummationMode mode = SummationMode::Naive);
+
+  //! @brief computes norm_absSum() of a whole range. See norm_Euclidean(const Range &, const SummationMode).
+  template<std::ranges::range Range>
+  double norm_absSum(const Range & x, const SummationMode mode = SummationMode::Naive);
+
+  //! @brief computes norm_max() of a whole range. See norm_Euclidean(const Range &, const SummationMode).
+  template<std::ranges::range Range>
+  double norm_max(const Range & x);
+
+
+  /**
+   * @brief Optimized version of norm_Euclidean() for \c double valued vectors
+   *
+   * Contiguous ranges of \c double or \c float, such as \c std::vector or
+   * \c std::array, are forwarded to the SIMD kernels of
+   * norm_modSquareSum_real(const double *, const double *). For other random
+   * access ranges, such as lazy vector expressions, and SummationMode::Naive,
+   * the values are copied in chunks of \c lazyChunkSize into a buffer on the
+   * stack, which is passed to the same kernels. All other ranges are reduced
+   * with \c std::transform_reduce.
+   */
+  template<class Iterator>
+  double norm_Euclidean_real(Iterator begin, Iterator end, const SummationMode mode = SummationMode::Naive);
+
+  //! @brief Optimized version of norm_modSquareSum() for \c double valued vectors. See norm_Euclidean_real().
+  template<class Iterator>
+  double norm_modSquareSum_real(Iterator begin, Iterator end, const SummationMode mode = SummationMode::Naive);
+
+  //! @brief Optimized version of norm_absSum() for \c double valued vectors. See norm_Euclidean_real().
+  template<class Iterator>
+  double norm_absSum_real(Iterator begin, Iterator end, const SummationMode mode = SummationMode::Naive);
+
+  //! @brief SIMD version of norm_Euclidean_real() for arrays of \c double
+  static inline double norm_Euclidean_real(const double * begin, const double * end, const SummationMode mode = SummationMode::Naive);
+
+  //! @brief SIMD version of norm_Euclidean_real() for arrays of \c float
+  static inline double norm_Euclidean_real(const float  * begin, const float  * end, const SummationMode mode = SummationMode::Naive);
+
+  /**
+   * @brief SIMD version of norm_modSquareSum_real() for arrays of \c double
+   *
+   * The kernel is available for AVX-512, AVX2 with FMA, and generic CPUs. The
+   * fastest version supported by the host is selected at runtime, so the
+   * library need not be compiled with \c -march. The sum is accumulated in
+   * several interleaved partial sums, so the result may differ from a
+   * sequential sum in the last bits.
+   *
+   * With SummationMode::Neumaier, each SIMD lane carries its own compensation
+   * term, which makes the result accurate to about two ulp for any length of
+   * the vector.
+   */
+  double norm_modSquareSum_real(const double * begin, const double * end, const SummationMode mode = SummationMode::Naive);
+
+  /**
+   * @brief SIMD version of norm_modSquareSum_real() for arrays of \c float.
+   *  The sum is accumulated in \c double precision.
+   */
+  double norm_modSquareSum_real(const float  * begin, const float  * end, const SummationMode mode = SummationMode::Naive);
+
+  //! @brief SIMD version of norm_absSum_real() for arrays of \c double. See norm_modSquareSum_real(const double *, const double *).
+  double norm_absSum_real(const double * begin, const double * end, const SummationMode mode = SummationMode::Naive);
+
+  //! @brief SIMD version of norm_absSum_real() for arrays of \c float, accumulated in \c double precision
+  double norm_absSum_real(const float  * begin, const float  * end, const SummationMode mode = SummationMode::Naive);
+
+
+  /**
+   * @brief computes norm_Euclidean() on several threads
+   *
+   * The range is reduced by parallel_reduce(). With the default
+   * ReductionMode::Reproducible, it is split into blocks of
+   * \c BCG::reductionBlockSize elements, which are reduced by norm_Euclidean()
+   * and merged as a binary tree, so the result does not depend on the number
+   * of threads. It may differ from the serial norm_Euclidean() in the last
+   * bits.
+   *
+   * Iterators without random access are reduced on the calling thread.
+   *
+   * @param begin iterator to the first value of the vector
+   * @param end iterator past the last value of the vector
+   * @param mode see ReductionMode
+   * @param threads the number of threads to use. 0 means \c BCG::nThreads.
+   */
+  template<class Iterator>
+  double norm_Euclidean_parallel(Iterator begin, Iterator end, const ReductionMode mode = ReductionMode::Reproducible, unsigned int threads = 0);
 
-  //! @brief Optimized version of norm_Euclidean() for \c double valued vectors
+  //! @brief computes norm_modSquareSum() on several threads. See norm_Euclidean_parallel().
   template<class Iterator>
-  double norm_Euclidean_real(Iterator begin, Iterator end);
+  double norm_modSquareSum_parallel(Iterator begin, Iterator end, const ReductionMode mode = ReductionMode::Reproducible, unsigned int threads = 0);
 
-  //! @brief Optimized version of norm_modSquareSum() for \c double valued vectors
+  //! @brief computes norm_absSum() on several threads. See norm_Euclidean_parallel().
   template<class Iterator>
-  double norm_modSquareSum_real(Iterator begin, Iterator end);
+  double norm_absSum_parallel(Iterator begin, Iterator end, const ReductionMode mode = ReductionMode::Reproducible, unsigned int threads = 0);
 
-  //! @brief Optimized version of norm_absSum() for \c double valued vectors
+  //! @brief computes norm_max() on several threads. As the maximum is exact, the result is always the same as that of norm_max().
   template<class Iterator>
-  double norm_absSum_real(Iterator begin, Iterator end);
+  double norm_max_parallel(Iterator begin, Iterator end, const ReductionMode mode = ReductionMode::Reproducible, unsigned int threads = 0);
+
+  // ------------------------------------------------------------------------ //
+  // norm functors
 
+  /**
+   * @brief the norm @f$\sqrt{\sum_i |x_i|^2}@f$ as functor, for use with
+   *  vector_distance().
+   *
+   * A norm functor describes its norm as a reduction over the elements:
+   * Starting with \c 0.0, each element is folded into an accumulator by
+   * \c accumulate, two accumulators over disjoint ranges are merged by
+   * \c combine, and \c finalize turns the accumulator into the value of the
+   * norm. This allows vector_distance() to compute the norm while it streams
+   * over the elements, without buffering them.
+   *
+   * For convenience, the functor can also be invoked on a range, which is the
+   * same as calling norm_Euclidean().
+   *
+   * Custom norm functors need to provide the same members.
+   */
+  struct NormEuclidean {
+    template<class T>
+    double accumulate(const double acc, const T & x) const;
+    double combine   (const double lhs, const double rhs) const;
+    double finalize  (const double acc) const;
+
+    template<class Iterator>
+    double operator()(Iterator begin, Iterator end) const;
+  };
+
+  //! @brief the norm @f$\sum_i |x_i|^2@f$ as functor. See NormEuclidean for details.
+  struct NormModSquareSum {
+    template<class T>
+    double accumulate(const double acc, const T & x) const;
+    double combine   (const double lhs, const double rhs) const;
+    double finalize  (const double acc) const;
+
+    template<class Iterator>
+    double operator()(Iterator begin, Iterator end) const;
+  };
+
+  //! @brief the norm @f$\sum_i |x_i|@f$ as functor. See NormEuclidean for details.
+  struct NormAbsSum {
+    template<class T>
+    double accumulate(const double acc, const T & x) const;
+    double combine   (const double lhs, const double rhs) const;
+    double finalize  (const double acc) const;
+
+    template<class Iterator>
+    double operator()(Iterator begin, Iterator end) const;
+  };
+
+  //! @brief the norm @f$\max_i |x_i|@f$ as functor. See NormEuclidean for details.
+  struct NormMax {
+    template<class T>
+    double accumulate(const double acc, const T & x) const;
+    double combine   (const double lhs, const double rhs) const;
+    double finalize  (const double acc) const;
+
+    template<class Iterator>
+    double operator()(Iterator begin, Iterator end) const;
+  };
+
+  // ------------------------------------------------------------------------ //
+  // vector distance
 
   /**
-   * @brief computes the Euclidean distance between two STL vectors
+   * @brief computes the distance between two vectors, given by arbitrary STL
+   *  containers
    *
    * @param beginA iterator to the first value of the first vector
-   * @param endA iterator to the last value of the first vector
+   * @param endA iterator past the last value of the first vector
    * @param beginB iterator to the first value of the second vector
-   * @param endB iterator to the last value of the second vector
-   * @param normfunc is a function that computes the norm of the difference
-   *    between \c A and \c B
-   * @param difffunc is a function that computes the difference between two
-   *    elements of \c A and \c B
+   * @param endB iterator past the last value of the second vector
+   * @param norm the norm of the difference between \c A and \c B. Either a
+   *    norm functor such as NormEuclidean, NormAbsSum or NormMax, or any
+   *    callable that takes a range, such as a generic lambda.
+   * @param diff a callable that computes the difference between two elements
+   *    of \c B and \c A
    *
    * The computed value is given by:
    * @f[
-   *  ||B - A|| = \mbox{normfunc}( \{\mbox{difffunc}(B_i - A_i)\}_{i=1..N} )
+   *  ||B - A|| = \mbox{norm}( \{\mbox{diff}(B_i, A_i)\}_{i=1..N} )
    * @f]
    *
-   * @attention in its current form, this function can only be called if \c A
-   *  and B are instances of \c std::vector<T>. Otherwise you'll get an ugly
-   *  errormessage like:<br>
-   @verbatim
-   In instantiation of ‘double BCG::vector_distance(...)
-   error: no match for call to ‘(std::function<double(...)>
-   @endverbatim
-   * See the comments in the \c .tpl for details on why this is, if you want to fix
-   * this -- or simply convert your input to an std::vector...
-   *
-   * @todo fix the normfunc issue
-   */
-  template<typename Iterator>
-  double vector_distance( Iterator beginA, Iterator endA,
-                          Iterator beginB, Iterator endB,
-                          std::function<double(Iterator, Iterator)> normfunc = norm_Euclidean<Iterator>,
-                          std::function<
-                            typename std::iterator_traits<Iterator>::value_type(
-                              typename std::iterator_traits<Iterator>::value_type,
-                              typename std::iterator_traits<Iterator>::value_type
-                            )> difffunc = std::minus<typename std::iterator_traits<Iterator>::value_type>()
-                         );
-
-//   //! @brief stuff
-//   //! @todo include optional norm function, take from findNearby, but use <functional>
+   * \c A and \c B may be given by different iterator types, e.g. a
+   * \c std::vector<double> and a \c std::list<int>.
+   *
+   * If \c norm is a norm functor, the differences are folded into the norm
+   * as they are computed, so no temporary memory is allocated. Any other
+   * \c norm is invoked on a \c std::vector of the differences.
+   *
+   * \b Example:
+   * @code
+   * std::vector<double> a = {1, 2, 3};
+   * std::list  <int>    b = {3, 2, 1};
+   *
+   * BCG::vector_distance(a.begin(), a.end(), b.begin(), b.end());                  // sqrt(8)
+   * BCG::vector_distance(a.begin(), a.end(), b.begin(), b.end(), BCG::NormMax());  // 2
+   * @endcode
+   *
+   * @throws std::invalid_argument if \c A and \c B are not of the same length
+   */
+  template<class IteratorA, class IteratorB, class Norm = NormEuclidean, class Difference = std::minus<>>
+  double vector_distance( IteratorA beginA, IteratorA endA,
+                          IteratorB beginB, IteratorB endB,
+                          Norm norm = Norm(),
+                          Difference diff = Difference()
+                        );
+
+  //! @brief computes the Euclidean distance between two \c std::vector s. See vector_distance(IteratorA, IteratorA, IteratorB, IteratorB, Norm, Difference).
   template<class T>
   double vector_distance(const std::vector<T> & A, const std::vector<T> & B);
 
+  // ------------------------------------------------------------------------ //
+  // pairwise distances
+
+  /**
+   * @brief computes the distances between all points of two point sets, like
+   *  SciPy's \c cdist
+   *
+   * The point sets are given as row major arrays, i.e. point \c i of \c A
+   * occupies <tt>A[i * dim] ... A[i * dim + dim - 1]</tt>. The result is
+   * written to the row major @f$n_A \times n_B@f$ array \c result, where
+   * <tt>result[i * nB + j]</tt> is <tt>norm(B_j - A_i)</tt>.
+   *
+   * \c B is rearranged once into panels of a few hundred points, stored
+   * coordinate by coordinate, such that the innermost loop runs over
+   * consecutive points of \c B and can be vectorized by the compiler. The
+   * rows of \c A are processed in blocks of 32 points that are distributed
+   * over \c threads threads by parallel_for().
+   *
+   * For NormEuclidean and NormModSquareSum, the squared distance is computed
+   * as @f$|a|^2 + |b|^2 - 2 a \cdot b@f$ from the precomputed squared norms of
+   * all points, which reduces the inner loop to a dot product. Cancellation
+   * makes this less accurate than the direct difference for points that are
+   * close compared to their norms; negative results are clamped to zero.
+   * Other norm functors are evaluated directly on the differences.
+   *
+   * The full matrix needs @f$8 n_A n_B@f$ bytes, i.e. 80 GB for
+   * @f$10^5 \times 10^5@f$ points. Such problems have to be processed in
+   * chunks of rows of \c A, by calling this function with
+   * <tt>A + firstRow * dim</tt> and the number of rows in the chunk.
+   *
+   * @param A the first point set, \c nA points of dimension \c dim
+   * @param nA the number of points in \c A
+   * @param B the second point set, \c nB points of dimension \c dim
+   * @param nB the number of points in \c B
+   * @param dim the dimension of the points
+   * @param result memory for at least <tt>nA * nB</tt> values
+   * @param norm a norm functor such as NormEuclidean, NormAbsSum or NormMax.
+   *  See NormEuclidean for the members required of custom norm functors.
+   * @param threads the number of threads to use. 0 means \c BCG::nThreads.
+   */
+  template<class Norm = NormEuclidean>
+  void pairwise_distance( const double * A, const size_t nA,
+                          const double * B, const size_t nB,
+                          const size_t dim,
+                          double * result,
+                          Norm norm = Norm(),
+                          unsigned int threads = 0
+                        );
+
+  /**
+   * @brief computes the distances between all points of two point sets, given
+   *  as vectors of points. The result is a row major @f$n_A \times n_B@f$
+   *  matrix.
+   *
+   * See pairwise_distance(const double *, const size_t, const double *, const size_t, const size_t, double *, Norm, unsigned int)
+   * for details.
+   *
+   * @throws std::invalid_argument if the points are not all of the same
+   *  dimension
+   */
+  template<class Norm = NormEuclidean>
+  std::vector<double> pairwise_distance(const std::vector<std::vector<double>> & A,
+                                        const std::vector<std::vector<double>> & B,
+                                        Norm norm = Norm(),
+                                        unsigned int threads = 0
+                                       );
+
+  /**
+   * @brief copies a vector of points of dimension \c dim into one row major
+   *  array, as taken by pairwise_distance() and KDTree
+   *
+   * @throws std::invalid_argument if a point is not of dimension \c dim
+   */
+  std::vector<double> flatten_points(const std::vector<std::vector<double>> & points, const size_t dim);
+
+  // ------------------------------------------------------------------------ //
+  // k-d tree
+
+  //! @brief a point found by KDTree::findNearest()
+  struct Neighbour {
+    size_t index;                                                               //!< the index of the point in the point set the tree was built from
+    double distance;                                                            //!< the distance of the point from the query
+  };
+
+  /**
+   * @brief a k-d tree over a set of points, for fast neighbour queries
+   *
+   * The points are given in the same row major layout as for
+   * pairwise_distance(). The tree recursively splits them at the median of
+   * the coordinate with the largest extent, until at most \c leafSize points
+   * remain. Each node stores the bounding box of its points and the smallest
+   * index among them. A query descends into a node only if the norm of the
+   * distance between query and bounding box can beat the current result, so
+   * for low dimensional point sets only a few leaves are visited per query.
+   * The points are copied into the tree in leaf order; the tree does not
+   * keep the original array alive.
+   *
+   * Distances are computed by the norm functor \c Norm on the differences
+   * <tt>point - query</tt>, like vector_distance(). Its accumulator must not
+   * decrease if the magnitude of any difference increases, which holds for
+   * NormEuclidean, NormModSquareSum, NormAbsSum and NormMax.
+   *
+   * All queries are \c const and may be run concurrently. The batch versions
+   * distribute blocks of queries over \c threads threads with parallel_for().
+   *
+   * \b Example:
+   * @code
+   * std::vector<std::vector<double>> cloud = ...;
+   *
+   * BCG::KDTree tree(cloud);
+   * const auto first    = tree.findNearbyIdx(cloud[0], 0.01);
+   * const auto nearest  = tree.findNearest(cloud[0], 5);
+   * const auto firstAll = tree.findNearbyIdx(cloud, 0.01);
+   * @endcode
+   */
+  template<class Norm = NormEuclidean>
+  class KDTree {
+    public:
+      //! @brief creates an empty tree
+      KDTree() = default;
+
+      /**
+       * @brief builds the tree over \c N points of dimension \c dim, stored
+       *  row major at \c points
+       *
+       * @throws std::invalid_argument if \c leafSize is 0
+       */
+      KDTree(const double * points, const size_t N, const size_t dim, Norm norm = Norm(), const size_t leafSize = 16);
+
+      /**
+       * @brief builds the tree over a vector of points
+       *
+       * @throws std::invalid_argument if the points are not all of the same
+       *  dimension or \c leafSize is 0
+       */
+      explicit KDTree(const std::vector<std::vector<double>> & points, Norm norm = Norm(), const size_t leafSize = 16);
+
+      //! @brief the number of points
+      size_t size() const;
+      //! @brief the dimension of the points
+      size_t dim() const;
+
+      /**
+       * @brief returns the index of the first point that is closer to
+       *  \c query than \c epsilon, or -1 if there is none
+       *
+       * The result is the same as that of a linear scan in the style of
+       * findNearbyIdx(), i.e. the smallest index \c i for which
+       * <tt>norm(point_i - query) < epsilon</tt>.
+       */
+      ptrdiff_t findNearbyIdx(const double * query, const double epsilon) const;
+
+      /**
+       * @brief returns the index of the first point that is closer to
+       *  \c query than \c epsilon, or -1 if there is none
+       *
+       * @throws std::invalid_argument if \c query is not of dimension dim()
+       */
+      ptrdiff_t findNearbyIdx(const std::vector<double> & query, const double epsilon) const;
+
+      //! @brief findNearbyIdx() for \c nQueries row major queries, in parallel
+      std::vector<ptrdiff_t> findNearbyIdx(const double * queries, const size_t nQueries, const double epsilon, unsigned int threads = 0) const;
+
+      /**
+       * @brief findNearbyIdx() for a vector of queries, in parallel
+       *
+       * @throws std::invalid_argument if a query is not of dimension dim()
+       */
+      std::vector<ptrdiff_t> findNearbyIdx(const std::vector<std::vector<double>> & queries, const double epsilon, unsigned int threads = 0) const;
+
+      //! @brief returns the indices of all points closer to \c query than \c epsilon, in ascending order
+      std::vector<size_t> findAllNearbyIdx(const double * query, const double epsilon) const;
+
+      /**
+       * @brief returns the indices of all points closer to \c query than
+       *  \c epsilon, in ascending order
+       *
+       * @throws std::invalid_argument if \c query is not of dimension dim()
+       */
+      std::vector<size_t> findAllNearbyIdx(const std::vector<double> & query, const double epsilon) const;
+
+      /**
+       * @brief returns the \c k points closest to \c query, ordered by
+       *  distance
+       *
+       * Points at the same distance are ordered by index. Fewer than \c k
+       * points are returned only if the tree holds fewer points.
+       */
+      std::vector<Neighbour> findNearest(const double * query, const size_t k) const;
+
+      /**
+       * @brief returns the \c k points closest to \c query, ordered by
+       *  distance
+       *
+       * @throws std::invalid_argument if \c query is not of dimension dim()
+       */
+      std::vector<Neighbour> findNearest(const std::vector<double> & query, const size_t k) const;
+
+      //! @brief findNearest() for \c nQueries row major queries, in parallel
+      std::vector<std::vector<Neighbour>> findNearest(const double * queries, const size_t nQueries, const size_t k, unsigned int threads = 0) const;
+
+      /**
+       * @brief findNearest() for a vector of queries, in parallel
+       *
+       * @throws std::invalid_argument if a query is not of dimension dim()
+       */
+      std::vector<std::vector<Neighbour>> findNearest(const std::vector<std::vector<double>> & queries, const size_t k, unsigned int threads = 0) const;
+
+    private:
+      struct Node {
+        size_t begin;                                                           // range of points in leaf order
+        size_t end;
+        size_t minIndex;                                                        // smallest original index in the range
+        size_t right;                                                           // the left child is the next node; 0 for leaves
+      };
+
+      size_t              nPoints    = 0;
+      size_t              dimension  = 0;
+      Norm                norm;
+      std::vector<double> coordinates;                                          // points in leaf order, row major
+      std::vector<size_t> indices;                                              // original index of each point in leaf order
+      std::vector<Node>   nodes;                                                // pre-order, root first
+      std::vector<double> boxes;                                                // per node: dim lower, then dim upper bounds
+
+      size_t build(const double * points, const size_t begin, const size_t end, const size_t leafSize);
+
+      double distance   (const size_t position, const double * query) const;
+      double boxDistance(const size_t node,     const double * query) const;
+
+      void searchFirst  (const size_t node, const double * query, const double epsilon, size_t & best) const;
+      void searchAll    (const size_t node, const double * query, const double epsilon, std::vector<size_t> & found) const;
+      void searchNearest(const size_t node, const double * query, const size_t k, std::vector<Neighbour> & heap) const;
+
+      void checkQuery(const std::vector<double> & query) const;
+  };
+
   // ------------------------------------------------------------------------ //
   // misc
 
@@ -205,26 +657,289 @@ namespace BCG {
   template <typename T>
   constexpr static inline int sgn(T val);
 
+  // ------------------------------------------------------------------------ //
+  // split complex vectors
+
+  /**
+   * @brief a vector of complex numbers, stored as separate arrays of real
+   *  and imaginary parts (structure of arrays)
+   *
+   * In a \c std::vector<complex_d_t>, real and imaginary parts alternate in
+   * memory, so a SIMD register holds a mix of both and each complex product
+   * needs shuffles. In a ComplexVector, a SIMD register holds either four or
+   * eight real parts or as many imaginary parts, and the complex arithmetic
+   * maps onto plain vector multiplies and adds. The functions
+   * norm_modSquareSum(const ComplexVector &, const SummationMode),
+   * dot(), vdot(), axpy() and multiply() make use of this with the same
+   * runtime dispatched kernels as norm_modSquareSum_real().
+   *
+   * The gain depends on where the data live. While the vectors fit into the
+   * cache, all of these functions are several times faster than the
+   * corresponding loops over \c std::vector<complex_d_t>. Vectors that only
+   * fit into main memory still profit in the reductions. The elementwise
+   * axpy() and multiply(), however, are then limited by the memory bandwidth,
+   * move the same number of bytes in either layout and are not reliably
+   * faster than the interleaved loops; multiply() may even be somewhat slower,
+   * as it reads and writes six arrays instead of three.
+   *
+   * \b Example:
+   * @code
+   * std::vector<BCG::complex_d_t> psi = ...;
+   *
+   * BCG::ComplexVector x(psi.begin(), psi.end());
+   * const double norm = BCG::norm_Euclidean(x);
+   * const auto   overlap = BCG::vdot(x, x);
+   *
+   * psi = x.to_interleaved();
+   * @endcode
+   */
+  class ComplexVector {
+    public:
+      //! @brief creates an empty vector
+      ComplexVector() = default;
+
+      //! @brief creates a vector of \c N zeros
+      explicit ComplexVector(const size_t N);
+
+      //! @brief converts from interleaved storage
+      ComplexVector(const std::vector<complex_d_t> & interleaved);
+
+      //! @brief converts the range <tt>[begin, end)</tt> of complex (or real) values
+      template<class Iterator>
+      ComplexVector(Iterator begin, Iterator end);
+
+      //! @brief converts to interleaved storage
+      std::vector<complex_d_t> to_interleaved() const;
+
+      //! @brief the number of elements
+      size_t size() const;
+
+      //! @brief resizes to \c N elements, new elements are zero
+      void resize(const size_t N);
+
+      //! @brief returns element \c i, without bounds check
+      complex_d_t operator[](const size_t i) const;
+
+      //! @brief sets element \c i to \c z, without bounds check
+      void set(const size_t i, const complex_d_t z);
+
+      //! @brief the array of real parts
+      double       * real();
+      //! @brief the array of real parts
+      const double * real() const;
+      //! @brief the array of imaginary parts
+      double       * imag();
+      //! @brief the array of imaginary parts
+      const double * imag() const;
+
+    private:
+      std::vector<double> re;
+      std::vector<double> im;
+  };
+
+  /**
+   * @brief computes @f$\sum_i |x_i|^2@f$, as the sum of the real norms of the
+   *  real and imaginary parts
+   */
+  double norm_modSquareSum(const ComplexVector & x, const SummationMode mode = SummationMode::Naive);
+
+  //! @brief computes @f$\sqrt{\sum_i |x_i|^2}@f$
+  double norm_Euclidean(const ComplexVector & x, const SummationMode mode = SummationMode::Naive);
+
+  /**
+   * @brief computes @f$\sum_i x_i y_i@f$, i.e. without complex conjugation
+   *
+   * @throws std::invalid_argument if \c x and \c y differ in size
+   */
+  complex_d_t dot(const ComplexVector & x, const ComplexVector & y);
+
+  /**
+   * @brief computes @f$\sum_i x_i^* y_i@f$, i.e. the scalar product of \c x
+   *  and \c y with \c x conjugated
+   *
+   * @throws std::invalid_argument if \c x and \c y differ in size
+   */
+  complex_d_t vdot(const ComplexVector & x, const ComplexVector & y);
+
+  /**
+   * @brief computes @f$y \leftarrow a x + y@f$ in place
+   *
+   * @throws std::invalid_argument if \c x and \c y differ in size
+   */
+  void axpy(const complex_d_t a, const ComplexVector & x, ComplexVector & y);
+
+  /**
+   * @brief computes the elementwise product @f$z_i = x_i y_i@f$
+   *
+   * \c z is resized to the size of \c x and may be the same object as \c x
+   * or \c y. Reusing \c z over several calls avoids allocating a new vector
+   * each time.
+   *
+   * @throws std::invalid_argument if \c x and \c y differ in size
+   */
+  void multiply(const ComplexVector & x, const ComplexVector & y, ComplexVector & z);
+
+  /**
+   * @brief computes the elementwise product @f$x_i y_i@f$
+   *
+   * @throws std::invalid_argument if \c x and \c y differ in size
+   */
+  ComplexVector multiply(const ComplexVector & x, const ComplexVector & y);
+
+  // ------------------------------------------------------------------------ //
+  // combinatorics
+
+  //! @brief @f$n!@f$ for @f$n = 0 \ldots 20@f$, i.e. all factorials representable as <tt>unsigned long long</tt>
+  constexpr std::array<unsigned long long, 21> factorialTable = [] () {
+    std::array<unsigned long long, 21> reVal {1};
+    for (size_t n = 1; n < reVal.size(); ++n) {reVal[n] = reVal[n - 1] * n;}
+    return reVal;
+  }();
+
+  /**
+   * @brief @f$n!@f$ for @f$n = 0 \ldots 170@f$, i.e. all factorials below the
+   *  largest \c double. Exact up to @f$n = 22@f$.
+   */
+  constexpr std::array<double, 171> factorialTable_double = [] () {
+    std::array<double, 171> reVal {1.0};
+    for (size_t n = 1; n < reVal.size(); ++n) {reVal[n] = reVal[n - 1] * n;}
+    return reVal;
+  }();
+
+  //! @brief the largest @f$n@f$ for which binomialTable holds all @f$\binom{n}{k}@f$. @f$\binom{68}{34}@f$ exceeds 64 bits.
+  constexpr unsigned int binomialTableMaxN = 67;
+
+  /**
+   * @brief Pascal's triangle up to row binomialTableMaxN, stored row by row:
+   *  @f$\binom{n}{k}@f$ is at index @f$n (n + 1) / 2 + k@f$. Use binomial()
+   *  to access it.
+   */
+  constexpr std::array<unsigned long long, (binomialTableMaxN + 1) * (binomialTableMaxN + 2) / 2> binomialTable = [] () {
+    std::array<unsigned long long, (binomialTableMaxN + 1) * (binomialTableMaxN + 2) / 2> reVal {};
+    for (size_t n = 0; n <= binomialTableMaxN; ++n) {
+      const size_t row = n * (n + 1) / 2, above = (n - 1) * n / 2;
+      reVal[row] = reVal[row + n] = 1;
+      for (size_t k = 1; k < n; ++k) {reVal[row + k] = reVal[above + k - 1] + reVal[above + k];}
+    }
+    return reVal;
+  }();
+
   /**
-   * @brief computes the factorial of an integer n.
+   * @brief computes the factorial of n.
+   *
+   * For integral types, @f$n!@f$ is looked up in factorialTable. If it is
+   * not representable in \c T, e.g. @f$n > 20@f$ for <tt>unsigned long
+   * long</tt> or @f$n > 12@f$ for \c int, \c std::overflow_error is thrown.
+   *
+   * For \c double and \c float and integral values of \c n, @f$n!@f$ is
+   * looked up in factorialTable_double. Beyond @f$n = 170@f$ (resp. 34 for
+   * \c float), the result is \c inf.
    *
-   * @attention This is a template implementation that works with arbibrary
-   *  types T. If the argument n is non-integral, this will go into an infinite
-   *  loop
+   * All other types, such as <tt>long double</tt>, GMP types or non-integral
+   * values of n, fall back to multiplying @f$2 \cdot 3 \cdots n@f$. <tt>long
+   * double</tt> yields good results up to n = 25. GMP classes have their
+   * proper methods for this.
    *
-   * * type unsigned <tt>long long int</tt> yields correct results up to n = 20
-   *    and then goes into overload (returns zero)
-   * * type \c double yields good results up to n = 22
-   *    reaches computation limit after n = 170 and will yield <tt>nan:inf</tt>
-   *    beyond (nothrow)
-   * * type <tt>long double</tt> yields good results up to n = 25
-   * * use at own risk with non-integral types, rounding errors will accumulate
+   * As the function is \c constexpr, an out of range argument is a compile
+   * time error when the result is needed at compile time:
+   * @code
+   * constexpr auto a = BCG::factorial(20ull);   // fine
+   * constexpr auto b = BCG::factorial(21ull);   // does not compile
+   * @endcode
    *
-   * Can be used with GMP types and works just fine. However, GMP classes have
-   * their proper methods for this.
+   * @throws std::invalid_argument if n is negative
+   * @throws std::overflow_error if T is integral and @f$n!@f$ is not
+   *  representable in T
    */
   template <typename T>
-  static inline T factorial (T n);
+  constexpr static inline T factorial (T n);
+
+  /**
+   * @brief computes the binomial coefficient @f$\binom{n}{k}@f$ exactly
+   *
+   * For @f$n \leq@f$ binomialTableMaxN, this is a lookup in binomialTable.
+   * Beyond, the coefficient is computed in @f$\min(k, n - k)@f$ steps
+   * without intermediate overflow. Like factorial(), this can be evaluated
+   * at compile time.
+   *
+   * @return @f$\binom{n}{k}@f$, which is 0 for @f$k > n@f$
+   *
+   * @throws std::overflow_error if the result exceeds 64 bits
+   */
+  constexpr static inline unsigned long long binomial(const unsigned int n, const unsigned int k);
+
+  /**
+   * @brief computes @f$\ln n!@f$
+   *
+   * Values for @f$n < 1024@f$ are taken from a table that is filled via
+   * \c std::lgamma when the library is loaded. Larger values are computed by
+   * \c std::lgamma on each call.
+   */
+  double logFactorial(const unsigned long long n);
+
+  /**
+   * @brief computes the multinomial coefficient
+   *  @f$\binom{k_1 + \ldots + k_m}{k_1, \ldots, k_m} = \frac{(k_1 + \ldots + k_m)!}{k_1! \cdots k_m!}@f$
+   *  exactly
+   *
+   * The coefficient is built as the product of the binomials
+   * @f$\binom{k_1 + \ldots + k_i}{k_i}@f$, so no factorial is ever formed and
+   * the result is available as long as it fits into 64 bits, e.g.
+   * @f$\binom{42}{14, 14, 14}@f$, although @f$42!@f$ is far beyond. Can be
+   * evaluated at compile time.
+   *
+   * \b Example:
+   * @code
+   * std::vector<unsigned int> k = {2, 3, 5};
+   * BCG::multinomial(k.begin(), k.end());   // 2520
+   * BCG::multinomial({2, 3, 5});            // the same
+   * @endcode
+   *
+   * @param begin iterator to the first of the counts @f$k_i@f$
+   * @param end iterator past the last of the counts @f$k_i@f$
+   *
+   * @throws std::overflow_error if the result exceeds 64 bits
+   */
+  template<class Iterator>
+  constexpr unsigned long long multinomial(Iterator begin, Iterator end);
+
+  //! @brief computes the multinomial coefficient for the counts \c k. See multinomial(Iterator, Iterator).
+  constexpr static inline unsigned long long multinomial(const std::initializer_list<unsigned int> k);
+
+  /**
+   * @brief computes the natural logarithm of the multinomial coefficient
+   *  @f$\binom{k_1 + \ldots + k_m}{k_1, \ldots, k_m}@f$
+   *
+   * This is @f$\ln n! - \sum_i \ln k_i!@f$ with @f$n = \sum_i k_i@f$,
+   * evaluated with logFactorial(), i.e. mostly by table lookups. It never
+   * overflows, but is only accurate to about @f$10^{-15} \ln n!@f$ in
+   * absolute terms.
+   */
+  template<class Iterator>
+  double logMultinomial(Iterator begin, Iterator end);
+
+  //! @brief computes the logarithm of the multinomial coefficient for the counts \c k. See logMultinomial(Iterator, Iterator).
+  static inline double logMultinomial(const std::initializer_list<unsigned int> k);
+
+  /**
+   * @brief computes the multinomial coefficients of \c nVectors count
+   *  vectors of length \c m at once
+   *
+   * The counts are given as row major array, i.e. vector \c i occupies
+   * <tt>k[i * m] ... k[i * m + m - 1]</tt>, and its coefficient is written to
+   * <tt>result[i]</tt>.
+   *
+   * @throws std::overflow_error if any of the coefficients exceeds 64 bits.
+   *  The contents of \c result are unspecified in that case.
+   */
+  void multinomial(const unsigned int * k, const size_t nVectors, const size_t m, unsigned long long * result);
+
+  /**
+   * @brief computes the logarithms of the multinomial coefficients of
+   *  \c nVectors count vectors of length \c m at once. The layout is the same
+   *  as for multinomial(const unsigned int *, const size_t, const size_t, unsigned long long *).
+   */
+  void logMultinomial(const unsigned int * k, const size_t nVectors, const size_t m, double * result);
 
   //! @}
 }
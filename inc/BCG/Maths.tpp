@@ -19,133 +19,722 @@ static inline const std::string BCG::complex_to_string(const std::complex<T> & z
 // -------------------------------------------------------------------------- //
 // vector norm and distance
 
+template<class Iterator, class Term>
+double BCG::summation(Iterator begin, Iterator end, Term term, const SummationMode mode) {
+  switch (mode) {
+    case SummationMode::Pairwise : {
+      // naive sums of blocks, merged like a binary counter, i.e. as a
+      // balanced binary tree with at most one partial sum per level
+      constexpr size_t blockSize = 1024;
+
+      double partials[64];
+      size_t height  = 0;
+      size_t nBlocks = 0;
+
+      while (begin != end) {
+        double block = 0.0;
+        for (size_t i = 0; i < blockSize && begin != end; ++i, ++begin) {block += term(*begin);}
+
+        ++nBlocks;
+        for (size_t n = nBlocks; (n & 1) == 0; n >>= 1) {block = partials[--height] + block;}
+        partials[height++] = block;
+      }
+
+      double reVal = 0.0;
+      while (height) {reVal = partials[--height] + reVal;}
+      return reVal;
+    }
+
+    case SummationMode::Neumaier : {
+      double sum = 0.0, compensation = 0.0;
+      for (; begin != end; ++begin) {
+        const double x = term(*begin);
+        const double t = sum + x;
+        if (std::abs(sum) >= std::abs(x)) {compensation += (sum - t) + x;}
+        else                              {compensation += (x - t) + sum;}
+        sum = t;
+      }
+      return sum + compensation;
+    }
+
+    default :
+      return std::transform_reduce(begin, end, 0.0, std::plus<>(), term);
+  }
+}
+// .......................................................................... //
 template<class Iterator>
-double BCG::norm_Euclidean(Iterator begin, Iterator end) {return std::sqrt(BCG::norm_modSquareSum(begin, end));}
+double BCG::norm_Euclidean(Iterator begin, Iterator end, const SummationMode mode) {return std::sqrt(BCG::norm_modSquareSum(begin, end, mode));}
 // .......................................................................... //
 template<class Iterator>
-double BCG::norm_modSquareSum(Iterator begin, Iterator end) {
-  return std::transform_reduce( begin, end,
-                                begin,
-                                0.0,
-                                std::plus<double>(),
-                                [] (
-                                  const BCG::complex_d_t lhs,
-                                  const BCG::complex_d_t rhs
-                                ) {return std::real(lhs * std::conj(rhs));}
-  );
+double BCG::norm_modSquareSum(Iterator begin, Iterator end, const SummationMode mode) {
+  typedef typename std::iterator_traits<Iterator>::value_type T;
+
+  if constexpr (is_complex_v<T>) {
+    return BCG::summation(begin, end, [] (const T & z) {return static_cast<double>(std::norm(z));}, mode);
+  }
+  else if constexpr (std::is_floating_point_v<T>) {
+    return BCG::norm_modSquareSum_real(begin, end, mode);
+  }
+  else {
+    return BCG::summation(begin, end, [] (const T & x) {const double d = static_cast<double>(x); return d * d;}, mode);
+  }
 }
 // .......................................................................... //
 template<class Iterator>
-double BCG::norm_absSum(Iterator begin, Iterator end) {
-  return std::transform_reduce(begin, end,
-                               0.0,
-                               std::plus<>(),
-                               std::abs<double>
-                              );
+double BCG::norm_absSum(Iterator begin, Iterator end, const SummationMode mode) {
+  typedef typename std::iterator_traits<Iterator>::value_type T;
+
+  if constexpr (is_complex_v<T>) {
+    return BCG::summation(begin, end, [] (const T & z) {return static_cast<double>(std::abs(z));}, mode);
+  }
+  else if constexpr (std::is_floating_point_v<T>) {
+    return BCG::norm_absSum_real(begin, end, mode);
+  }
+  else {
+    return BCG::summation(begin, end, [] (const T & x) {return std::abs(static_cast<double>(x));}, mode);
+  }
 }
 // .......................................................................... //
 template<class Iterator>
 double BCG::norm_max(Iterator begin, Iterator end) {
+  typedef typename std::iterator_traits<Iterator>::value_type T;
+
+  auto absolute = [] (const T & x) {
+    if constexpr (is_complex_v<T>) {return static_cast<double>(std::abs(x));}
+    else                           {return std::abs(static_cast<double>(x));}
+  };
+
   return std::transform_reduce(begin, end,
                                0.0,
-                               [] (const double & acc, const double & elm) {return std::max(acc, elm);},
-                               std::abs<double>
+                               [] (const double lhs, const double rhs) {return std::max(lhs, rhs);},
+                               absolute
                               );
 }
+// .......................................................................... //
+template<std::ranges::range Range>
+double BCG::norm_Euclidean(const Range & x, const SummationMode mode) {return BCG::norm_Euclidean(std::ranges::begin(x), std::ranges::end(x), mode);}
+
+template<std::ranges::range Range>
+double BCG::norm_modSquareSum(const Range & x, const SummationMode mode) {return BCG::norm_modSquareSum(std::ranges::begin(x), std::ranges::end(x), mode);}
+
+template<std::ranges::range Range>
+double BCG::norm_absSum(const Range & x, const SummationMode mode) {return BCG::norm_absSum(std::ranges::begin(x), std::ranges::end(x), mode);}
+
+template<std::ranges::range Range>
+double BCG::norm_max(const Range & x) {return BCG::norm_max(std::ranges::begin(x), std::ranges::end(x));}
 // -------------------------------------------------------------------------- //
 
 template<class Iterator>
-double BCG::norm_Euclidean_real(Iterator begin, Iterator end) {return std::sqrt(BCG::norm_modSquareSum_real(begin, end));}
+double BCG::norm_Euclidean_real(Iterator begin, Iterator end, const SummationMode mode) {return std::sqrt(BCG::norm_modSquareSum_real(begin, end, mode));}
 // .......................................................................... //
 template<class Iterator>
-double BCG::norm_modSquareSum_real(Iterator begin, Iterator end) {
-  return std::transform_reduce( begin, end,
-                                begin,
-                                0.0
-  );
+double BCG::norm_modSquareSum_real(Iterator begin, Iterator end, const SummationMode mode) {
+  typedef std::remove_cv_t<typename std::iterator_traits<Iterator>::value_type> T;
+
+  if constexpr (std::contiguous_iterator<Iterator> && (std::is_same_v<T, double> || std::is_same_v<T, float>)) {
+    const T * first = std::to_address(begin);
+    return BCG::norm_modSquareSum_real(first, first + (end - begin), mode);
+  }
+  else {
+    // computed values, e.g. of a lazy vector expression, in chunks through the SIMD kernel
+    if constexpr (std::random_access_iterator<Iterator>) {
+      if (mode == SummationMode::Naive) {
+        double reVal = 0.0;
+        double buffer[lazyChunkSize];
+        while (begin != end) {
+          const size_t n = std::min<size_t>(lazyChunkSize, end - begin);
+          for (size_t i = 0; i < n; ++i, ++begin) {buffer[i] = *begin;}
+          reVal += BCG::norm_modSquareSum_real(buffer, buffer + n);
+        }
+        return reVal;
+      }
+    }
+
+    if (mode == SummationMode::Naive) {
+      return std::transform_reduce( begin, end,
+                                    begin,
+                                    0.0
+      );
+    }
+    return BCG::summation(begin, end, [] (const double x) {return x * x;}, mode);
+  }
 }
 // .......................................................................... //
 template<class Iterator>
-double BCG::norm_absSum_real(Iterator begin, Iterator end) {
-  return std::transform_reduce(begin, end,
-                               0.0,
-                               std::plus<>(),
-                               static_cast<double (*)(double)>(std::abs)
-                              );
+double BCG::norm_absSum_real(Iterator begin, Iterator end, const SummationMode mode) {
+  typedef std::remove_cv_t<typename std::iterator_traits<Iterator>::value_type> T;
+
+  if constexpr (std::contiguous_iterator<Iterator> && (std::is_same_v<T, double> || std::is_same_v<T, float>)) {
+    const T * first = std::to_address(begin);
+    return BCG::norm_absSum_real(first, first + (end - begin), mode);
+  }
+  else {
+    if constexpr (std::random_access_iterator<Iterator>) {
+      if (mode == SummationMode::Naive) {
+        double reVal = 0.0;
+        double buffer[lazyChunkSize];
+        while (begin != end) {
+          const size_t n = std::min<size_t>(lazyChunkSize, end - begin);
+          for (size_t i = 0; i < n; ++i, ++begin) {buffer[i] = *begin;}
+          reVal += BCG::norm_absSum_real(buffer, buffer + n);
+        }
+        return reVal;
+      }
+    }
+
+    return BCG::summation(begin, end, static_cast<double (*)(double)>(std::abs), mode);
+  }
 }
+// .......................................................................... //
+static inline double BCG::norm_Euclidean_real(const double * begin, const double * end, const SummationMode mode) {return std::sqrt(BCG::norm_modSquareSum_real(begin, end, mode));}
+static inline double BCG::norm_Euclidean_real(const float  * begin, const float  * end, const SummationMode mode) {return std::sqrt(BCG::norm_modSquareSum_real(begin, end, mode));}
 // -------------------------------------------------------------------------- //
-template<typename Iterator>
-double BCG::vector_distance(Iterator beginA, Iterator endA,
-                            Iterator beginB, Iterator endB,
-                            std::function<double(Iterator, Iterator)> normfunc,
-                            std::function<
-                              typename std::iterator_traits<Iterator>::value_type(
-                                typename std::iterator_traits<Iterator>::value_type,
-                                typename std::iterator_traits<Iterator>::value_type
-                              )> difffunc
+template<class Iterator>
+double BCG::norm_Euclidean_parallel(Iterator begin, Iterator end, const ReductionMode mode, unsigned int threads) {
+  return std::sqrt(BCG::norm_modSquareSum_parallel(begin, end, mode, threads));
+}
+// .......................................................................... //
+template<class Iterator>
+double BCG::norm_modSquareSum_parallel(Iterator begin, Iterator end, const ReductionMode mode, unsigned int threads) {
+  if constexpr (std::random_access_iterator<Iterator>) {
+    return parallel_reduce(end - begin, 0.0,
+                           [begin] (const size_t first, const size_t last) {return BCG::norm_modSquareSum(begin + first, begin + last);},
+                           std::plus<>(),
+                           mode, threads
+                          );
+  }
+  else {return BCG::norm_modSquareSum(begin, end);}
+}
+// .......................................................................... //
+template<class Iterator>
+double BCG::norm_absSum_parallel(Iterator begin, Iterator end, const ReductionMode mode, unsigned int threads) {
+  if constexpr (std::random_access_iterator<Iterator>) {
+    return parallel_reduce(end - begin, 0.0,
+                           [begin] (const size_t first, const size_t last) {return BCG::norm_absSum(begin + first, begin + last);},
+                           std::plus<>(),
+                           mode, threads
+                          );
+  }
+  else {return BCG::norm_absSum(begin, end);}
+}
+// .......................................................................... //
+template<class Iterator>
+double BCG::norm_max_parallel(Iterator begin, Iterator end, const ReductionMode mode, unsigned int threads) {
+  if constexpr (std::random_access_iterator<Iterator>) {
+    return parallel_reduce(end - begin, 0.0,
+                           [begin] (const size_t first, const size_t last) {return BCG::norm_max(begin + first, begin + last);},
+                           [] (const double lhs, const double rhs) {return std::max(lhs, rhs);},
+                           mode, threads
+                          );
+  }
+  else {return BCG::norm_max(begin, end);}
+}
+
+// -------------------------------------------------------------------------- //
+// norm functors
+
+template<class T>
+double BCG::NormModSquareSum::accumulate(const double acc, const T & x) const {
+  if constexpr (is_complex_v<T>) {return acc + static_cast<double>(std::norm(x));}
+  else                           {const double d = static_cast<double>(x); return acc + d * d;}
+}
+inline double BCG::NormModSquareSum::combine (const double lhs, const double rhs) const {return lhs + rhs;}
+inline double BCG::NormModSquareSum::finalize(const double acc) const {return acc;}
+template<class Iterator>
+double BCG::NormModSquareSum::operator()(Iterator begin, Iterator end) const {return BCG::norm_modSquareSum(begin, end);}
+// .......................................................................... //
+template<class T>
+double BCG::NormEuclidean::accumulate(const double acc, const T & x) const {return NormModSquareSum().accumulate(acc, x);}
+inline double BCG::NormEuclidean::combine (const double lhs, const double rhs) const {return lhs + rhs;}
+inline double BCG::NormEuclidean::finalize(const double acc) const {return std::sqrt(acc);}
+template<class Iterator>
+double BCG::NormEuclidean::operator()(Iterator begin, Iterator end) const {return BCG::norm_Euclidean(begin, end);}
+// .......................................................................... //
+template<class T>
+double BCG::NormAbsSum::accumulate(const double acc, const T & x) const {
+  if constexpr (is_complex_v<T>) {return acc + static_cast<double>(std::abs(x));}
+  else                           {return acc + std::abs(static_cast<double>(x));}
+}
+inline double BCG::NormAbsSum::combine (const double lhs, const double rhs) const {return lhs + rhs;}
+inline double BCG::NormAbsSum::finalize(const double acc) const {return acc;}
+template<class Iterator>
+double BCG::NormAbsSum::operator()(Iterator begin, Iterator end) const {return BCG::norm_absSum(begin, end);}
+// .......................................................................... //
+template<class T>
+double BCG::NormMax::accumulate(const double acc, const T & x) const {
+  if constexpr (is_complex_v<T>) {return std::max(acc, static_cast<double>(std::abs(x)));}
+  else                           {return std::max(acc, std::abs(static_cast<double>(x)));}
+}
+inline double BCG::NormMax::combine (const double lhs, const double rhs) const {return std::max(lhs, rhs);}
+inline double BCG::NormMax::finalize(const double acc) const {return acc;}
+template<class Iterator>
+double BCG::NormMax::operator()(Iterator begin, Iterator end) const {return BCG::norm_max(begin, end);}
+
+// -------------------------------------------------------------------------- //
+// vector distance
+
+template<class IteratorA, class IteratorB, class Norm, class Difference>
+double BCG::vector_distance(IteratorA beginA, IteratorA endA,
+                            IteratorB beginB, IteratorB endB,
+                            Norm norm,
+                            Difference diff
+) {
+  constexpr bool randomAccess = std::random_access_iterator<IteratorA> && std::random_access_iterator<IteratorB>;
+
+  if constexpr (randomAccess) {
+    if (std::distance(beginA, endA) != std::distance(beginB, endB)) {
+      throw std::invalid_argument(THROWTEXT("    vectors are not of same dimension!"));
+    }
+  }
+
+  if constexpr (requires {norm.finalize(norm.accumulate(0.0, diff(*beginB, *beginA)));}) {
+    // fused: fold each difference into the norm right away
+    double acc = 0.0;
+    for (; beginA != endA && beginB != endB; ++beginA, ++beginB) {
+      acc = norm.accumulate(acc, diff(*beginB, *beginA));
+    }
+
+    // without random access, the lengths are only known at this point
+    if constexpr (!randomAccess) {
+      if (beginA != endA || beginB != endB) {
+        throw std::invalid_argument(THROWTEXT("    vectors are not of same dimension!"));
+      }
+    }
+
+    return norm.finalize(acc);
+  }
+  else {
+    typedef std::decay_t<decltype(diff(*beginB, *beginA))> D;
+
+    std::vector<D> delta;
+    if constexpr (randomAccess) {delta.reserve(std::distance(beginA, endA));}
+
+    for (; beginA != endA && beginB != endB; ++beginA, ++beginB) {
+      delta.push_back(diff(*beginB, *beginA));
+    }
+
+    if constexpr (!randomAccess) {
+      if (beginA != endA || beginB != endB) {
+        throw std::invalid_argument(THROWTEXT("    vectors are not of same dimension!"));
+      }
+    }
+
+    return norm(delta.begin(), delta.end());
+  }
+}
+// .......................................................................... //
+template<class T>
+double BCG::vector_distance(const std::vector<T> & A, const std::vector<T> & B) {
+  return BCG::vector_distance(A.begin(), A.end(), B.begin(), B.end());
+}
+// -------------------------------------------------------------------------- //
+// pairwise distances
+
+template<class Norm>
+void BCG::pairwise_distance(const double * A, const size_t nA,
+                            const double * B, const size_t nB,
+                            const size_t dim,
+                            double * result,
+                            Norm norm,
+                            unsigned int threads
 ) {
-  auto N = std::distance(beginA, endA);
-  if (N != std::distance(beginB, endB)) {
-    throw std::invalid_argument(THROWTEXT("    vectors are not of same dimension!"));
-  }
-
-  // and this is what causes the problem if you plug in anything other than a
-  // std::vector for A and B:
-  std::vector<typename std::iterator_traits<Iterator>::value_type> delta(N);
-  std::transform(
-    beginB, endB,
-    beginA,
-    delta.begin(),
-    difffunc
-  );
-
-  /* while delta can be computed from any compatible containers, it will always
-   * be a std::vector.
-   * in the return statement, normfunc is invoked, which assumes its parameters
-   * are of type Iterator, which is related to the container and might not be
-   * a std::vector::iterator.
-   *
-   * There's two ways of fixing this issue:
-   * A) demanding that normfunc has to be a templated in std::vector::iterator
-   *    (probably the easier one)
-   * B) dynamically deciding the type of delta to match that of A, B.
-   */
-
-  return normfunc(delta.begin(), delta.end());
-}
-// .......................................................................... //
-// template<class T>
-// double BCG::vector_distance(const std::vector<T> & A, const std::vector<T> & B) {
-//   auto l_add            = [] (const T a, const T b) {return a + b;};
-//   auto l_delta_squared  = [] (const T a, const T b) {T tmp = a - b; return tmp * tmp;};
-//
-//   if ( A.size() != B.size() ) return T();
-//
-//   return std::sqrt(
-//     std::inner_product( A.begin(), A.end(),
-//                         B.begin(),
-//                         0.0,
-//                         l_add,
-//                         l_delta_squared
-//     )
-//   );
-// }
+  if (nA == 0 || nB == 0) {return;}
+
+  constexpr bool   gram          = std::is_same_v<Norm, NormEuclidean> || std::is_same_v<Norm, NormModSquareSum>;
+  constexpr size_t rowBlock      = 32;
+  constexpr size_t maxPanelWidth = 512;
+
+  // a panel of B should stay within about 64 kB
+  const size_t panelWidth = std::clamp<size_t>((8192 / std::max<size_t>(dim, 1)) / 8 * 8, 8, maxPanelWidth);
+  const size_t nPanels    = (nB + panelWidth - 1) / panelWidth;
+
+  // B in panels of panelWidth points, coordinate by coordinate. The last
+  // panel is padded with zeros.
+  std::vector<double> panels(nPanels * panelWidth * dim, 0.0);
+  for (size_t j = 0; j < nB; ++j) {
+    double * panel = panels.data() + (j / panelWidth) * panelWidth * dim;
+    for (size_t k = 0; k < dim; ++k) {panel[k * panelWidth + j % panelWidth] = B[j * dim + k];}
+  }
+
+  std::vector<double> squaresA, squaresB;
+  if constexpr (gram) {
+    squaresA.resize(nA);
+    squaresB.resize(nB);
+    for (size_t i = 0; i < nA; ++i) {squaresA[i] = BCG::norm_modSquareSum_real(A + i * dim, A + i * dim + dim);}
+    for (size_t j = 0; j < nB; ++j) {squaresB[j] = BCG::norm_modSquareSum_real(B + j * dim, B + j * dim + dim);}
+  }
+
+  const size_t nRowBlocks = (nA + rowBlock - 1) / rowBlock;
+
+  parallel_for(nRowBlocks, [&] (const size_t rowBlockID) {
+    const size_t rowBegin = rowBlockID * rowBlock;
+    const size_t rowEnd   = std::min(rowBegin + rowBlock, nA);
+
+    double acc[maxPanelWidth];
+
+    for (size_t p = 0; p < nPanels; ++p) {
+      const double * panel    = panels.data() + p * panelWidth * dim;
+      const size_t   colBegin = p * panelWidth;
+      const size_t   width    = std::min(panelWidth, nB - colBegin);
+
+      for (size_t i = rowBegin; i < rowEnd; ++i) {
+        const double * a = A + i * dim;
+        std::fill(acc, acc + panelWidth, 0.0);
+
+        // runs over consecutive points of the panel, hence vectorizes
+        for (size_t k = 0; k < dim; ++k) {
+          const double   ak  = a[k];
+          const double * row = panel + k * panelWidth;
+          if constexpr (gram) {for (size_t j = 0; j < panelWidth; ++j) {acc[j] += ak * row[j];}}
+          else                {for (size_t j = 0; j < panelWidth; ++j) {acc[j] = norm.accumulate(acc[j], row[j] - ak);}}
+        }
+
+        double * out = result + i * nB + colBegin;
+        if constexpr (gram) {
+          for (size_t j = 0; j < width; ++j) {
+            const double square = std::max(squaresA[i] + squaresB[colBegin + j] - 2.0 * acc[j], 0.0);
+            out[j] = norm.finalize(square);
+          }
+        }
+        else {
+          for (size_t j = 0; j < width; ++j) {out[j] = norm.finalize(acc[j]);}
+        }
+      }
+    }
+  }, threads);
+}
+// .......................................................................... //
+template<class Norm>
+std::vector<double> BCG::pairwise_distance(const std::vector<std::vector<double>> & A,
+                                           const std::vector<std::vector<double>> & B,
+                                           Norm norm,
+                                           unsigned int threads
+) {
+  const size_t dim = A.empty() ? (B.empty() ? 0 : B[0].size()) : A[0].size();
+
+  const std::vector<double> flatA = flatten_points(A, dim);
+  const std::vector<double> flatB = flatten_points(B, dim);
+
+  std::vector<double> reVal(A.size() * B.size());
+  BCG::pairwise_distance(flatA.data(), A.size(), flatB.data(), B.size(), dim, reVal.data(), norm, threads);
+
+  return reVal;
+}
 // -------------------------------------------------------------------------- //
+// k-d tree
+
+template<class Norm>
+BCG::KDTree<Norm>::KDTree(const double * points, const size_t N, const size_t dim, Norm norm, const size_t leafSize) :
+  nPoints(N), dimension(dim), norm(norm)
+{
+  if (leafSize == 0) {
+    throw std::invalid_argument(THROWTEXT("    leaf size must be positive!"));
+  }
+  if (N == 0) {return;}
+
+  indices.resize(N);
+  std::iota(indices.begin(), indices.end(), 0);
+
+  nodes.reserve(4 * (N / leafSize) + 1);
+  build(points, 0, N, leafSize);
+
+  coordinates.resize(N * dim);
+  for (size_t position = 0; position < N; ++position) {
+    std::copy(points + indices[position] * dim, points + indices[position] * dim + dim, coordinates.data() + position * dim);
+  }
+}
+// .......................................................................... //
+template<class Norm>
+BCG::KDTree<Norm>::KDTree(const std::vector<std::vector<double>> & points, Norm norm, const size_t leafSize) :
+  KDTree(flatten_points(points, points.empty() ? 0 : points[0].size()).data(), points.size(), points.empty() ? 0 : points[0].size(), norm, leafSize)
+{}
+// .......................................................................... //
+template<class Norm>
+size_t BCG::KDTree<Norm>::size() const {return nPoints;}
+template<class Norm>
+size_t BCG::KDTree<Norm>::dim () const {return dimension;}
+// .......................................................................... //
+template<class Norm>
+ptrdiff_t BCG::KDTree<Norm>::findNearbyIdx(const double * query, const double epsilon) const {
+  if (nPoints == 0) {return -1;}
+
+  size_t best = nPoints;
+  searchFirst(0, query, epsilon, best);
+
+  return best == nPoints ? -1 : static_cast<ptrdiff_t>(best);
+}
+// .......................................................................... //
+template<class Norm>
+ptrdiff_t BCG::KDTree<Norm>::findNearbyIdx(const std::vector<double> & query, const double epsilon) const {
+  checkQuery(query);
+  return findNearbyIdx(query.data(), epsilon);
+}
+// .......................................................................... //
+template<class Norm>
+std::vector<ptrdiff_t> BCG::KDTree<Norm>::findNearbyIdx(const double * queries, const size_t nQueries, const double epsilon, unsigned int threads) const {
+  constexpr size_t blockSize = 64;
+
+  std::vector<ptrdiff_t> reVal(nQueries);
+  parallel_for((nQueries + blockSize - 1) / blockSize, [&] (const size_t block) {
+    const size_t last = std::min(nQueries, block * blockSize + blockSize);
+    for (size_t i = block * blockSize; i < last; ++i) {reVal[i] = findNearbyIdx(queries + i * dimension, epsilon);}
+  }, threads);
+
+  return reVal;
+}
+// .......................................................................... //
+template<class Norm>
+std::vector<ptrdiff_t> BCG::KDTree<Norm>::findNearbyIdx(const std::vector<std::vector<double>> & queries, const double epsilon, unsigned int threads) const {
+  return findNearbyIdx(flatten_points(queries, dimension).data(), queries.size(), epsilon, threads);
+}
+// .......................................................................... //
+template<class Norm>
+std::vector<size_t> BCG::KDTree<Norm>::findAllNearbyIdx(const double * query, const double epsilon) const {
+  std::vector<size_t> reVal;
+  if (nPoints == 0) {return reVal;}
+
+  searchAll(0, query, epsilon, reVal);
+  std::sort(reVal.begin(), reVal.end());
+
+  return reVal;
+}
+// .......................................................................... //
+template<class Norm>
+std::vector<size_t> BCG::KDTree<Norm>::findAllNearbyIdx(const std::vector<double> & query, const double epsilon) const {
+  checkQuery(query);
+  return findAllNearbyIdx(query.data(), epsilon);
+}
+// .......................................................................... //
+template<class Norm>
+std::vector<BCG::Neighbour> BCG::KDTree<Norm>::findNearest(const double * query, const size_t k) const {
+  std::vector<Neighbour> reVal;
+  if (nPoints == 0 || k == 0) {return reVal;}
+
+  // max-heap of the k closest points so far, worst on top
+  reVal.reserve(std::min(k, nPoints));
+  searchNearest(0, query, k, reVal);
+  std::sort_heap(reVal.begin(), reVal.end(), [] (const Neighbour & lhs, const Neighbour & rhs) {
+    return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.index < rhs.index);
+  });
+
+  return reVal;
+}
+// .......................................................................... //
+template<class Norm>
+std::vector<BCG::Neighbour> BCG::KDTree<Norm>::findNearest(const std::vector<double> & query, const size_t k) const {
+  checkQuery(query);
+  return findNearest(query.data(), k);
+}
+// .......................................................................... //
+template<class Norm>
+std::vector<std::vector<BCG::Neighbour>> BCG::KDTree<Norm>::findNearest(const double * queries, const size_t nQueries, const size_t k, unsigned int threads) const {
+  constexpr size_t blockSize = 64;
+
+  std::vector<std::vector<Neighbour>> reVal(nQueries);
+  parallel_for((nQueries + blockSize - 1) / blockSize, [&] (const size_t block) {
+    const size_t last = std::min(nQueries, block * blockSize + blockSize);
+    for (size_t i = block * blockSize; i < last; ++i) {reVal[i] = findNearest(queries + i * dimension, k);}
+  }, threads);
+
+  return reVal;
+}
+// .......................................................................... //
+template<class Norm>
+std::vector<std::vector<BCG::Neighbour>> BCG::KDTree<Norm>::findNearest(const std::vector<std::vector<double>> & queries, const size_t k, unsigned int threads) const {
+  return findNearest(flatten_points(queries, dimension).data(), queries.size(), k, threads);
+}
+// .......................................................................... //
+template<class Norm>
+size_t BCG::KDTree<Norm>::build(const double * points, const size_t begin, const size_t end, const size_t leafSize) {
+  const size_t id = nodes.size();
+  nodes.push_back({begin, end, nPoints, 0});
+  boxes.resize(boxes.size() + 2 * dimension);
+
+  double * lower = boxes.data() + id * 2 * dimension;
+  double * upper = lower + dimension;
+  std::fill(lower, upper,             std::numeric_limits<double>::infinity());
+  std::fill(upper, upper + dimension, -std::numeric_limits<double>::infinity());
+  for (size_t position = begin; position < end; ++position) {
+    const double * point = points + indices[position] * dimension;
+    for (size_t k = 0; k < dimension; ++k) {
+      lower[k] = std::min(lower[k], point[k]);
+      upper[k] = std::max(upper[k], point[k]);
+    }
+  }
+
+  if (end - begin <= leafSize) {
+    nodes[id].minIndex = *std::min_element(indices.begin() + begin, indices.begin() + end);
+    return id;
+  }
+
+  // split at the median of the coordinate with the largest extent
+  size_t axis = 0;
+  for (size_t k = 1; k < dimension; ++k) {
+    if (upper[k] - lower[k] > upper[axis] - lower[axis]) {axis = k;}
+  }
+
+  const size_t middle = begin + (end - begin) / 2;
+  std::nth_element(indices.begin() + begin, indices.begin() + middle, indices.begin() + end, [&] (const size_t lhs, const size_t rhs) {
+    return points[lhs * dimension + axis] < points[rhs * dimension + axis];
+  });
+
+  // lower and upper are invalidated by the recursion
+  build(points, begin, middle, leafSize);
+  const size_t right = build(points, middle, end, leafSize);
+
+  nodes[id].right    = right;
+  nodes[id].minIndex = std::min(nodes[id + 1].minIndex, nodes[right].minIndex);
+
+  return id;
+}
+// .......................................................................... //
+template<class Norm>
+double BCG::KDTree<Norm>::distance(const size_t position, const double * query) const {
+  const double * point = coordinates.data() + position * dimension;
+
+  double acc = 0.0;
+  for (size_t k = 0; k < dimension; ++k) {acc = norm.accumulate(acc, point[k] - query[k]);}
+
+  return norm.finalize(acc);
+}
+// .......................................................................... //
+template<class Norm>
+double BCG::KDTree<Norm>::boxDistance(const size_t node, const double * query) const {
+  const double * lower = boxes.data() + node * 2 * dimension;
+  const double * upper = lower + dimension;
+
+  // rounding is monotonic, so this never exceeds the distance of a point in the box
+  double acc = 0.0;
+  for (size_t k = 0; k < dimension; ++k) {acc = norm.accumulate(acc, std::max({lower[k] - query[k], query[k] - upper[k], 0.0}));}
+
+  return norm.finalize(acc);
+}
+// .......................................................................... //
+template<class Norm>
+void BCG::KDTree<Norm>::searchFirst(const size_t node, const double * query, const double epsilon, size_t & best) const {
+  const Node & current = nodes[node];
+  if (current.minIndex >= best || !(boxDistance(node, query) < epsilon)) {return;}
+
+  if (current.right == 0) {
+    for (size_t position = current.begin; position < current.end; ++position) {
+      if (indices[position] < best && distance(position, query) < epsilon) {best = indices[position];}
+    }
+    return;
+  }
+
+  // the subtree with the smaller indices first, as its hits prune the other one
+  if (nodes[node + 1].minIndex < nodes[current.right].minIndex) {
+    searchFirst(node + 1,      query, epsilon, best);
+    searchFirst(current.right, query, epsilon, best);
+  } else {
+    searchFirst(current.right, query, epsilon, best);
+    searchFirst(node + 1,      query, epsilon, best);
+  }
+}
+// .......................................................................... //
+template<class Norm>
+void BCG::KDTree<Norm>::searchAll(const size_t node, const double * query, const double epsilon, std::vector<size_t> & found) const {
+  const Node & current = nodes[node];
+  if (!(boxDistance(node, query) < epsilon)) {return;}
+
+  if (current.right == 0) {
+    for (size_t position = current.begin; position < current.end; ++position) {
+      if (distance(position, query) < epsilon) {found.push_back(indices[position]);}
+    }
+    return;
+  }
+
+  searchAll(node + 1,      query, epsilon, found);
+  searchAll(current.right, query, epsilon, found);
+}
+// .......................................................................... //
+template<class Norm>
+void BCG::KDTree<Norm>::searchNearest(const size_t node, const double * query, const size_t k, std::vector<Neighbour> & heap) const {
+  auto closer = [] (const Neighbour & lhs, const Neighbour & rhs) {
+    return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.index < rhs.index);
+  };
+
+  const Node & current = nodes[node];
+
+  if (current.right == 0) {
+    for (size_t position = current.begin; position < current.end; ++position) {
+      const Neighbour candidate = {indices[position], distance(position, query)};
+      if (heap.size() < k) {
+        heap.push_back(candidate);
+        std::push_heap(heap.begin(), heap.end(), closer);
+      } else if (closer(candidate, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), closer);
+        heap.back() = candidate;
+        std::push_heap(heap.begin(), heap.end(), closer);
+      }
+    }
+    return;
+  }
+
+  // the closer box first, as its points shrink the search radius for the other one
+  size_t near = node + 1, far = current.right;
+  double nearDistance = boxDistance(near, query), farDistance = boxDistance(far, query);
+  if (farDistance < nearDistance) {
+    std::swap(near, far);
+    std::swap(nearDistance, farDistance);
+  }
+
+  if (heap.size() < k || nearDistance <= heap.front().distance) {searchNearest(near, query, k, heap);}
+  if (heap.size() < k || farDistance  <= heap.front().distance) {searchNearest(far,  query, k, heap);}
+}
+// .......................................................................... //
+template<class Norm>
+void BCG::KDTree<Norm>::checkQuery(const std::vector<double> & query) const {
+  if (query.size() != dimension) {
+    throw std::invalid_argument(THROWTEXT("    points are not of same dimension!"));
+  }
+}
+
+// -------------------------------------------------------------------------- //
+// split complex vectors
+
+template<class Iterator>
+BCG::ComplexVector::ComplexVector(Iterator begin, Iterator end) {
+  for (; begin != end; ++begin) {
+    const complex_d_t z = *begin;
+    re.push_back(z.real());
+    im.push_back(z.imag());
+  }
+}
+// .......................................................................... //
+inline size_t BCG::ComplexVector::size() const {return re.size();}
+inline BCG::complex_d_t BCG::ComplexVector::operator[](const size_t i) const {return complex_d_t(re[i], im[i]);}
+inline void BCG::ComplexVector::set(const size_t i, const complex_d_t z) {re[i] = z.real(); im[i] = z.imag();}
+// .......................................................................... //
+inline double       * BCG::ComplexVector::real()       {return re.data();}
+inline const double * BCG::ComplexVector::real() const {return re.data();}
+inline double       * BCG::ComplexVector::imag()       {return im.data();}
+inline const double * BCG::ComplexVector::imag() const {return im.data();}
+
+// -------------------------------------------------------------------------- //
+// combinatorics
+
 template <typename T>
-static inline T BCG::factorial (T n) {
-  /* Can be used with GMP types and works just fine. However, GMP classes have
-   * their proper methods for this.
-   *
-   * type unsigned long long int yields correct results up to n = 20 and then
-   * goes into overload (returns zero)
-   * type double yields good results up to n = 22
-   *    reaches computation limit after n = 170 and will yield nan:inf beyond
-   *    (nothrow)
-   *    use at own risk above that
-   * type long double yields good results up to n = 25
-   */
-
-  if (n <   0) {throw std::invalid_argument(THROWTEXT("    only positive arguments allowed."));}
+constexpr static inline T BCG::factorial (T n) {
+  if constexpr (!std::is_unsigned_v<T>) {
+    if (n < 0) {throw std::invalid_argument(THROWTEXT("    only positive arguments allowed."));}
+  }
+
+  if constexpr (std::is_integral_v<T>) {
+    // the largest n for which n! is representable in T
+    constexpr size_t maxN = [] () {
+      size_t reVal = 0;
+      while (reVal + 1 < factorialTable.size() && factorialTable[reVal + 1] <= static_cast<unsigned long long>(std::numeric_limits<T>::max())) {++reVal;}
+      return reVal;
+    }();
+
+    if (static_cast<size_t>(n) > maxN) {throw std::overflow_error(THROWTEXT("    n! is not representable in the argument type."));}
+    return static_cast<T>(factorialTable[n]);
+  }
+  else if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+    if (n >= factorialTable_double.size()) {return std::numeric_limits<T>::infinity();}
+    if (n == static_cast<size_t>(n)) {return static_cast<T>(factorialTable_double[static_cast<size_t>(n)]);}
+  }
 
   T reVal = 1.0;
   for (T i = 2; i < n + 1; ++i) {reVal *= i;}
@@ -153,6 +742,56 @@ static inline T BCG::factorial (T n) {
   return reVal;
 }
 // .......................................................................... //
+constexpr static inline unsigned long long BCG::binomial(const unsigned int n, unsigned int k) {
+  if (k > n) {return 0;}
+  if (n <= binomialTableMaxN) {return binomialTable[static_cast<size_t>(n) * (n + 1) / 2 + k];}
+
+  // C(n - k + i, i) = C(n - k + i - 1, i - 1) * (n - k + i) / i, where i / g
+  // divides (n - k + i) for g = gcd(C(...), i)
+  k = std::min(k, n - k);
+  unsigned long long reVal = 1;
+  for (unsigned long long i = 1; i <= k; ++i) {
+    const unsigned long long g = std::gcd(reVal, i);
+    if (__builtin_mul_overflow(reVal / g, (n - k + i) / (i / g), &reVal)) {
+      throw std::overflow_error(THROWTEXT("    binomial coefficient exceeds 64 bits."));
+    }
+  }
+
+  return reVal;
+}
+// .......................................................................... //
+template<class Iterator>
+constexpr unsigned long long BCG::multinomial(Iterator begin, Iterator end) {
+  unsigned long long reVal = 1;
+  unsigned int       n     = 0;
+
+  for (; begin != end; ++begin) {
+    const unsigned int k = *begin;
+    if (__builtin_add_overflow(n, k, &n) || __builtin_mul_overflow(reVal, BCG::binomial(n, k), &reVal)) {
+      throw std::overflow_error(THROWTEXT("    multinomial coefficient exceeds 64 bits."));
+    }
+  }
+
+  return reVal;
+}
+// .......................................................................... //
+constexpr static inline unsigned long long BCG::multinomial(const std::initializer_list<unsigned int> k) {return BCG::multinomial(k.begin(), k.end());}
+// .......................................................................... //
+template<class Iterator>
+double BCG::logMultinomial(Iterator begin, Iterator end) {
+  unsigned long long n     = 0;
+  double             reVal = 0.0;
+
+  for (; begin != end; ++begin) {
+    n     += *begin;
+    reVal -= BCG::logFactorial(*begin);
+  }
+
+  return reVal + BCG::logFactorial(n);
+}
+// .......................................................................... //
+static inline double BCG::logMultinomial(const std::initializer_list<unsigned int> k) {return BCG::logMultinomial(k.begin(), k.end());}
+// .......................................................................... //
 template <typename T>
 constexpr static inline int sgn(T val) {return (T(0) < val) - (val < T(0));}
 // ========================================================================== //
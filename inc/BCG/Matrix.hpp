@@ -0,0 +1,286 @@
+/**
+ * @defgroup BCG_Matrix BCG Matrix Module
+ *
+ * @brief a dense, contiguous matrix type with cache blocked kernels
+ */
+
+#ifndef BCG_MATRIX_HPP
+#define BCG_MATRIX_HPP
+
+// ========================================================================= //
+// dependencies
+
+#include <stdexcept>
+
+#include <cstddef>
+#include <complex>
+#include <vector>
+#include <initializer_list>
+#include <type_traits>
+#include <random>
+
+#include <algorithm>
+#include <cmath>
+
+// ========================================================================== //
+
+namespace BCG {
+  //! @addtogroup BCG_Matrix
+  //! @{
+
+  // ------------------------------------------------------------------------ //
+  // enums and structs
+
+  /**
+   * @brief a non-owning, strided view of a matrix
+   *
+   * Element @f$(i, j)@f$ lives at <tt>data()[i * rowStride() + j * colStride()]</tt>.
+   * A view of a row-major Matrix has <tt>colStride() == 1</tt>; its
+   * transposed() view has <tt>rowStride() == 1</tt>. Blocks, transposes and
+   * views into foreign arrays are thus all expressed without copying.
+   *
+   * A <tt>MatrixView<const T></tt> is read-only. A <tt>MatrixView<T></tt>
+   * converts to it implicitly. The view does not keep the viewed memory
+   * alive.
+   */
+  template<class T>
+  class MatrixView {
+    public:
+      //! @brief the element type, without const
+      using value_type = std::remove_const_t<T>;
+
+      //! @brief creates an empty view
+      MatrixView() = default;
+
+      //! @brief views the \c rows x \c cols matrix at \c data with the given strides (in elements)
+      MatrixView(T * data, const size_t rows, const size_t cols, const ptrdiff_t rowStride, const ptrdiff_t colStride = 1);
+
+      //! @brief read-only view of the elements of \c other
+      template<class U> requires (std::is_same_v<const U, T> && !std::is_const_v<U>)
+      MatrixView(const MatrixView<U> & other);
+
+      //! @brief the number of rows
+      size_t    rows() const;
+      //! @brief the number of columns
+      size_t    cols() const;
+      //! @brief the distance between two rows, in elements
+      ptrdiff_t rowStride() const;
+      //! @brief the distance between two columns, in elements
+      ptrdiff_t colStride() const;
+      //! @brief the address of element (0, 0)
+      T       * data() const;
+
+      //! @brief returns element @f$(i, j)@f$, without bounds check
+      T & operator()(const size_t i, const size_t j) const;
+
+      //! @brief returns this view, for symmetry with Matrix::view()
+      MatrixView view() const;
+
+      /**
+       * @brief the \c nRows x \c nCols block starting at element (\c row, \c col)
+       *
+       * @throws std::invalid_argument if the block exceeds the view
+       */
+      MatrixView block(const size_t row, const size_t col, const size_t nRows, const size_t nCols) const;
+
+      //! @brief the transposed view, i.e. rows and columns swapped
+      MatrixView transposed() const;
+
+    private:
+      T       * elements = nullptr;
+      size_t    nRows    = 0;
+      size_t    nCols    = 0;
+      ptrdiff_t strideR  = 0;
+      ptrdiff_t strideC  = 1;
+  };
+
+  /**
+   * @brief a dense matrix, stored contiguously in row-major order
+   *
+   * Unlike a <tt>std::vector<std::vector<T>></tt>, all elements are in one
+   * block of memory, so rows can be handed to the SIMD kernels of the Maths
+   * module and the multiplication can work on cache sized blocks. Use view()
+   * and block() for strided, non-owning access, and to_vecvec() or the
+   * converting constructor to interoperate with the nested vector layout
+   * used elsewhere, e.g. by vecvec_to_string().
+   *
+   * \b Example:
+   * @code
+   * BCG::Matrix<double> A = {{1, 2}, {3, 4}};
+   * auto B = BCG::multiply(A, A.view().transposed());
+   *
+   * std::cout << BCG::vecvec_to_string(B.to_vecvec()) << std::endl;
+   * @endcode
+   */
+  template<class T>
+  class Matrix {
+    public:
+      //! @brief the element type
+      using value_type = T;
+
+      //! @brief creates an empty 0 x 0 matrix
+      Matrix() = default;
+
+      //! @brief creates a \c rows x \c cols matrix filled with \c value
+      Matrix(const size_t rows, const size_t cols, const T & value = T());
+
+      /**
+       * @brief creates a matrix from a list of rows
+       *
+       * @throws std::invalid_argument if the rows differ in length
+       */
+      Matrix(std::initializer_list<std::initializer_list<T>> rows);
+
+      /**
+       * @brief converts from a vector of rows
+       *
+       * @throws std::invalid_argument if the rows differ in length
+       */
+      explicit Matrix(const std::vector<std::vector<T>> & vecvec);
+
+      //! @brief copies the elements of a view into a new, contiguous matrix
+      template<class U>
+      explicit Matrix(const MatrixView<U> & view);
+
+      //! @brief the \c N x \c N identity matrix
+      static Matrix identity(const size_t N);
+
+      //! @brief converts to a vector of rows
+      std::vector<std::vector<T>> to_vecvec() const;
+
+      //! @brief the number of rows
+      size_t rows() const;
+      //! @brief the number of columns
+      size_t cols() const;
+      //! @brief the number of elements
+      size_t size() const;
+
+      //! @brief the row-major array of elements
+      T       * data();
+      //! @brief the row-major array of elements
+      const T * data() const;
+
+      //! @brief returns element @f$(i, j)@f$, without bounds check
+      T       & operator()(const size_t i, const size_t j);
+      //! @brief returns element @f$(i, j)@f$, without bounds check
+      const T & operator()(const size_t i, const size_t j) const;
+
+      //! @brief a view of the whole matrix
+      MatrixView<T>       view();
+      //! @brief a read-only view of the whole matrix
+      MatrixView<const T> view() const;
+
+      //! @brief a view of a block. See MatrixView::block().
+      MatrixView<T>       block(const size_t row, const size_t col, const size_t nRows, const size_t nCols);
+      //! @brief a read-only view of a block. See MatrixView::block().
+      MatrixView<const T> block(const size_t row, const size_t col, const size_t nRows, const size_t nCols) const;
+
+      //! @brief whether both matrices have the same shape and elements
+      bool operator==(const Matrix & other) const = default;
+
+    private:
+      size_t         nRows = 0;
+      size_t         nCols = 0;
+      std::vector<T> elements;
+  };
+
+  /**
+   * @brief satisfied by Matrix and MatrixView. All functions below take their
+   *  matrix arguments as either, of any strides. Where two matrices are
+   *  combined, both need to have the same \c value_type.
+   */
+  template<class M>
+  concept MatrixLike = requires (const M & A) {A.view(); A.rows(); A.cols();};
+
+  // ------------------------------------------------------------------------ //
+  // procs
+
+  /**
+   * @brief returns the transpose of \c A as a new, contiguous matrix
+   *
+   * The elements are copied in tiles of 32 x 32, so that both reading and
+   * writing stay within a few cache lines per row. Use
+   * <tt>A.view().transposed()</tt> instead if no copy is needed.
+   */
+  template<MatrixLike MatrixA>
+  Matrix<typename MatrixA::value_type> transpose(const MatrixA & A);
+
+  /**
+   * @brief computes the matrix product @f$A B@f$
+   *
+   * The product is computed on blocks of @f$A@f$ and @f$B@f$ that fit into
+   * the caches. Both are packed into contiguous buffers first, so strided
+   * and transposed views are as fast as contiguous matrices. The row blocks
+   * of the result are distributed over \c threads threads with
+   * parallel_for(). For \c double, the innermost products are computed by
+   * register blocked AVX2 or AVX-512 kernels if the CPU supports them,
+   * selected at runtime.
+   *
+   * @param threads the number of threads to use. 0 means \c BCG::nThreads.
+   *
+   * @throws std::invalid_argument if <tt>A.cols() != B.rows()</tt>
+   */
+  template<MatrixLike MatrixA, MatrixLike MatrixB>
+  Matrix<typename MatrixA::value_type> multiply(const MatrixA & A, const MatrixB & B, unsigned int threads = 0);
+
+  //! @brief SIMD version of multiply() for matrices of \c double
+  Matrix<double> multiply(const MatrixView<const double> & A, const MatrixView<const double> & B, unsigned int threads = 0);
+
+  /**
+   * @brief computes the matrix vector product @f$A x@f$
+   *
+   * Rows with unit column stride are processed as dot products of four rows
+   * at a time, otherwise the columns of \c A are added up scaled by @f$x_j@f$.
+   *
+   * @throws std::invalid_argument if <tt>A.cols() != x.size()</tt>
+   */
+  template<MatrixLike MatrixA>
+  std::vector<typename MatrixA::value_type> multiply(const MatrixA & A, const std::vector<typename MatrixA::value_type> & x);
+
+  //! @brief SIMD version of multiply() for a matrix and a vector of \c double
+  std::vector<double> multiply(const MatrixView<const double> & A, const std::vector<double> & x);
+
+  /**
+   * @brief computes the Frobenius norm @f$\sqrt{\sum_{ij} |a_{ij}|^2}@f$
+   *
+   * Contiguous rows of \c double and \c complex_d_t are passed to the SIMD
+   * kernels of norm_modSquareSum_real(). \c mode applies to each row; the
+   * row sums are added naively.
+   */
+  template<MatrixLike MatrixA>
+  double norm_Frobenius(const MatrixA & A, const SummationMode mode = SummationMode::Naive);
+
+  //! @brief computes the induced 1-norm, i.e. the largest absolute column sum @f$\max_j \sum_i |a_{ij}|@f$
+  template<MatrixLike MatrixA>
+  double norm_1(const MatrixA & A);
+
+  //! @brief computes the induced @f$\infty@f$-norm, i.e. the largest absolute row sum @f$\max_i \sum_j |a_{ij}|@f$
+  template<MatrixLike MatrixA>
+  double norm_inf(const MatrixA & A);
+
+  /**
+   * @brief computes the induced 2-norm (spectral norm), i.e. the largest
+   *  singular value of \c A
+   *
+   * Uses power iteration on @f$A^\dagger A@f$, starting from a fixed
+   * pseudorandom vector, so the result is deterministic. The estimate
+   * @f$\|A v\|@f$ for the current unit vector @f$v@f$ grows monotonically
+   * towards the norm; the iteration stops when it changes by less than
+   * \c tolerance relative to its value. Convergence is slow if the two
+   * largest singular values are close.
+   *
+   * @returns the last estimate, which is a lower bound, also if
+   *  \c maxIterations is reached without convergence
+   */
+  template<MatrixLike MatrixA>
+  double norm_2(const MatrixA & A, const double tolerance = 1e-12, const size_t maxIterations = 1000);
+
+  //! @}
+}
+
+// ========================================================================== //
+// template implementations
+
+#include "BCG/Matrix.tpp"
+
+#endif
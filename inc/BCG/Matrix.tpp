@@ -0,0 +1,397 @@
+// ========================================================================== //
+// local macro
+
+#define THROWTEXT(msg) (std::string("RUNTIME EXCEPTION IN ") + (__PRETTY_FUNCTION__) + "\n" + msg)
+
+// ========================================================================== //
+// enums and structs
+
+template<class T>
+BCG::MatrixView<T>::MatrixView(T * data, const size_t rows, const size_t cols, const ptrdiff_t rowStride, const ptrdiff_t colStride) :
+  elements(data),
+  nRows   (rows),
+  nCols   (cols),
+  strideR (rowStride),
+  strideC (colStride)
+{}
+// .......................................................................... //
+template<class T>
+template<class U> requires (std::is_same_v<const U, T> && !std::is_const_v<U>)
+BCG::MatrixView<T>::MatrixView(const MatrixView<U> & other) :
+  MatrixView(other.data(), other.rows(), other.cols(), other.rowStride(), other.colStride())
+{}
+// .......................................................................... //
+template<class T> inline size_t    BCG::MatrixView<T>::rows     () const {return nRows;}
+template<class T> inline size_t    BCG::MatrixView<T>::cols     () const {return nCols;}
+template<class T> inline ptrdiff_t BCG::MatrixView<T>::rowStride() const {return strideR;}
+template<class T> inline ptrdiff_t BCG::MatrixView<T>::colStride() const {return strideC;}
+template<class T> inline T       * BCG::MatrixView<T>::data     () const {return elements;}
+// .......................................................................... //
+template<class T>
+inline T & BCG::MatrixView<T>::operator()(const size_t i, const size_t j) const {
+  return elements[static_cast<ptrdiff_t>(i) * strideR + static_cast<ptrdiff_t>(j) * strideC];
+}
+// .......................................................................... //
+template<class T>
+inline BCG::MatrixView<T> BCG::MatrixView<T>::view() const {return *this;}
+// .......................................................................... //
+template<class T>
+BCG::MatrixView<T> BCG::MatrixView<T>::block(const size_t row, const size_t col, const size_t nRows, const size_t nCols) const {
+  if (row + nRows > this->nRows || col + nCols > this->nCols) {
+    throw std::invalid_argument(THROWTEXT("    block exceeds the matrix!"));
+  }
+  return MatrixView((nRows && nCols) ? &(*this)(row, col) : elements, nRows, nCols, strideR, strideC);
+}
+// .......................................................................... //
+template<class T>
+BCG::MatrixView<T> BCG::MatrixView<T>::transposed() const {
+  return MatrixView(elements, nCols, nRows, strideC, strideR);
+}
+
+// -------------------------------------------------------------------------- //
+
+template<class T>
+BCG::Matrix<T>::Matrix(const size_t rows, const size_t cols, const T & value) :
+  nRows   (rows),
+  nCols   (cols),
+  elements(rows * cols, value)
+{}
+// .......................................................................... //
+template<class T>
+BCG::Matrix<T>::Matrix(std::initializer_list<std::initializer_list<T>> rows) :
+  nRows(rows.size()),
+  nCols(rows.size() ? rows.begin()->size() : 0)
+{
+  elements.reserve(nRows * nCols);
+  for (const auto & row : rows) {
+    if (row.size() != nCols) {throw std::invalid_argument(THROWTEXT("    rows are not of same length!"));}
+    elements.insert(elements.end(), row.begin(), row.end());
+  }
+}
+// .......................................................................... //
+template<class T>
+BCG::Matrix<T>::Matrix(const std::vector<std::vector<T>> & vecvec) :
+  nRows(vecvec.size()),
+  nCols(vecvec.size() ? vecvec[0].size() : 0)
+{
+  elements.reserve(nRows * nCols);
+  for (const auto & row : vecvec) {
+    if (row.size() != nCols) {throw std::invalid_argument(THROWTEXT("    rows are not of same length!"));}
+    elements.insert(elements.end(), row.begin(), row.end());
+  }
+}
+// .......................................................................... //
+template<class T>
+template<class U>
+BCG::Matrix<T>::Matrix(const MatrixView<U> & view) :
+  nRows(view.rows()),
+  nCols(view.cols())
+{
+  elements.reserve(nRows * nCols);
+  for   (size_t i = 0; i < nRows; ++i) {
+    for (size_t j = 0; j < nCols; ++j) {elements.push_back(view(i, j));}
+  }
+}
+// .......................................................................... //
+template<class T>
+BCG::Matrix<T> BCG::Matrix<T>::identity(const size_t N) {
+  Matrix reVal(N, N, T(0));
+  for (size_t i = 0; i < N; ++i) {reVal(i, i) = T(1);}
+  return reVal;
+}
+// .......................................................................... //
+template<class T>
+std::vector<std::vector<T>> BCG::Matrix<T>::to_vecvec() const {
+  std::vector<std::vector<T>> reVal;
+  reVal.reserve(nRows);
+  for (size_t i = 0; i < nRows; ++i) {
+    reVal.emplace_back(elements.begin() + i * nCols, elements.begin() + (i + 1) * nCols);
+  }
+  return reVal;
+}
+// .......................................................................... //
+template<class T> inline size_t    BCG::Matrix<T>::rows() const {return nRows;}
+template<class T> inline size_t    BCG::Matrix<T>::cols() const {return nCols;}
+template<class T> inline size_t    BCG::Matrix<T>::size() const {return elements.size();}
+template<class T> inline T       * BCG::Matrix<T>::data()       {return elements.data();}
+template<class T> inline const T * BCG::Matrix<T>::data() const {return elements.data();}
+// .......................................................................... //
+template<class T>
+inline T       & BCG::Matrix<T>::operator()(const size_t i, const size_t j)       {return elements[i * nCols + j];}
+template<class T>
+inline const T & BCG::Matrix<T>::operator()(const size_t i, const size_t j) const {return elements[i * nCols + j];}
+// .......................................................................... //
+template<class T>
+inline BCG::MatrixView<T>       BCG::Matrix<T>::view()       {return MatrixView<T>      (elements.data(), nRows, nCols, nCols);}
+template<class T>
+inline BCG::MatrixView<const T> BCG::Matrix<T>::view() const {return MatrixView<const T>(elements.data(), nRows, nCols, nCols);}
+// .......................................................................... //
+template<class T>
+BCG::MatrixView<T>       BCG::Matrix<T>::block(const size_t row, const size_t col, const size_t nRows, const size_t nCols)       {
+  return view().block(row, col, nRows, nCols);
+}
+template<class T>
+BCG::MatrixView<const T> BCG::Matrix<T>::block(const size_t row, const size_t col, const size_t nRows, const size_t nCols) const {
+  return view().block(row, col, nRows, nCols);
+}
+
+// ========================================================================== //
+// procs
+
+template<BCG::MatrixLike MatrixA>
+BCG::Matrix<typename MatrixA::value_type> BCG::transpose(const MatrixA & A) {
+  using T = typename MatrixA::value_type;
+  constexpr size_t tile = 32;
+
+  const auto   a     = A.view();
+  const size_t nRows = a.rows();
+  const size_t nCols = a.cols();
+
+  Matrix<T> reVal(nCols, nRows);
+  T * target = reVal.data();
+
+  for     (size_t i0 = 0; i0 < nRows; i0 += tile) {
+    for   (size_t j0 = 0; j0 < nCols; j0 += tile) {
+      const size_t iEnd = std::min(i0 + tile, nRows);
+      const size_t jEnd = std::min(j0 + tile, nCols);
+      for (size_t i = i0; i < iEnd; ++i) {
+        for (size_t j = j0; j < jEnd; ++j) {target[j * nRows + i] = a(i, j);}
+      }
+    }
+  }
+
+  return reVal;
+}
+// .......................................................................... //
+template<BCG::MatrixLike MatrixA, BCG::MatrixLike MatrixB>
+BCG::Matrix<typename MatrixA::value_type> BCG::multiply(const MatrixA & A, const MatrixB & B, unsigned int threads) {
+  using T = typename MatrixA::value_type;
+  static_assert(std::is_same_v<T, typename MatrixB::value_type>, "matrices need to have the same value_type");
+
+  if constexpr (std::is_same_v<T, double>) {
+    return BCG::multiply(MatrixView<const double>(A.view()), MatrixView<const double>(B.view()), threads);
+
+  } else {
+    constexpr size_t blockRows  = 64;
+    constexpr size_t blockInner = 128;
+    constexpr size_t blockCols  = 256;
+
+    const auto a = A.view();
+    const auto b = B.view();
+    const size_t M = a.rows(), N = b.cols(), K = a.cols();
+
+    if (K != b.rows()) {throw std::invalid_argument(THROWTEXT("    matrices are not of compatible dimensions!"));}
+
+    Matrix<T> reVal(M, N, T(0));
+    if (M == 0 || N == 0 || K == 0) {return reVal;}
+
+    // B in tiles of blockInner x blockCols. The rows p0 ... p0 + kb of B
+    // occupy [p0 * N, (p0 + kb) * N), the tile of columns j0 ... j0 + nb
+    // therein starts at p0 * N + j0 * kb and is stored row by row.
+    std::vector<T> packed(K * N);
+    for   (size_t p0 = 0; p0 < K; p0 += blockInner) {
+      const size_t kb = std::min(blockInner, K - p0);
+      for (size_t j0 = 0; j0 < N; j0 += blockCols) {
+        const size_t nb   = std::min(blockCols, N - j0);
+        T *          tile = packed.data() + p0 * N + j0 * kb;
+        for (size_t p = 0; p < kb; ++p) {
+          for (size_t j = 0; j < nb; ++j) {tile[p * nb + j] = b(p0 + p, j0 + j);}
+        }
+      }
+    }
+
+    const size_t nRowBlocks = (M + blockRows - 1) / blockRows;
+    parallel_for(nRowBlocks, [&] (const size_t rowBlockID) {
+      const size_t rowBegin = rowBlockID * blockRows;
+      const size_t rowEnd   = std::min(rowBegin + blockRows, M);
+
+      for     (size_t j0 = 0; j0 < N; j0 += blockCols) {
+        const size_t nb = std::min(blockCols, N - j0);
+        for   (size_t p0 = 0; p0 < K; p0 += blockInner) {
+          const size_t kb   = std::min(blockInner, K - p0);
+          const T *    tile = packed.data() + p0 * N + j0 * kb;
+          for (size_t i = rowBegin; i < rowEnd; ++i) {
+            T * c = reVal.data() + i * N + j0;
+            for (size_t p = 0; p < kb; ++p) {
+              const T   aip = a(i, p0 + p);
+              const T * bp  = tile + p * nb;
+              for (size_t j = 0; j < nb; ++j) {c[j] += aip * bp[j];}
+            }
+          }
+        }
+      }
+    }, threads);
+
+    return reVal;
+  }
+}
+// .......................................................................... //
+template<BCG::MatrixLike MatrixA>
+std::vector<typename MatrixA::value_type> BCG::multiply(const MatrixA & A, const std::vector<typename MatrixA::value_type> & x) {
+  using T = typename MatrixA::value_type;
+
+  if constexpr (std::is_same_v<T, double>) {
+    return BCG::multiply(MatrixView<const double>(A.view()), x);
+
+  } else {
+    const auto a = A.view();
+    if (a.cols() != x.size()) {throw std::invalid_argument(THROWTEXT("    matrix and vector are not of compatible dimensions!"));}
+
+    const size_t M = a.rows(), N = a.cols();
+    std::vector<T> reVal(M, T(0));
+
+    if (a.colStride() == 1) {
+      for (size_t i = 0; i < M; ++i) {
+        const T * row = a.data() + static_cast<ptrdiff_t>(i) * a.rowStride();
+        T acc[4] = {T(0), T(0), T(0), T(0)};
+
+        size_t j = 0;
+        for (; j + 4 <= N; j += 4) {
+          for (size_t l = 0; l < 4; ++l) {acc[l] += row[j + l] * x[j + l];}
+        }
+        for (; j < N; ++j) {acc[0] += row[j] * x[j];}
+
+        reVal[i] = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+      }
+    } else {
+      for (size_t j = 0; j < N; ++j) {
+        for (size_t i = 0; i < M; ++i) {reVal[i] += a(i, j) * x[j];}
+      }
+    }
+
+    return reVal;
+  }
+}
+// .......................................................................... //
+template<BCG::MatrixLike MatrixA>
+double BCG::norm_Frobenius(const MatrixA & A, const SummationMode mode) {
+  using T = typename MatrixA::value_type;
+
+  const auto a = A.view();
+  size_t nRows = a.rows();
+  size_t nCols = a.cols();
+
+  // a contiguous matrix is one long row
+  if (a.colStride() == 1 && a.rowStride() == static_cast<ptrdiff_t>(nCols)) {
+    nCols *= nRows;
+    nRows  = std::min<size_t>(nRows, 1);
+  }
+
+  double         reVal = 0.0;
+  std::vector<T> buffer;
+  for (size_t i = 0; i < nRows; ++i) {
+    const T * row;
+    if (a.colStride() == 1) {
+      row = a.data() + static_cast<ptrdiff_t>(i) * a.rowStride();
+    } else {
+      buffer.resize(nCols);
+      for (size_t j = 0; j < nCols; ++j) {buffer[j] = a(i, j);}
+      row = buffer.data();
+    }
+
+    if constexpr (std::is_same_v<T, complex_d_t>) {
+      const double * parts = reinterpret_cast<const double *>(row);
+      reVal += BCG::norm_modSquareSum_real(parts, parts + 2 * nCols, mode);
+    } else {
+      reVal += BCG::norm_modSquareSum(row, row + nCols, mode);
+    }
+  }
+
+  return std::sqrt(reVal);
+}
+// .......................................................................... //
+template<BCG::MatrixLike MatrixA>
+double BCG::norm_1(const MatrixA & A) {
+  const auto   a     = A.view();
+  const size_t nRows = a.rows();
+  const size_t nCols = a.cols();
+
+  // sweep row by row, so that a row-major matrix is read in order
+  std::vector<double> columnSums(nCols, 0.0);
+  for   (size_t i = 0; i < nRows; ++i) {
+    for (size_t j = 0; j < nCols; ++j) {columnSums[j] += std::abs(a(i, j));}
+  }
+
+  return columnSums.empty() ? 0.0 : *std::max_element(columnSums.begin(), columnSums.end());
+}
+// .......................................................................... //
+template<BCG::MatrixLike MatrixA>
+double BCG::norm_inf(const MatrixA & A) {
+  using T = typename MatrixA::value_type;
+
+  const auto   a     = A.view();
+  const size_t nRows = a.rows();
+  const size_t nCols = a.cols();
+
+  double         reVal = 0.0;
+  std::vector<T> buffer;
+  for (size_t i = 0; i < nRows; ++i) {
+    const T * row;
+    if (a.colStride() == 1) {
+      row = a.data() + static_cast<ptrdiff_t>(i) * a.rowStride();
+    } else {
+      buffer.resize(nCols);
+      for (size_t j = 0; j < nCols; ++j) {buffer[j] = a(i, j);}
+      row = buffer.data();
+    }
+    reVal = std::max(reVal, BCG::norm_absSum(row, row + nCols));
+  }
+
+  return reVal;
+}
+// .......................................................................... //
+template<BCG::MatrixLike MatrixA>
+double BCG::norm_2(const MatrixA & A, const double tolerance, const size_t maxIterations) {
+  using T = typename MatrixA::value_type;
+  static_assert(std::is_floating_point_v<T> || is_complex_v<T>, "norm_2 requires floating point or complex elements");
+
+  const auto   a     = A.view();
+  const size_t nRows = a.rows();
+  const size_t nCols = a.cols();
+
+  if (nRows == 0 || nCols == 0) {return 0.0;}
+
+  // computes A^dagger w
+  auto multiplyAdjoint = [&] (const std::vector<T> & w) {
+    if constexpr (is_complex_v<T>) {
+      std::vector<T> reVal(nCols, T(0));
+      for   (size_t i = 0; i < nRows; ++i) {
+        for (size_t j = 0; j < nCols; ++j) {reVal[j] += std::conj(a(i, j)) * w[i];}
+      }
+      return reVal;
+    } else {
+      return BCG::multiply(a.transposed(), w);
+    }
+  };
+
+  std::mt19937                           engine(0);
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+  std::vector<T> v(nCols);
+  for (auto & element : v) {element = distribution(engine);}
+
+  double vNorm = BCG::norm_Euclidean(v.begin(), v.end());
+  double reVal = 0.0;
+
+  for (size_t iteration = 0; iteration < maxIterations; ++iteration) {
+    for (auto & element : v) {element /= vNorm;}
+
+    const auto   w        = BCG::multiply(a, v);
+    const double estimate = BCG::norm_Euclidean(w.begin(), w.end());
+    if (estimate == 0.0) {break;}
+
+    const bool converged = std::abs(estimate - reVal) <= tolerance * estimate;
+    reVal = estimate;
+    if (converged) {break;}
+
+    v     = multiplyAdjoint(w);
+    vNorm = BCG::norm_Euclidean(v.begin(), v.end());
+    if (vNorm == 0.0) {break;}
+  }
+
+  return reVal;
+}
+
+// ========================================================================== //
+
+#undef THROWTEXT
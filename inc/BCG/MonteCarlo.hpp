@@ -0,0 +1,160 @@
+/**
+ * @defgroup BCG_MonteCarlo BCG Monte Carlo Module
+ *
+ * @brief a reusable, multithreaded driver for Monte Carlo estimates
+ */
+
+#ifndef BCG_MONTECARLO_HPP
+#define BCG_MONTECARLO_HPP
+
+// ========================================================================= //
+// dependencies
+
+#include <stdexcept>
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cmath>
+
+// ========================================================================== //
+
+namespace BCG {
+  //! @addtogroup BCG_MonteCarlo
+  //! @{
+
+  // ------------------------------------------------------------------------ //
+  // enums and structs
+
+  /**
+   * @brief accumulates count, mean and variance of a stream of values in a
+   *  single pass (Welford's algorithm).
+   *
+   * Two accumulators over disjoint sets of values can be merged (Chan et al.,
+   * 1979), which allows to accumulate in parallel. Unlike summing up
+   * @f$x@f$ and @f$x^2@f$, this does not suffer from cancellation when the
+   * variance is small compared to the mean.
+   */
+  class RunningStatistics {
+    public:
+      //! @brief adds the value \c x
+      void add(const double x);
+
+      //! @brief adds all values accumulated by \c other
+      void merge(const RunningStatistics & other);
+
+      //! @brief the number of values added
+      unsigned long long count() const;
+
+      //! @brief the mean of the values added, 0 if there are none
+      double mean() const;
+
+      //! @brief the unbiased sample variance of the values added, 0 if there are less than two
+      double variance() const;
+
+      //! @brief the standard error of the mean, i.e. @f$\sqrt{\mathrm{variance} / \mathrm{count}}@f$
+      double standardError() const;
+
+    private:
+      unsigned long long n  = 0;
+      double             mu = 0.0;
+      double             m2 = 0.0;                                              // sum of squared deviations from mu
+  };
+
+  /**
+   * @brief the parameters of monteCarlo(). Fields that are not given keep
+   *  their default values:
+   *
+   * @code
+   * auto result = BCG::monteCarlo(sample, {.maxSamples = 100000000, .targetError = 1e-4});
+   * @endcode
+   */
+  struct MonteCarloSettings {
+    //! @brief the sample budget
+    unsigned long long maxSamples   = 1000000;
+
+    //! @brief stop as soon as the standard error drops to this value. 0 disables early stopping.
+    double             targetError  = 0.0;
+
+    //! @brief do not stop early before this many samples have been taken
+    unsigned long long minSamples   = 1000;
+
+    //! @brief the number of samples per work item, each drawn from its own stream
+    unsigned long long chunkSize    = 65536;
+
+    //! @brief work item @f$i@f$ draws from get_PRNG_stream(streamOffset + i)
+    unsigned long long streamOffset = 0;
+
+    //! @brief the number of threads to use. 0 means \c BCG::nThreads.
+    unsigned int       threads      = 0;
+
+    //! @brief report the progress with updateProgressBar()
+    bool               showProgress = false;
+  };
+
+  //! @brief the outcome of monteCarlo()
+  struct MonteCarloResult {
+    unsigned long long samples       = 0;                                       //!< the number of samples taken into account
+    double             mean          = 0.0;                                     //!< the estimate
+    double             variance      = 0.0;                                     //!< the sample variance of the individual samples
+    double             standardError = 0.0;                                     //!< the standard error of the estimate
+    bool               converged     = false;                                   //!< whether the target error was reached
+  };
+
+  // ------------------------------------------------------------------------ //
+  // procs
+
+  /**
+   * @brief estimates the expectation value of \c sample on all cores.
+   *
+   * The sample budget is split into chunks of \c settings.chunkSize samples,
+   * which are handed out to the threads by parallel_for(). Chunk @f$i@f$ draws
+   * from its own engine <tt>get_PRNG_stream(settings.streamOffset + i)</tt>
+   * and accumulates into its own RunningStatistics, so the threads share
+   * neither engines nor accumulators.
+   *
+   * The chunk results are merged strictly in chunk order, and the target
+   * error is checked after each merged chunk. Chunks finished out of order
+   * wait until their predecessors are done; chunks beyond the point where the
+   * target error was reached are discarded. Hence, for a given
+   * \c BCG::seedRNG, the result is bit-identical for any number of threads.
+   *
+   * If \c settings.showProgress is set, only the calling thread writes the
+   * progress bar, whenever it has finished a chunk. The other threads never
+   * touch the console.
+   *
+   * \b Example:
+   * @code
+   * // pi by hit or miss
+   * auto result = BCG::monteCarlo([] (std::mt19937 & engine) {
+   *   const double x = BCG::get_randPercentage(engine);
+   *   const double y = BCG::get_randPercentage(engine);
+   *   return 4.0 * (x * x + y * y < 1.0);
+   * }, {.maxSamples = 100000000, .targetError = 1e-4});
+   * @endcode
+   *
+   * @param sample a callable, taking a <tt>std::mt19937 &</tt> and returning a
+   *  value convertible to \c double. It is invoked concurrently from several
+   *  threads, each with its own engine. Use get_randPercentage(Engine &) and
+   *  related functions to draw from the engine.
+   * @param settings the sample budget, target error and further parameters
+   *
+   * @throws std::invalid_argument if \c settings.chunkSize is zero or
+   *  \c settings.targetError is negative. Exceptions thrown by \c sample are
+   *  propagated to the caller.
+   */
+  template<class Sampler>
+  MonteCarloResult monteCarlo(Sampler && sample, const MonteCarloSettings & settings = {});
+
+  //! @}
+}
+
+// ========================================================================== //
+// template implementations
+
+#include "BCG/MonteCarlo.tpp"
+
+#endif
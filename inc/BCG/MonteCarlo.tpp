@@ -0,0 +1,118 @@
+// ========================================================================== //
+// local macro
+
+#define THROWTEXT(msg) (std::string("RUNTIME EXCEPTION IN ") + (__PRETTY_FUNCTION__) + "\n" + msg)
+
+// ========================================================================== //
+// enums and structs
+
+inline void BCG::RunningStatistics::add(const double x) {
+  ++n;
+  const double delta = x - mu;
+  mu += delta / n;
+  m2 += delta * (x - mu);
+}
+// .......................................................................... //
+inline void BCG::RunningStatistics::merge(const RunningStatistics & other) {
+  if (other.n == 0) {return;}
+  if (n == 0) {*this = other; return;}
+
+  const double nA    = n;
+  const double nB    = other.n;
+  const double delta = other.mu - mu;
+
+  n  += other.n;
+  mu += delta * nB / n;
+  m2 += other.m2 + delta * delta * nA * nB / n;
+}
+// .......................................................................... //
+inline unsigned long long BCG::RunningStatistics::count() const {return n;}
+inline double BCG::RunningStatistics::mean() const {return mu;}
+inline double BCG::RunningStatistics::variance() const {return (n < 2) ? 0.0 : m2 / (n - 1);}
+inline double BCG::RunningStatistics::standardError() const {return (n < 2) ? 0.0 : std::sqrt(variance() / n);}
+
+// ========================================================================== //
+// procs
+
+template<class Sampler>
+BCG::MonteCarloResult BCG::monteCarlo(Sampler && sample, const MonteCarloSettings & settings) {
+  if (settings.chunkSize == 0) {
+    throw std::invalid_argument(THROWTEXT("    parameter 'chunkSize' must be positive!"));
+  }
+  if (settings.targetError < 0) {
+    throw std::invalid_argument(THROWTEXT("    parameter 'targetError' must not be negative!"));
+  }
+
+  const size_t nChunks = settings.maxSamples / settings.chunkSize + (settings.maxSamples % settings.chunkSize != 0);
+
+  std::vector<RunningStatistics> chunkStatistics(nChunks);
+  std::vector<char>              finished       (nChunks, false);
+
+  RunningStatistics  total;
+  size_t             nMerged   = 0;
+  bool               converged = false;
+  std::atomic<bool>  stop      = false;
+  std::mutex         lock;
+
+  const auto caller      = std::this_thread::get_id();
+  double     lastShown   = -1.0;
+
+  if (settings.showProgress) {updateProgressBar(0.0);}
+
+  parallel_for(nChunks, [&] (const size_t chunk) {
+    if (stop) {return;}
+
+    auto engine = get_PRNG_stream(settings.streamOffset + chunk);
+
+    RunningStatistics statistics;
+    const unsigned long long size = std::min(settings.chunkSize, settings.maxSamples - chunk * settings.chunkSize);
+    for (unsigned long long i = 0; i < size; ++i) {statistics.add(sample(engine));}
+
+    double progress;
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      chunkStatistics[chunk] = statistics;
+      finished       [chunk] = true;
+
+      // merge the finished prefix in chunk order
+      while (!converged && nMerged < nChunks && finished[nMerged]) {
+        total.merge(chunkStatistics[nMerged]);
+        ++nMerged;
+
+        if (settings.targetError > 0 &&
+            total.count() >= settings.minSamples &&
+            total.standardError() <= settings.targetError
+        ) {
+          converged = true;
+          stop      = true;
+        }
+      }
+
+      progress = static_cast<double>(total.count()) / settings.maxSamples;
+    }
+
+    // only redraw if at least one more block of the bar is filled
+    if (settings.showProgress && std::this_thread::get_id() == caller && progress - lastShown >= 1.0 / 80) {
+      updateProgressBar(std::min(progress, 1.0));
+      lastShown = progress;
+    }
+  }, settings.threads);
+
+  if (settings.showProgress) {
+    updateProgressBar(1.0);
+    std::cout << std::endl;
+  }
+
+  MonteCarloResult reVal;
+  reVal.samples       = total.count();
+  reVal.mean          = total.mean();
+  reVal.variance      = total.variance();
+  reVal.standardError = total.standardError();
+  reVal.converged     = converged;
+
+  return reVal;
+}
+
+// ========================================================================== //
+
+#undef THROWTEXT
@@ -0,0 +1,143 @@
+/**
+ * @defgroup BCG_Parallel BCG Parallel Execution Module
+ *
+ * @brief minimal helpers to spread work over all cores with std::thread
+ */
+
+#ifndef BCG_PARALLEL_HPP
+#define BCG_PARALLEL_HPP
+
+// ========================================================================= //
+// dependencies
+
+#include <stdexcept>
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <algorithm>
+
+// ========================================================================== //
+
+namespace BCG {
+  //! @addtogroup BCG_Parallel
+  //! @{
+
+  // ------------------------------------------------------------------------ //
+  // globals
+
+  /**
+   * @brief the number of threads used by the parallel functions of BCG by
+   *  default.
+   *
+   * This is 1 until init() sets it to
+   * <tt>std::max(std::thread::hardware_concurrency(), 1u)</tt>; setting it
+   * back to 1 afterwards disables multithreading globally.
+   */
+  extern unsigned int nThreads;
+
+  // ------------------------------------------------------------------------ //
+  // enums and structs
+
+  //! @brief how parallel_reduce() splits and merges its range
+  enum class ReductionMode {
+    /**
+     * one chunk per thread, merged in order. The rounding depends on the
+     * number of threads.
+     */
+    Fast,
+    /**
+     * blocks of \c reductionBlockSize items, merged as a balanced binary
+     * tree. The result is bit-identical for any number of threads.
+     */
+    Reproducible
+  };
+
+  //! @brief the block size of ReductionMode::Reproducible
+  constexpr size_t reductionBlockSize = 65536;
+
+  // ------------------------------------------------------------------------ //
+  // procs
+
+  /**
+   * @brief calls <tt>body(i)</tt> for all @f$i = 0 \ldots N-1@f$, distributed
+   *  over \c threads threads.
+   *
+   * Indices are handed out one by one in ascending order to whichever thread
+   * becomes idle first, so work items of varying cost are balanced
+   * automatically. Hence, each index should stand for a chunk of work that is
+   * large compared to the cost of starting a thread. The calling thread takes
+   * part in the work, i.e. <tt>threads - 1</tt> threads are spawned.
+   *
+   * If \c body throws, no further indices are handed out, the remaining
+   * threads finish their current work item, and the first exception is
+   * rethrown on the calling thread.
+   *
+   * \b Example:
+   * @code
+   * std::vector<double> partialSums(nChunks);
+   * BCG::parallel_for(nChunks, [&] (size_t chunk) {
+   *   partialSums[chunk] = sumOfChunk(chunk);
+   * });
+   * @endcode
+   *
+   * @param N the number of work items
+   * @param body a callable accepting a \c size_t, which must be safe to invoke
+   *  concurrently for different indices
+   * @param threads the number of threads to use. 0 means \c BCG::nThreads.
+   */
+  template<class Body>
+  void parallel_for(const size_t N, Body && body, unsigned int threads = 0);
+
+  /**
+   * @brief reduces the index range @f$0 \ldots N-1@f$ in parallel
+   *
+   * The range is split into subranges, each of which is reduced to a value
+   * of type \c T by <tt>reduceRange(first, last)</tt>, where \c last is
+   * exclusive. The partial results are then merged with
+   * <tt>combine(lhs, rhs)</tt>, always keeping lhs left of rhs.
+   *
+   * With ReductionMode::Reproducible, the subranges are blocks of
+   * \c reductionBlockSize indices, no matter how many threads there are, and
+   * the partial results are merged pairwise as a balanced binary tree. Hence
+   * the result is bit-identical for any number of threads, even if
+   * \c combine is not associative, such as floating point addition. With
+   * ReductionMode::Fast, there is one subrange per thread, merged from left
+   * to right.
+   *
+   * \b Example:
+   * @code
+   * const double sum = BCG::parallel_reduce(x.size(), 0.0,
+   *   [&] (size_t first, size_t last) {return std::accumulate(x.begin() + first, x.begin() + last, 0.0);},
+   *   std::plus<>()
+   * );
+   * @endcode
+   *
+   * @param N the number of indices
+   * @param identity the result for \c N = 0
+   * @param reduceRange a callable taking two \c size_t and returning a value
+   *  convertible to \c T. It must be safe to invoke concurrently.
+   * @param combine a callable taking two \c T and returning a \c T
+   * @param mode see ReductionMode
+   * @param threads the number of threads to use. 0 means \c BCG::nThreads.
+   */
+  template<class T, class ReduceRange, class Combine>
+  T parallel_reduce(const size_t N, const T & identity,
+                    ReduceRange && reduceRange,
+                    Combine && combine,
+                    const ReductionMode mode = ReductionMode::Reproducible,
+                    unsigned int threads = 0
+                   );
+
+  //! @}
+}
+
+// ========================================================================== //
+// template implementations
+
+#include "BCG/Parallel.tpp"
+
+#endif
@@ -0,0 +1,81 @@
+// ========================================================================== //
+// local macro
+
+#define THROWTEXT(msg) (std::string("RUNTIME EXCEPTION IN ") + (__PRETTY_FUNCTION__) + "\n" + msg)
+
+// ========================================================================== //
+// procs
+
+template<class Body>
+void BCG::parallel_for(const size_t N, Body && body, unsigned int threads) {
+  if (threads == 0) {threads = std::max(nThreads, 1u);}
+  threads = std::min<size_t>(threads, N);
+
+  if (threads <= 1) {
+    for (size_t i = 0; i < N; ++i) {body(i);}
+    return;
+  }
+
+  std::atomic<size_t> next   = 0;
+  std::atomic<bool>   failed = false;
+  std::exception_ptr  error;
+  std::mutex          errorLock;
+
+  auto worker = [&] () {
+    while (!failed) {
+      const size_t i = next++;
+      if (i >= N) {return;}
+
+      try {
+        body(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(errorLock);
+        if (!error) {error = std::current_exception();}
+        failed = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned int t = 1; t < threads; ++t) {pool.emplace_back(worker);}
+  worker();
+  for (auto & thread : pool) {thread.join();}
+
+  if (error) {std::rethrow_exception(error);}
+}
+
+// .......................................................................... //
+template<class T, class ReduceRange, class Combine>
+T BCG::parallel_reduce(const size_t N, const T & identity,
+                       ReduceRange && reduceRange,
+                       Combine && combine,
+                       const ReductionMode mode,
+                       unsigned int threads
+) {
+  if (N == 0) {return identity;}
+  if (threads == 0) {threads = std::max(nThreads, 1u);}
+
+  const size_t blockSize = (mode == ReductionMode::Reproducible) ? reductionBlockSize : (N + threads - 1) / threads;
+  const size_t nBlocks   = (N + blockSize - 1) / blockSize;
+
+  std::vector<T> partials(nBlocks, identity);
+  parallel_for(nBlocks, [&] (const size_t block) {
+    const size_t first = block * blockSize;
+    partials[block] = reduceRange(first, std::min(first + blockSize, N));
+  }, threads);
+
+  if (mode == ReductionMode::Reproducible) {
+    for (size_t stride = 1; stride < nBlocks; stride *= 2) {
+      for (size_t i = 0; i + stride < nBlocks; i += 2 * stride) {partials[i] = combine(partials[i], partials[i + stride]);}
+    }
+    return partials[0];
+  }
+
+  T reVal = partials[0];
+  for (size_t i = 1; i < nBlocks; ++i) {reVal = combine(reVal, partials[i]);}
+  return reVal;
+}
+
+// ========================================================================== //
+
+#undef THROWTEXT
@@ -13,6 +13,17 @@
 #include <stdexcept>
 
 #include <random>
+#include <complex>
+#include <array>
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <cmath>
+#include <iterator>
+#include <algorithm>
+#include <unordered_set>
+#include <memory>
+#include <bit>
 
 // ========================================================================== //
 
@@ -20,6 +31,393 @@ namespace BCG {
   //! @addtogroup BCG_Random
   //! @{
 
+  // ------------------------------------------------------------------------ //
+  // engines
+
+  /**
+   * @brief counter based pseudorandom number generator, implementing the
+   *  Philox4x32-10 algorithm (Salmon et al., "Parallel Random Numbers: As Easy
+   *  as 1, 2, 3", SC11).
+   *
+   * Unlike \c std::mt19937, this engine has no evolving state: the output with
+   * index @f$i@f$ is a pure function of the seed and @f$i@f$. Hence it can
+   * jump to any position of its sequence in @f$O(1)@f$, which allows to
+   * partition a simulation into chunks that are processed on different cores
+   * or nodes while producing the bit-identical output of a serial run.
+   *
+   * The class satisfies the requirements of a UniformRandomBitGenerator and
+   * can be used with all STL distributions. Its state is only 32 bytes large.
+   *
+   * \b Example:
+   * @code
+   * BCG::Philox4x32 engine(BCG::seedRNG);
+   * engine.set_counter(1000000);  // skip the first million outputs
+   * auto x = engine();            // same as engine.at(1000000)
+   * @endcode
+   */
+  class Philox4x32 {
+    public:
+      typedef uint32_t result_type;
+
+      //! @brief the smallest value returned by operator()()
+      static constexpr result_type min() {return 0u;}
+      //! @brief the biggest value returned by operator()()
+      static constexpr result_type max() {return UINT32_MAX;}
+
+      //! @brief creates an engine with the given seed, starting at counter 0
+      Philox4x32(const unsigned long long seed = 0);
+
+      //! @brief reseeds the engine and resets the counter to 0
+      void seed(const unsigned long long seed = 0);
+
+      //! @brief returns the next 32 random bits and increments the counter
+      result_type operator()();
+
+      //! @brief skips the next \c n outputs in @f$O(1)@f$
+      void discard(const unsigned long long n);
+
+      //! @brief returns the index of the next output of operator()()
+      unsigned long long get_counter() const;
+
+      //! @brief makes the output with index \c index the next output of operator()()
+      void set_counter(const unsigned long long index);
+
+      /**
+       * @brief returns the output with index \c index without altering the
+       *  state of the engine
+       */
+      result_type at(const unsigned long long index) const;
+
+      //! @brief returns the 64 bit key derived from the seed
+      std::array<uint32_t, 2> get_key() const;
+
+      /**
+       * @brief the raw Philox4x32-10 bijection: encrypts a 128 bit counter
+       *  with a 64 bit key.
+       *
+       * Each block yields four consecutive outputs of the engine, i.e. the
+       * output with index @f$i@f$ is element <tt>i % 4</tt> of the block with
+       * counter <tt>i / 4</tt>.
+       */
+      static std::array<uint32_t, 4> block(const std::array<uint32_t, 4> & counter,
+                                           const std::array<uint32_t, 2> & key);
+
+    private:
+      std::array<uint32_t, 2> key;
+      std::array<uint32_t, 4> buffer;
+      unsigned long long      counter;
+
+      void refill();
+  };
+
+  // ------------------------------------------------------------------------ //
+  // discrete distributions
+
+  /**
+   * @brief discrete distribution over the indices @f$0 \ldots n-1@f$ with
+   *  arbitrary weights, sampled in @f$O(1)@f$ by Walker's alias method.
+   *
+   * The table is built once in @f$O(n)@f$ with Vose's algorithm. Each draw
+   * then picks a column uniformly and returns either the column index or its
+   * alias, which avoids the linear or binary search through a cumulative
+   * distribution function.
+   *
+   * Column and coin flip are taken from a single 64 bit draw: the integer part
+   * of @f$u \cdot n@f$ selects the column, its fractional part acts as the
+   * coin. For @f$n = 10^6@f$ this leaves 33 bits of resolution for the coin.
+   *
+   * \b Example:
+   * @code
+   * BCG::AliasTable table({1.0, 2.0, 3.0, 4.0});
+   * auto i = table();             // 3 with probability 0.4
+   * auto j = table(BCG::CBRNG);   // same, with a different engine
+   * @endcode
+   */
+  class AliasTable {
+    public:
+      //! @brief creates an empty table. Drawing from an empty table is undefined.
+      AliasTable() = default;
+
+      /**
+       * @brief builds the table from non-negative weights, which need not be
+       *  normalized.
+       *
+       * @throws std::invalid_argument if \c weights is empty, has more than
+       *  @f$2^{32}@f$ elements, contains a negative or non-finite value or
+       *  sums up to zero.
+       */
+      AliasTable(const std::vector<double> & weights);
+
+      //! @brief builds the table from a list of weights
+      AliasTable(std::initializer_list<double> weights);
+
+      //! @brief builds the table from the weights in any STL container
+      template<class Iterator>
+      AliasTable(Iterator begin, Iterator end);
+
+      //! @brief the number of categories
+      size_t size() const;
+
+      //! @brief the normalized probability of category \c i
+      double probability(const size_t i) const;
+
+      //! @brief draws a category index, using \c BCG::PRNG
+      size_t operator()() const;
+
+      //! @brief draws a category index, using an arbitrary engine
+      template<class Engine>
+      size_t operator()(Engine & engine) const;
+
+    private:
+      std::vector<double>   threshold;
+      std::vector<uint32_t> alias;
+      std::vector<double>   probabilities;
+  };
+
+  // ------------------------------------------------------------------------ //
+  // sampling
+
+  /**
+   * @brief draws a uniform random sample of \c k items from a stream of
+   *  unknown length, keeping only the sample in memory.
+   *
+   * This implements Algorithm L (Li, 1994): once the reservoir is full, the
+   * number of items to skip until the next replacement is drawn directly from
+   * its geometric-like distribution. Hence, only @f$O(k \log(n/k))@f$ random
+   * numbers are drawn for a stream of @f$n@f$ items, and with random access
+   * iterators, the skipped items are not even read.
+   *
+   * The engine is <tt>get_PRNG_stream(streamID)</tt>, so the sample is
+   * reproducible from \c BCG::seedRNG.
+   *
+   * \b Example:
+   * @code
+   * BCG::ReservoirSampler<std::string> sampler(10);
+   * for (std::string line; std::getline(file, line); ) {sampler.add(line);}
+   * auto & lines = sampler.sample();   // 10 lines, or all of them if fewer
+   * @endcode
+   */
+  template<class T>
+  class ReservoirSampler {
+    public:
+      /**
+       * @brief creates an empty reservoir of size \c k, drawing from stream
+       *  \c streamID
+       *
+       * @throws std::invalid_argument if \c k is zero.
+       */
+      ReservoirSampler(const size_t k, const unsigned long long streamID = 0);
+
+      //! @brief offers the next item of the stream
+      void add(const T & item);
+
+      //! @brief offers all items in <tt>[first, last)</tt>, skipping over the ones not taken
+      template<class InputIt>
+      void add(InputIt first, InputIt last);
+
+      //! @brief the current sample, in no particular order
+      const std::vector<T> & sample() const;
+
+      //! @brief the number of items offered so far
+      unsigned long long count() const;
+
+    private:
+      size_t             k;
+      std::vector<T>     reservoir;
+      unsigned long long seen = 0;
+      unsigned long long next = 0;                                              // index of the next item to be taken
+      double             W    = 1.0;
+      std::mt19937       engine;
+
+      void scheduleNext();
+  };
+
+  // ------------------------------------------------------------------------ //
+  // low discrepancy sequences
+
+  /**
+   * @brief quasi-random points in the unit hypercube @f$[0, 1)^d@f$ after
+   *  Sobol, generated in Gray code order (Antonov and Saleev).
+   *
+   * Sobol points fill the unit hypercube far more evenly than pseudorandom
+   * points. Monte Carlo integrals of smooth integrands hence converge roughly
+   * as @f$1/N@f$ rather than @f$1/\sqrt{N}@f$.
+   *
+   * Dimension @f$j > 0@f$ uses the @f$j@f$-th primitive polynomial over GF(2),
+   * ordered by degree. The polynomials are found at runtime, so any number of
+   * dimensions is supported. The initial direction numbers are odd numbers
+   * drawn from a fixed pseudorandom sequence, not the optimized tables of Joe
+   * and Kuo. They are the same on every run and for every number of
+   * dimensions, i.e. the first @f$d@f$ coordinates of a
+   * @f$d'@f$-dimensional sequence equal the @f$d@f$-dimensional sequence.
+   *
+   * Scrambled sequences apply a random lower triangular matrix and a random
+   * digital shift to each dimension (Matousek, 1998). This keeps the
+   * low discrepancy, but makes each point uniformly distributed, so
+   * independent scramblings yield unbiased estimates with error bars. It also
+   * removes the point at the origin.
+   *
+   * Points have 32 bits of resolution, and at most @f$2^{32}@f$ points can be
+   * drawn.
+   *
+   * \b Example:
+   * @code
+   * BCG::SobolSequence sobol(3, BCG::seedRNG);
+   * sobol.set_index(1000);  // skip the first thousand points
+   * auto x = sobol();       // std::vector<double> with 3 elements
+   * @endcode
+   */
+  class SobolSequence {
+    public:
+      //! @brief the maximum number of points that can be drawn
+      static constexpr unsigned long long max_index = 1ull << 32u;
+
+      /**
+       * @brief creates an unscrambled sequence with \c dimensions coordinates
+       *  per point. The first point is the origin.
+       *
+       * @throws std::invalid_argument if \c dimensions is zero.
+       */
+      SobolSequence(const size_t dimensions);
+
+      /**
+       * @brief creates a sequence, scrambled with the random numbers derived
+       *  from \c scrambleSeed.
+       *
+       * @throws std::invalid_argument if \c dimensions is zero.
+       */
+      SobolSequence(const size_t dimensions, const unsigned long long scrambleSeed);
+
+      //! @brief the number of coordinates per point
+      size_t dimensions() const;
+
+      //! @brief returns the next point
+      std::vector<double> operator()();
+
+      /**
+       * @brief writes the next <tt>out.size() / dimensions()</tt> points into
+       *  \c out, one after the other.
+       *
+       * @throws std::invalid_argument if the size of \c out is not a multiple
+       *  of dimensions().
+       * @throws std::out_of_range if this exceeds max_index points.
+       */
+      void fill(std::span<double> out);
+
+      //! @brief skips the next \c n points. Same as <tt>set_index(get_index() + n)</tt>.
+      void discard(const unsigned long long n);
+
+      //! @brief returns the index of the next point
+      unsigned long long get_index() const;
+
+      /**
+       * @brief makes the point with index \c index the next point, in
+       *  @f$O(d \log(\mathrm{index}))@f$.
+       *
+       * This allows to partition a quasi Monte Carlo integration into
+       * contiguous blocks of points, which are processed in parallel.
+       *
+       * @throws std::out_of_range if \c index exceeds max_index.
+       */
+      void set_index(const unsigned long long index);
+
+    private:
+      size_t                dims;
+      unsigned long long    index = 0;
+      std::vector<uint32_t> directions;   // 32 direction numbers for each dimension, bit major
+      std::vector<uint32_t> shift;        // digital shift, zero if unscrambled
+      std::vector<uint32_t> state;        // next point, as integers
+
+      void advance();
+  };
+
+  /**
+   * @brief quasi-random points in the unit hypercube @f$[0, 1)^d@f$ after
+   *  Halton.
+   *
+   * Coordinate @f$j@f$ of the point with index @f$i@f$ is the radical inverse
+   * of @f$i@f$ in the base @f$b_j@f$, the @f$j@f$-th prime: the digits of
+   * @f$i@f$ are mirrored at the decimal point,
+   * @f[
+   *  i = \sum_k a_k b_j^k \quad\rightarrow\quad
+   *  x_j = \sum_k \pi_j(a_k) b_j^{-k-1}
+   * @f]
+   * where @f$\pi_j@f$ is the identity for the unscrambled sequence.
+   *
+   * In high dimensions, the large bases of the unscrambled sequence cause
+   * strong correlations between neighbouring coordinates. Scrambled sequences
+   * use a random permutation @f$\pi_j@f$ of the digits @f$1 \ldots b_j - 1@f$
+   * for each dimension, keeping 0 fixed, which breaks these correlations.
+   * For more than some ten dimensions, use a scrambled sequence or
+   * SobolSequence.
+   *
+   * Successive points are generated by incrementing the digits, rather than
+   * re-evaluating the sum above. The result is bit-identical to set_index().
+   */
+  class HaltonSequence {
+    public:
+      /**
+       * @brief creates an unscrambled sequence with \c dimensions coordinates
+       *  per point. The first point is the origin.
+       *
+       * @throws std::invalid_argument if \c dimensions is zero.
+       */
+      HaltonSequence(const size_t dimensions);
+
+      /**
+       * @brief creates a sequence, scrambled with the random digit
+       *  permutations derived from \c scrambleSeed.
+       *
+       * @throws std::invalid_argument if \c dimensions is zero.
+       */
+      HaltonSequence(const size_t dimensions, const unsigned long long scrambleSeed);
+
+      //! @brief the number of coordinates per point
+      size_t dimensions() const;
+
+      //! @brief the prime base of dimension \c dimension
+      uint32_t base(const size_t dimension) const;
+
+      //! @brief returns the next point
+      std::vector<double> operator()();
+
+      /**
+       * @brief writes the next <tt>out.size() / dimensions()</tt> points into
+       *  \c out, one after the other.
+       *
+       * @throws std::invalid_argument if the size of \c out is not a multiple
+       *  of dimensions().
+       */
+      void fill(std::span<double> out);
+
+      //! @brief skips the next \c n points. Same as <tt>set_index(get_index() + n)</tt>.
+      void discard(const unsigned long long n);
+
+      //! @brief returns the index of the next point
+      unsigned long long get_index() const;
+
+      //! @brief makes the point with index \c index the next point, in @f$O(d \log(\mathrm{index}))@f$.
+      void set_index(const unsigned long long index);
+
+    private:
+      struct Dimension {
+        uint32_t base;
+        size_t   nDigits;
+        size_t   offset;                  // into digits, scales and partialSums
+        size_t   permutationOffset;       // into permutations
+      };
+
+      std::vector<Dimension> dims;
+      unsigned long long     index = 0;
+      std::vector<uint32_t>  permutations;
+      std::vector<uint32_t>  digits;
+      std::vector<double>    scales;      // b^-(k+1)
+      std::vector<double>    partialSums; // sum over the digits k and higher, plus one zero per dimension
+
+      void init(const size_t dimensions, const unsigned long long * scrambleSeed);
+      void advance();
+  };
+
   // ------------------------------------------------------------------------ //
   // globals
 
@@ -69,6 +467,42 @@ namespace BCG {
    */
   extern std::uniform_real_distribution<> rand_percentage_distribution;
 
+  /**
+   * @brief per-thread instance of a MT19937 pseudorandom number generator.
+   *  Needs to be initialized in each thread by calling reset_threadPRNG().
+   *
+   * Invoke this by calling \c BCG::threadPRNG().
+   *
+   * Each thread owns its own instance of this engine, so worker threads can
+   * draw random numbers without locking and without touching the memory of
+   * other workers. Until reset_threadPRNG() is called, all threads share the
+   * default seed of \c std::mt19937 and hence produce the same sequence.
+   */
+  extern thread_local std::mt19937 threadPRNG;
+
+  /**
+   * @brief uniform deterministic integer pseudorandom number generator with
+   *  counter based Philox4x32-10 implementation. Needs to be initialized by
+   *  calling init() or calling reset_CBRNG() with a good seed.
+   *
+   * Invoke this by calling \c BCG::CBRNG().
+   *
+   * Use this instead of \c BCG::PRNG when parts of the random sequence need to
+   * be reproduced out of order, e.g. via <tt>CBRNG.set_counter(N)</tt>.
+   */
+  extern Philox4x32 CBRNG;
+
+  /**
+   * @brief the layer boundaries @f$x_i@f$ of the 256 layer ziggurat used by
+   *  get_randNormal(), with @f$x_1 = r@f$ the start of the tail and
+   *  @f$x_{256} = 0@f$. @f$x_0@f$ is the width of a rectangle with the area of
+   *  the base layer.
+   */
+  extern const std::array<double, 257> ziggurat_x;
+
+  //! @brief the values @f$e^{-x_i^2/2}@f$ for the layer boundaries ziggurat_x
+  extern const std::array<double, 257> ziggurat_f;
+
   // ------------------------------------------------------------------------ //
   // procs
 
@@ -77,6 +511,14 @@ namespace BCG {
    */
   static inline void reset_PRNG(const long long seed = 0);
 
+  /**
+   * @brief resets \c BCG::CBRNG with a new seed and rewinds it to counter 0.
+   *
+   * Unlike reset_PRNG(), this does not alter \c BCG::seedRNG. init() seeds
+   * \c BCG::CBRNG with \c BCG::seedRNG.
+   */
+  static inline void reset_CBRNG(const unsigned long long seed = 0);
+
   /**
    * @brief return a random \c double between 0 and @f$2\pi@f$ with uniform
    *  distribution. Needs to be initialized by calling init() or manually
@@ -91,6 +533,309 @@ namespace BCG {
    */
   static inline double get_randPercentage();
 
+  /**
+   * @brief return a random \c double with standard normal distribution, i.e.
+   *  with mean 0 and variance 1. Needs to be initialized by calling init() or
+   *  calling reset_PRNG() with a good seed.
+   *
+   * This uses the Ziggurat method by Marsaglia and Tsang with 256 layers,
+   * drawing from \c BCG::PRNG. About 99% of the samples cost a single 64 bit
+   * draw, a multiplication and a comparison; neither logarithms nor
+   * trigonometric functions are evaluated, unlike in the Box-Muller path of
+   * \c std::normal_distribution.
+   *
+   * For a normal distribution with mean @f$\mu@f$ and standard deviation
+   * @f$\sigma@f$, use <tt>mu + sigma * get_randNormal()</tt>.
+   */
+  static inline double get_randNormal();
+
+  /**
+   * @brief return a random \c double with standard normal distribution,
+   *  drawn from an arbitrary engine. See get_randNormal() for details.
+   */
+  template<class Engine>
+  double get_randNormal(Engine & engine);
+
+  /**
+   * @brief return 64 uniformly distributed random bits from an arbitrary
+   *  engine.
+   *
+   * Engines with 64 or 32 bits per output, such as \c std::mt19937_64,
+   * \c std::mt19937 or \c BCG::Philox4x32, are invoked once or twice,
+   * respectively. All other engines are adapted via
+   * \c std::uniform_int_distribution.
+   */
+  template<class Engine>
+  uint64_t get_randBits64(Engine & engine);
+
+  /**
+   * @brief return a uniformly distributed random integer between 0 and
+   *  <tt>n - 1</tt> from an arbitrary engine.
+   *
+   * Unlike \c std::uniform_int_distribution, the result is the same with
+   * every STL implementation. For @f$n \le 2^{32}@f$, this uses a single
+   * 32 bit draw in almost all cases (Lemire, "Fast Random Integer Generation
+   * in an Interval", 2019).
+   *
+   * @throws std::invalid_argument if \c n is zero.
+   */
+  template<class Engine>
+  uint64_t get_randIndex(const uint64_t n, Engine & engine);
+
+  /**
+   * @brief distributes \c n trials over categories with the given weights and
+   *  returns the number of trials that fell into each category.
+   *
+   * The result follows a multinomial distribution. It is computed without
+   * performing \c n individual draws: if \c n exceeds the number of
+   * categories, category @f$i@f$ receives a binomially distributed count,
+   * conditioned on the trials and weights left after the categories
+   * @f$0 \ldots i-1@f$. This costs one binomial draw per category and stops
+   * as soon as all trials are distributed. Otherwise, \c n draws from an
+   * AliasTable are counted.
+   *
+   * @param n the number of trials
+   * @param weights the non-negative weights of the categories, which need not
+   *  be normalized
+   * @param engine the engine to draw from
+   *
+   * @throws std::invalid_argument under the same conditions as the
+   *  constructor of AliasTable
+   */
+  template<class Engine>
+  std::vector<unsigned long long> get_randMultinomial(const unsigned long long n,
+                                                      const std::vector<double> & weights,
+                                                      Engine & engine);
+
+  //! @brief same as get_randMultinomial(n, weights, engine), using \c BCG::PRNG
+  static inline std::vector<unsigned long long> get_randMultinomial(const unsigned long long n,
+                                                                    const std::vector<double> & weights);
+
+  // ........................................................................ //
+  // bulk generation
+
+  /**
+   * @brief fills \c out with random \c doubles between 0 and @f$2\pi@f$ with
+   *  uniform distribution, drawn from \c BCG::CBRNG.
+   *
+   * This is the bulk version of get_randPhase() and is several times faster
+   * than calling the latter in a loop: Philox blocks are computed in several
+   * lanes at once and the random bits are converted to \c doubles directly,
+   * with 52 bits of resolution. The kernel is compiled for AVX-512, AVX2 and
+   * generic CPUs, and the fastest version supported by the host is selected at
+   * runtime.
+   *
+   * The range is taken from \c rand_phase_distribution. Each generated value
+   * consumes two outputs of \c BCG::CBRNG, whose counter is advanced
+   * accordingly. Hence, the result only depends on the seed and counter of
+   * \c BCG::CBRNG, but not on how the output is split into calls.
+   *
+   * @param out the memory to fill
+   */
+  void fill_randPhase(std::span<double> out);
+
+  /**
+   * @brief fills \c out with random \c doubles between 0 and 1 with uniform
+   *  distribution, drawn from \c BCG::CBRNG.
+   *
+   * This is the bulk version of get_randPercentage(). The range is taken from
+   * \c rand_percentage_distribution. See fill_randPhase() for details.
+   *
+   * @param out the memory to fill
+   */
+  void fill_randPercentage(std::span<double> out);
+
+  /**
+   * @brief fills \c out with random unit phase factors
+   *  @f$e^{i\varphi}@f$, where @f$\varphi@f$ is uniformly distributed
+   *  between 0 and @f$2\pi@f$. The random bits are drawn from
+   *  \c BCG::CBRNG.
+   *
+   * This gives the same distribution as
+   * <tt>std::polar(1.0, get_randPhase())</tt>, but does not evaluate any
+   * trigonometric function: points @f$(x, y)@f$ are drawn uniformly from the
+   * unit disk by rejection from the enclosing square, and their angle is
+   * doubled via
+   * @f[
+   *  e^{i\varphi} = \frac{(x^2 - y^2) + 2ixy}{x^2 + y^2}
+   * @f]
+   * On average, @f$4/\pi@f$ candidate points are needed per value.
+   *
+   * Note that this ignores \c rand_phase_distribution.
+   *
+   * @param out the memory to fill
+   */
+  void fill_randPhaseFactor(std::span<std::complex<double>> out);
+
+  /**
+   * @brief fills \c re and \c im with the real and imaginary parts of random
+   *  unit phase factors. See fill_randPhaseFactor(std::span<std::complex<double>>)
+   *  for details.
+   *
+   * @throws std::invalid_argument if \c re and \c im differ in size.
+   */
+  void fill_randPhaseFactor(std::span<double> re, std::span<double> im);
+
+  /**
+   * @brief fills \c out with random \c doubles with standard normal
+   *  distribution, drawn from \c BCG::CBRNG.
+   *
+   * This is the bulk version of get_randNormal(). The random bits are
+   * generated by the bulk kernel also used in fill_randPercentage(), and the
+   * fast path of the Ziggurat method is evaluated for a whole batch of
+   * candidates at once. Only the rare candidates outside the fast path are
+   * handled one by one.
+   *
+   * @param out the memory to fill
+   */
+  void fill_randNormal(std::span<double> out);
+
+  /**
+   * @brief fills \c out with random \c doubles with standard normal
+   *  distribution, drawn from an arbitrary engine.
+   */
+  template<class Engine>
+  void fill_randNormal(std::span<double> out, Engine & engine);
+
+  // ........................................................................ //
+  // independent streams
+
+  /**
+   * @brief returns a MT19937 engine for the stream \c streamID, derived
+   *  deterministically from \c BCG::seedRNG.
+   *
+   * The engine is seeded through a \c std::seed_seq built from both
+   * \c BCG::seedRNG and \c streamID. Hence, for a given seed, the same stream
+   * ID always yields the same sequence, while different stream IDs yield
+   * statistically independent sequences. This allows to hand out streams per
+   * work item rather than per thread, which keeps parallel results
+   * reproducible regardless of the number of threads used.
+   *
+   * @param streamID the index of the stream to create
+   */
+  std::mt19937 get_PRNG_stream(const unsigned long long streamID);
+
+  /**
+   * @brief resets \c BCG::threadPRNG of the calling thread to the stream
+   *  \c streamID, as given by get_PRNG_stream().
+   */
+  static inline void reset_threadPRNG(const unsigned long long streamID);
+
+  /**
+   * @brief return a random \c double between 0 and @f$2\pi@f$ with uniform
+   *  distribution, drawn from an arbitrary engine such as \c BCG::threadPRNG.
+   *
+   * The range is taken from \c rand_phase_distribution, which is only read.
+   * Hence this can be invoked concurrently from several threads, as long as
+   * each of them uses its own engine.
+   */
+  template<class Engine>
+  double get_randPhase(Engine & engine);
+
+  /**
+   * @brief return a random \c double between 0 and 1 with uniform
+   *  distribution, drawn from an arbitrary engine such as \c BCG::threadPRNG.
+   *
+   * The same remarks as for get_randPhase(Engine &) apply.
+   */
+  template<class Engine>
+  double get_randPercentage(Engine & engine);
+
+  // ........................................................................ //
+  // jump ahead
+
+  /**
+   * @brief advances a MT19937 engine by \c n outputs in @f$O(\log n)@f$,
+   *  with the same effect as <tt>engine.discard(n)</tt>.
+   *
+   * The state transition of MT19937 is linear over GF(2). Advancing the state
+   * by @f$n@f$ steps is the same as applying the polynomial
+   * @f$x^n \bmod \varphi(x)@f$ to the transition matrix, where @f$\varphi@f$
+   * is the characteristic polynomial of degree 19937 (Haramoto et al.,
+   * "Efficient Jump Ahead for F2-Linear Random Number Generators", 2008).
+   * @f$\varphi@f$ is computed once by the Berlekamp-Massey algorithm and
+   * cached; each jump then takes @f$O(\log n)@f$ polynomial squarings modulo
+   * @f$\varphi@f$ and a Horner evaluation on the state.
+   *
+   * A jump costs about as much as discarding some @f$10^7@f$ values; smaller
+   * values of \c n are forwarded to \c discard(). The engine state is read
+   * and written through the stream operators of \c std::mt19937, hence the
+   * engine may be in any state, including partially consumed blocks.
+   *
+   * @param engine the engine to advance
+   * @param n the number of outputs to skip
+   */
+  void jump_mt19937(std::mt19937 & engine, const unsigned long long n);
+
+  //! @brief advances \c BCG::PRNG by \c n outputs. See jump_mt19937() for details.
+  static inline void jump_PRNG(const unsigned long long n);
+
+  /**
+   * @brief returns a MT19937 engine, positioned at the start of substream
+   *  \c index of the sequence of \c BCG::PRNG.
+   *
+   * The sequence produced by <tt>reset_PRNG(seedRNG)</tt> is split into
+   * non-overlapping substreams of \c length outputs each. Substream
+   * \c index starts at output <tt>index * length</tt>. Unlike
+   * get_PRNG_stream(), the substreams are all parts of one single sequence,
+   * so concatenating them reproduces a serial run.
+   *
+   * @throws std::overflow_error if <tt>index * length</tt> exceeds
+   *  @f$2^{64} - 1@f$
+   */
+  std::mt19937 get_PRNG_substream(const unsigned long long index, const unsigned long long length);
+
+  // ........................................................................ //
+  // shuffling and sampling
+
+  /**
+   * @brief randomly permutes the elements in <tt>[first, last)</tt> on
+   *  several threads.
+   *
+   * Each element is sent to one of @f$B@f$ buckets at random. The elements
+   * are then scattered into the buckets, and each bucket is shuffled on its
+   * own by the Fisher-Yates algorithm (Sanders, "Random Permutations on
+   * Distributed, External and Hierarchical Memory", 1998). This gives a
+   * uniformly random permutation. Unlike the random accesses of
+   * \c std::shuffle over the whole range, the scatter writes to only @f$B@f$
+   * places at a time, and each bucket fits into the cache.
+   *
+   * All three steps are distributed over the threads by parallel_for(). The
+   * number of buckets only depends on the size of the range. The random bits
+   * are drawn from the streams <tt>get_PRNG_stream(streamOffset + i)</tt>
+   * with @f$0 \le i < 2B@f$, where @f$B \le 1024@f$. Hence, the result is
+   * reproducible from \c BCG::seedRNG regardless of the number of threads.
+   *
+   * The elements need to be default constructible and move assignable, and
+   * a buffer of the size of the range is allocated.
+   *
+   * @param first, last the range to shuffle
+   * @param streamOffset the first stream to draw from
+   * @param threads the number of threads to use. 0 means \c BCG::nThreads.
+   */
+  template<class RandomIt>
+  void parallel_shuffle(RandomIt first, RandomIt last,
+                        const unsigned long long streamOffset = 0,
+                        const unsigned int threads = 0);
+
+  /**
+   * @brief returns \c k different indices out of @f$0 \ldots n-1@f$, each
+   *  subset being equally likely, in ascending order.
+   *
+   * For @f$k \le n/16@f$, Floyd's algorithm draws exactly \c k random numbers
+   * and stores the indices in a hash set. For larger \c k, the indices are
+   * selected in a single pass over @f$0 \ldots n-1@f$ with Vitter's
+   * Algorithm A, which draws one random number per selected index and needs
+   * no memory besides the result.
+   *
+   * @throws std::invalid_argument if \c k exceeds \c n.
+   */
+  template<class Engine>
+  std::vector<size_t> sample_indices(const size_t k, const size_t n, Engine & engine);
+
+  //! @brief same as sample_indices(k, n, engine), using \c BCG::PRNG
+  static inline std::vector<size_t> sample_indices(const size_t k, const size_t n);
+
   //! @}
 }
 
@@ -3,6 +3,192 @@
 
 #define THROWTEXT(msg) (std::string("RUNTIME EXCEPTION IN ") + (__PRETTY_FUNCTION__) + "\n" + msg)
 
+// ========================================================================== //
+// engines
+
+inline BCG::Philox4x32::Philox4x32(const unsigned long long seed) {this->seed(seed);}
+// .......................................................................... //
+inline void BCG::Philox4x32::seed(const unsigned long long seed) {
+  key     = {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32u)};
+  counter = 0u;
+}
+// .......................................................................... //
+inline BCG::Philox4x32::result_type BCG::Philox4x32::operator()() {
+  if ((counter & 3u) == 0u) {refill();}
+  return buffer[counter++ & 3u];
+}
+// .......................................................................... //
+inline void BCG::Philox4x32::discard(const unsigned long long n) {set_counter(counter + n);}
+// .......................................................................... //
+inline unsigned long long BCG::Philox4x32::get_counter() const {return counter;}
+// .......................................................................... //
+inline void BCG::Philox4x32::set_counter(const unsigned long long index) {
+  counter = index;
+
+  // operator() only refills the buffer at block boundaries
+  if (counter & 3u) {refill();}
+}
+// .......................................................................... //
+inline BCG::Philox4x32::result_type BCG::Philox4x32::at(const unsigned long long index) const {
+  const unsigned long long blockIdx = index >> 2u;
+  return block({static_cast<uint32_t>(blockIdx), static_cast<uint32_t>(blockIdx >> 32u), 0u, 0u}, key)[index & 3u];
+}
+// .......................................................................... //
+inline std::array<uint32_t, 2> BCG::Philox4x32::get_key() const {return key;}
+// .......................................................................... //
+inline void BCG::Philox4x32::refill() {
+  const unsigned long long blockIdx = counter >> 2u;
+  buffer = block({static_cast<uint32_t>(blockIdx), static_cast<uint32_t>(blockIdx >> 32u), 0u, 0u}, key);
+}
+// .......................................................................... //
+inline std::array<uint32_t, 4> BCG::Philox4x32::block(const std::array<uint32_t, 4> & counter,
+                                                      const std::array<uint32_t, 2> & key
+) {
+  constexpr uint64_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+  constexpr uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+  uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+  uint32_t k0 = key    [0], k1 = key    [1];
+
+  for (int round = 0; round < 10; ++round) {
+    const uint64_t p0 = M0 * c0;
+    const uint64_t p1 = M1 * c2;
+
+    c0 = static_cast<uint32_t>(p1 >> 32u) ^ c1 ^ k0;
+    c1 = static_cast<uint32_t>(p1       );
+    c2 = static_cast<uint32_t>(p0 >> 32u) ^ c3 ^ k1;
+    c3 = static_cast<uint32_t>(p0       );
+
+    k0 += W0;
+    k1 += W1;
+  }
+
+  return {c0, c1, c2, c3};
+}
+
+// -------------------------------------------------------------------------- //
+// discrete distributions
+
+inline BCG::AliasTable::AliasTable(std::initializer_list<double> weights) :
+  AliasTable(std::vector<double>(weights))
+{}
+// .......................................................................... //
+template<class Iterator>
+BCG::AliasTable::AliasTable(Iterator begin, Iterator end) :
+  AliasTable(std::vector<double>(begin, end))
+{}
+// .......................................................................... //
+inline size_t BCG::AliasTable::size() const {return threshold.size();}
+// .......................................................................... //
+inline double BCG::AliasTable::probability(const size_t i) const {return probabilities.at(i);}
+// .......................................................................... //
+inline size_t BCG::AliasTable::operator()() const {return (*this)(PRNG);}
+// .......................................................................... //
+template<class Engine>
+size_t BCG::AliasTable::operator()(Engine & engine) const {
+  const size_t N = threshold.size();
+  const double x = (get_randBits64(engine) >> 11) * 0x1.0p-53 * N;
+
+  // the product may round up to N
+  const size_t column = std::min(static_cast<size_t>(x), N - 1);
+  const double coin   = x - column;
+
+  return (coin < threshold[column]) ? column : alias[column];
+}
+
+// -------------------------------------------------------------------------- //
+// sampling
+
+template<class T>
+BCG::ReservoirSampler<T>::ReservoirSampler(const size_t k, const unsigned long long streamID) :
+  k     (k),
+  engine(get_PRNG_stream(streamID))
+{
+  if (k == 0) {
+    throw std::invalid_argument(THROWTEXT("    reservoir size must be positive!"));
+  }
+  reservoir.reserve(k);
+}
+// .......................................................................... //
+template<class T>
+void BCG::ReservoirSampler<T>::add(const T & item) {
+  if (seen < k) {
+    reservoir.push_back(item);
+    ++seen;
+    if (seen == k) {scheduleNext();}
+    return;
+  }
+
+  if (seen == next) {
+    reservoir[get_randIndex(k, engine)] = item;
+    ++seen;
+    scheduleNext();
+    return;
+  }
+
+  ++seen;
+}
+// .......................................................................... //
+template<class T>
+template<class InputIt>
+void BCG::ReservoirSampler<T>::add(InputIt first, InputIt last) {
+  if constexpr (std::random_access_iterator<InputIt>) {
+    while (first != last) {
+      if (seen < k || seen == next) {add(*first++); continue;}
+
+      // jump right to the next item taken
+      const unsigned long long remaining = last - first;
+      if (next - seen >= remaining) {seen += remaining; return;}
+
+      first += next - seen;
+      seen   = next;
+    }
+  }
+  else {
+    for (; first != last; ++first) {add(*first);}
+  }
+}
+// .......................................................................... //
+template<class T>
+const std::vector<T> & BCG::ReservoirSampler<T>::sample() const {return reservoir;}
+// .......................................................................... //
+template<class T>
+unsigned long long BCG::ReservoirSampler<T>::count() const {return seen;}
+// .......................................................................... //
+template<class T>
+void BCG::ReservoirSampler<T>::scheduleNext() {
+  // uniform in (0, 1], such that the logarithms are finite
+  auto u = [this] () {return 1.0 - (get_randBits64(engine) >> 11) * 0x1.0p-53;};
+
+  // W is the largest of k uniform numbers, i.e. the current acceptance threshold
+  W *= std::exp(std::log(u()) / k);
+
+  const double skip = std::floor(std::log(u()) / std::log1p(-W));
+  next = (skip < 1e18) ? seen + static_cast<unsigned long long>(skip) : UINT64_MAX;
+}
+
+// -------------------------------------------------------------------------- //
+// low discrepancy sequences
+
+inline size_t BCG::SobolSequence::dimensions() const {return dims;}
+// .......................................................................... //
+inline unsigned long long BCG::SobolSequence::get_index() const {return index;}
+// .......................................................................... //
+inline void BCG::SobolSequence::discard(const unsigned long long n) {
+  if (n > max_index - index) {
+    throw std::out_of_range(THROWTEXT("    Sobol sequence exhausted!"));
+  }
+  set_index(index + n);
+}
+// .......................................................................... //
+inline size_t BCG::HaltonSequence::dimensions() const {return dims.size();}
+// .......................................................................... //
+inline uint32_t BCG::HaltonSequence::base(const size_t dimension) const {return dims.at(dimension).base;}
+// .......................................................................... //
+inline unsigned long long BCG::HaltonSequence::get_index() const {return index;}
+// .......................................................................... //
+inline void BCG::HaltonSequence::discard(const unsigned long long n) {set_index(index + n);}
+
 // ========================================================================== //
 // procs
 
@@ -10,9 +196,346 @@ static inline void BCG::reset_PRNG(const long long seed) {
   seedRNG = seed;
   PRNG = std::mt19937(seedRNG);
 }
+// .......................................................................... //
+static inline void BCG::reset_CBRNG(const unsigned long long seed) {CBRNG.seed(seed);}
 
 static inline double BCG::get_randPhase      () {return rand_phase_distribution     (PRNG);}
 static inline double BCG::get_randPercentage () {return rand_percentage_distribution(PRNG);}
+static inline double BCG::get_randNormal     () {return get_randNormal(PRNG);}
+// .......................................................................... //
+template<class Engine>
+double BCG::get_randNormal(Engine & engine) {
+  constexpr double R = 3.6541528853610088;                                      // start of the tail, ziggurat_x[1]
+
+  while (true) {
+    const uint64_t bits  = get_randBits64(engine);
+    const size_t   layer = bits & 0xFFu;
+    const double   u     = (static_cast<int64_t>(bits) >> 11) * 0x1.0p-52;      // in [-1, 1), independent of the layer bits
+    const double   x     = u * ziggurat_x[layer];
+
+    // fast path: x is inside the rectangle fully covered by the layer
+    if (std::abs(x) < ziggurat_x[layer + 1]) {return x;}
+
+    // base layer: sample from the tail beyond R
+    if (layer == 0) {
+      double tx, ty;
+      do {
+        tx = -std::log(1.0 - (get_randBits64(engine) >> 11) * 0x1.0p-53) / R;
+        ty = -std::log(1.0 - (get_randBits64(engine) >> 11) * 0x1.0p-53);
+      } while (ty + ty < tx * tx);
+
+      return (u < 0) ? -(R + tx) : (R + tx);
+    }
+
+    // wedge: accept x if a random point between the layer boundaries is below the density
+    const double y = ziggurat_f[layer] + (get_randBits64(engine) >> 11) * 0x1.0p-53 * (ziggurat_f[layer + 1] - ziggurat_f[layer]);
+    if (y < std::exp(-0.5 * x * x)) {return x;}
+  }
+}
+// .......................................................................... //
+template<class Engine>
+std::vector<unsigned long long> BCG::get_randMultinomial(const unsigned long long n,
+                                                         const std::vector<double> & weights,
+                                                         Engine & engine
+) {
+  const size_t N = weights.size();
+
+  // validates the weights, too
+  AliasTable table;
+  if (n < N || N == 0) {table = AliasTable(weights);}
+
+  std::vector<unsigned long long> counts(N, 0u);
+
+  if (n < N) {
+    for (unsigned long long trial = 0; trial < n; ++trial) {++counts[table(engine)];}
+    return counts;
+  }
+
+  for (auto w : weights) {
+    if (w < 0 || !std::isfinite(w)) {
+      throw std::invalid_argument(THROWTEXT("    weights must be non-negative and finite!"));
+    }
+  }
+
+  // the weight left for categories i .. N-1, summed from the back to avoid cancellation
+  std::vector<double> remainingWeight(N + 1, 0.0);
+  for (size_t i = N; i-- > 0; ) {remainingWeight[i] = remainingWeight[i + 1] + weights[i];}
+
+  if (remainingWeight[0] <= 0) {
+    throw std::invalid_argument(THROWTEXT("    weights must not sum up to zero!"));
+  }
+
+  unsigned long long remainingTrials = n;
+  for (size_t i = 0; i < N && remainingTrials; ++i) {
+    if (remainingWeight[i + 1] <= 0) {counts[i] = remainingTrials; break;}
+
+    const double p = std::min(1.0, weights[i] / remainingWeight[i]);
+    if (p <= 0) {continue;}
+
+    counts[i]        = std::binomial_distribution<unsigned long long>(remainingTrials, p)(engine);
+    remainingTrials -= counts[i];
+  }
+
+  return counts;
+}
+// .......................................................................... //
+static inline std::vector<unsigned long long> BCG::get_randMultinomial(const unsigned long long n,
+                                                                       const std::vector<double> & weights
+) {
+  return get_randMultinomial(n, weights, PRNG);
+}
+// .......................................................................... //
+template<class Engine>
+uint64_t BCG::get_randBits64(Engine & engine) {
+  constexpr auto range = Engine::max() - Engine::min();
+
+  if      constexpr (Engine::min() == 0 && range == UINT64_MAX) {
+    return engine();
+  }
+  else if constexpr (Engine::min() == 0 && range == UINT32_MAX) {
+    const uint64_t hi = engine();
+    return hi << 32u | engine();
+  }
+  else {
+    return std::uniform_int_distribution<uint64_t>()(engine);
+  }
+}
+// .......................................................................... //
+template<class Engine>
+uint64_t BCG::get_randIndex(const uint64_t n, Engine & engine) {
+  if (n == 0) {
+    throw std::invalid_argument(THROWTEXT("    cannot draw from an empty range!"));
+  }
+
+  if (n > UINT32_MAX) {
+    // rejection from the largest multiple of n below 2^64
+    const uint64_t limit = UINT64_MAX - UINT64_MAX % n;
+    uint64_t x;
+    do {x = get_randBits64(engine);} while (x >= limit);
+    return x % n;
+  }
+
+  auto draw32 = [&engine] () -> uint64_t {
+    if constexpr (Engine::min() == 0 && Engine::max() == UINT32_MAX) {return engine();}
+    else                                                             {return get_randBits64(engine) >> 32u;}
+  };
+
+  // the upper half of x * n is uniform, unless the lower half falls into the biased region
+  uint64_t product = draw32() * n;
+  if (static_cast<uint32_t>(product) < n) {
+    const uint32_t threshold = static_cast<uint32_t>(-static_cast<uint32_t>(n)) % static_cast<uint32_t>(n);
+    while (static_cast<uint32_t>(product) < threshold) {product = draw32() * n;}
+  }
+
+  return product >> 32u;
+}
+
+// -------------------------------------------------------------------------- //
+// bulk generation
+
+template<class Engine>
+void BCG::fill_randNormal(std::span<double> out, Engine & engine) {
+  for (auto & x : out) {x = get_randNormal(engine);}
+}
+
+// -------------------------------------------------------------------------- //
+// independent streams
+
+static inline void BCG::reset_threadPRNG(const unsigned long long streamID) {
+  threadPRNG = get_PRNG_stream(streamID);
+}
+// .......................................................................... //
+template<class Engine>
+double BCG::get_randPhase(Engine & engine) {
+  // work on a copy such that the shared distribution object is only read
+  auto distribution = rand_phase_distribution;
+  return distribution(engine);
+}
+// .......................................................................... //
+template<class Engine>
+double BCG::get_randPercentage(Engine & engine) {
+  auto distribution = rand_percentage_distribution;
+  return distribution(engine);
+}
+
+// -------------------------------------------------------------------------- //
+// jump ahead
+
+static inline void BCG::jump_PRNG(const unsigned long long n) {jump_mt19937(PRNG, n);}
+
+// -------------------------------------------------------------------------- //
+// shuffling and sampling
+
+template<class RandomIt>
+void BCG::parallel_shuffle(RandomIt first, RandomIt last,
+                           const unsigned long long streamOffset,
+                           const unsigned int threads
+) {
+  typedef typename std::iterator_traits<RandomIt>::value_type T;
+
+  // buckets of some 32k elements fit into the L2 cache
+  constexpr size_t BUCKET_SIZE = 1u << 15u;
+  constexpr size_t MAX_BUCKETS = 1024u;
+
+  /* Fisher-Yates, where indices below 2^16 are drawn from 16 bit chunks of a
+   * 64 bit draw with Lemire's method. This saves random bits, which are the
+   * bottleneck once the range fits into the cache.
+   */
+  auto fisherYates = [] (auto begin, const size_t N, auto & engine) {
+    using std::swap;
+
+    uint64_t random = 0;
+    int      unused = 0;
+    auto next16 = [&] () -> uint32_t {
+      if (unused == 0) {random = get_randBits64(engine); unused = 64;}
+      const uint32_t chunk = random & 0xFFFFu;
+      random >>= 16u;
+      unused  -= 16;
+      return chunk;
+    };
+
+    for (size_t i = N; i-- > 1; ) {
+      size_t j;
+
+      if (i + 1 <= 0x10000u) {
+        const uint32_t n = i + 1;
+        uint32_t product = next16() * n;
+        if ((product & 0xFFFFu) < n) {
+          const uint32_t threshold = (0x10000u - n) % n;
+          while ((product & 0xFFFFu) < threshold) {product = next16() * n;}
+        }
+        j = product >> 16u;
+      }
+      else {
+        j = get_randIndex(i + 1, engine);
+      }
+
+      swap(begin[i], begin[j]);
+    }
+  };
+
+  // a power of two, such that one 64 bit draw yields several bucket indices
+  const size_t N    = last - first;
+  const size_t B    = std::bit_floor(std::clamp<size_t>(N / BUCKET_SIZE, 1u, MAX_BUCKETS));
+  const int    bits = std::countr_zero(B);
+
+  if (B == 1) {
+    auto engine = get_PRNG_stream(streamOffset);
+    fisherYates(first, N, engine);
+    return;
+  }
+
+  // the input is split into B blocks; offsets[block * B + bucket] counts the
+  // elements of a block that go into a bucket, and later their positions
+  auto blockBegin = [N, B] (const size_t block) {return N / B * block + std::min(block, N % B);};
+
+  // uninitialized, as everything is overwritten anyways
+  std::unique_ptr<uint16_t[]> bucketOf(new uint16_t[N]);
+  std::vector<size_t>         offsets (B * B, 0u);
+
+  parallel_for(B, [&] (const size_t block) {
+    auto     engine = get_PRNG_stream(streamOffset + block);
+    size_t * count  = offsets.data() + block * B;
+
+    uint64_t random = 0;
+    int      unused = 0;
+    for (size_t i = blockBegin(block), end = blockBegin(block + 1); i < end; ++i) {
+      if (unused < bits) {random = get_randBits64(engine); unused = 64;}
+
+      bucketOf[i] = random & (B - 1);
+      random >>= bits;
+      unused  -= bits;
+      ++count[bucketOf[i]];
+    }
+  }, threads);
+
+  std::vector<size_t> bucketBegin(B + 1);
+  size_t position = 0;
+  for (size_t bucket = 0; bucket < B; ++bucket) {
+    bucketBegin[bucket] = position;
+    for (size_t block = 0; block < B; ++block) {
+      const size_t count = offsets[block * B + bucket];
+      offsets[block * B + bucket] = position;
+      position += count;
+    }
+  }
+  bucketBegin[B] = N;
+
+  std::unique_ptr<T[]> buffer(new T[N]);
+  parallel_for(B, [&] (const size_t block) {
+    size_t * target = offsets.data() + block * B;
+    for (size_t i = blockBegin(block), end = blockBegin(block + 1); i < end; ++i) {
+      buffer[target[bucketOf[i]]++] = std::move(first[i]);
+    }
+  }, threads);
+
+  parallel_for(B, [&] (const size_t bucket) {
+    auto engine = get_PRNG_stream(streamOffset + B + bucket);
+    auto begin  = buffer.get() + bucketBegin[bucket];
+    auto end    = buffer.get() + bucketBegin[bucket + 1];
+
+    fisherYates(begin, end - begin, engine);
+    std::move(begin, end, first + bucketBegin[bucket]);
+  }, threads);
+}
+// .......................................................................... //
+template<class Engine>
+std::vector<size_t> BCG::sample_indices(const size_t k, const size_t n, Engine & engine) {
+  if (k > n) {
+    throw std::invalid_argument(THROWTEXT("    cannot sample more indices than available!"));
+  }
+
+  std::vector<size_t> reVal;
+  reVal.reserve(k);
+
+  if (k <= n / 16) {
+    // Floyd: adds index j whenever the draw from 0 .. j is already taken
+    std::unordered_set<size_t> chosen;
+    chosen.reserve(2 * k);
+
+    for (size_t j = n - k; j < n; ++j) {
+      const size_t t = get_randIndex(j + 1, engine);
+      chosen.insert(chosen.contains(t) ? j : t);
+    }
+
+    reVal.assign(chosen.begin(), chosen.end());
+    std::sort(reVal.begin(), reVal.end());
+  }
+  else {
+    /* Vitter's Algorithm A: with m indices still needed out of the remaining
+     * r, the number of indices skipped before the next one taken is at least
+     * s with probability prod_(j < s) (r - m - j) / (r - j). That product is
+     * compared to a single uniform number, so there is one draw per index
+     * taken rather than per index inspected.
+     */
+    size_t current = 0;
+    double top     = n - k;
+    double rest    = n;
+
+    for (size_t m = k; m >= 2; --m) {
+      const double V = (get_randBits64(engine) >> 11) * 0x1.0p-53;
+
+      double quotient = top / rest;
+      while (quotient > V) {
+        ++current;
+        --top;
+        --rest;
+        quotient *= top / rest;
+      }
+
+      reVal.push_back(current++);
+      --rest;
+    }
+
+    if (k) {reVal.push_back(current + get_randIndex(static_cast<uint64_t>(rest), engine));}
+  }
+
+  return reVal;
+}
+// .......................................................................... //
+static inline std::vector<size_t> BCG::sample_indices(const size_t k, const size_t n) {
+  return sample_indices(k, n, PRNG);
+}
 
 
 // ========================================================================== //
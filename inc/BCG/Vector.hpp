@@ -16,7 +16,15 @@
 
 #include <complex>
 #include <vector>
+#include <iterator>
+#include <type_traits>
 #include <functional>
+#include <algorithm>
+#include <numeric>
+#include <memory>
+#include <compare>
+#include <cmath>
+#include <limits>
 
 // ========================================================================== //
 
@@ -164,9 +172,275 @@ namespace BCG {
   template<class T>
   static inline std::string vecvec_to_string(const std::vector<std::vector<T>> & listlist);
 
+  // ------------------------------------------------------------------------ //
+  // lazy vector arithmetic
+
+  template<class Expression>
+  class VectorExpressionIterator;
+
+  /**
+   * @brief base class of all lazy vector expressions
+   *
+   * The arithmetic operators and the functions abs(), sqrt(), exp(), log()
+   * and map() do not compute anything when applied to a lazy vector: they
+   * return a small object that records the operation and refers to its
+   * operands. Element @f$i@f$ of the result is only computed when it is
+   * needed, i.e. when the expression is converted to a \c std::vector, by
+   * assign(), or when it is iterated over, e.g. by the norms of the Maths
+   * module. An expression such as <tt>a * 2.0 + c</tt> is thus evaluated in a
+   * single loop, without any intermediate vectors.
+   *
+   * Plain \c std::vector's become lazy operands by wrapping them with lazy(),
+   * or implicitly if the other operand is lazy already. The operators on two
+   * plain \c std::vector's are only found with <tt>using namespace BCG;</tt>.
+   *
+   * \b Example:
+   * @code
+   * const auto x = BCG::linspace(0, 1, 1000000);
+   * const auto c = BCG::linspace(1, 2, 1000000);
+   *
+   * std::vector<double> y = BCG::lazy(x) * 2.0 + c;                    // one loop, one allocation
+   * BCG::assign(y, BCG::abs(BCG::lazy(x) - c));                       // one loop, no allocation
+   * const double distance = BCG::norm_Euclidean(BCG::lazy(x) - c);    // one loop, no allocation
+   * @endcode
+   *
+   * @attention an expression refers to its vector operands and does not keep
+   *  them alive. Do not store an expression over temporary vectors in an
+   *  \c auto variable, e.g. <tt>auto e = BCG::lazy(BCG::linspace(0, 1, 10)) * 2;</tt>
+   *  dangles.
+   *
+   * Expressions derive from this class as <tt>VectorExpression<Derived></tt>
+   * and provide \c value_type, <tt>size()</tt> and <tt>operator[]</tt>.
+   */
+  template<class Expression>
+  class VectorExpression {
+    public:
+      //! @brief iterator to the first element. Elements are computed on dereferencing.
+      VectorExpressionIterator<Expression> begin() const;
+
+      //! @brief iterator past the last element
+      VectorExpressionIterator<Expression> end() const;
+
+      //! @brief computes all elements in a single loop and returns them as a new \c std::vector
+      auto evaluate() const;
+
+      //! @brief computes all elements into a new \c std::vector<T>, see evaluate()
+      template<class T>
+      operator std::vector<T>() const;
+  };
+
+  /**
+   * @brief a random access iterator over a VectorExpression, which computes
+   *  the element it points to when dereferenced
+   */
+  template<class Expression>
+  class VectorExpressionIterator {
+    public:
+      using iterator_category = std::random_access_iterator_tag;
+      using iterator_concept  = std::random_access_iterator_tag;
+      using value_type        = typename Expression::value_type;
+      using difference_type   = ptrdiff_t;
+      using pointer           = void;
+      using reference         = value_type;
+
+      VectorExpressionIterator() = default;
+      VectorExpressionIterator(const Expression * expression, const difference_type index);
+
+      value_type operator* () const;
+      value_type operator[](const difference_type n) const;
+
+      VectorExpressionIterator & operator++();
+      VectorExpressionIterator & operator--();
+      VectorExpressionIterator   operator++(int);
+      VectorExpressionIterator   operator--(int);
+      VectorExpressionIterator & operator+=(const difference_type n);
+      VectorExpressionIterator & operator-=(const difference_type n);
+      VectorExpressionIterator   operator+ (const difference_type n) const;
+      VectorExpressionIterator   operator- (const difference_type n) const;
+      difference_type            operator- (const VectorExpressionIterator & other) const;
+
+      friend VectorExpressionIterator operator+(const difference_type n, const VectorExpressionIterator & it) {return it + n;}
+
+      bool                 operator== (const VectorExpressionIterator & other) const;
+      std::strong_ordering operator<=>(const VectorExpressionIterator & other) const;
+
+    private:
+      const Expression * expression = nullptr;
+      difference_type    index      = 0;
+  };
+
+  //! @brief a lazy reference to the elements of a \c std::vector. See lazy().
+  template<class T>
+  class VectorReference : public VectorExpression<VectorReference<T>> {
+    public:
+      using value_type = T;
+
+      explicit VectorReference(const std::vector<T> & vector);
+
+      size_t    size() const;
+      const T & operator[](const size_t i) const;
+
+    private:
+      const T * elements;
+      size_t    N;
+  };
+
+  //! @brief a scalar operand of a lazy vector expression, which is the same for every element
+  template<class T>
+  class VectorScalar {
+    public:
+      using value_type = T;
+
+      explicit VectorScalar(const T & value);
+
+      const T & operator[](const size_t) const;
+
+    private:
+      T value;
+  };
+
+  //! @brief the lazy result of an elementwise operation on one vector. See map().
+  template<class Operation, class Operand>
+  class VectorUnaryExpression : public VectorExpression<VectorUnaryExpression<Operation, Operand>> {
+    public:
+      using value_type = std::decay_t<std::invoke_result_t<const Operation &, typename Operand::value_type>>;
+
+      VectorUnaryExpression(const Operand & operand, const Operation & operation);
+
+      size_t     size() const;
+      value_type operator[](const size_t i) const;
+
+    private:
+      Operand   operand;
+      Operation operation;
+  };
+
+  /**
+   * @brief the lazy result of an elementwise operation on two vectors, or on
+   *  a vector and a scalar
+   *
+   * @throws std::invalid_argument on construction if both operands are
+   *  vectors of different size
+   */
+  template<class Operation, class Left, class Right>
+  class VectorBinaryExpression : public VectorExpression<VectorBinaryExpression<Operation, Left, Right>> {
+    public:
+      using value_type = std::decay_t<std::invoke_result_t<const Operation &, typename Left::value_type, typename Right::value_type>>;
+
+      VectorBinaryExpression(const Left & left, const Right & right, const Operation & operation);
+
+      size_t     size() const;
+      value_type operator[](const size_t i) const;
+
+    private:
+      Left      left;
+      Right     right;
+      Operation operation;
+      size_t    N;
+  };
+
+  /**
+   * @brief satisfied by the types that can be the vector operand of a lazy
+   *  expression: VectorExpression's and \c std::vector's of arithmetic or
+   *  complex values
+   */
+  template<class T>
+  concept LazyVector = std::is_base_of_v<VectorExpression<T>, T> ||
+                       (requires {typename T::value_type;} &&
+                        std::is_same_v<T, std::vector<typename T::value_type>> &&
+                        (std::is_arithmetic_v<typename T::value_type> ||
+                         std::is_same_v<typename T::value_type, std::complex<typename T::value_type::value_type>>));
+
+  //! @brief satisfied by the types that can be the scalar operand of a lazy expression: arithmetic and complex values
+  template<class T>
+  concept LazyScalar = std::is_arithmetic_v<T> ||
+                       (requires {typename T::value_type;} && std::is_same_v<T, std::complex<typename T::value_type>>);
+
+  //! @brief satisfied if \c Left and \c Right can be combined by the lazy arithmetic operators
+  template<class Left, class Right>
+  concept LazyOperands = (LazyVector<Left> && (LazyVector<Right> || LazyScalar<Right>)) ||
+                         (LazyScalar<Left> && LazyVector<Right>);
+
+  //! @brief wraps \c vector as a lazy operand. See VectorExpression.
+  template<class T>
+  VectorReference<T> lazy(const std::vector<T> & vector);
+
+  /**
+   * @brief converts \c x into an operand of a lazy expression: \c std::vector's
+   *  into VectorReference's, scalars into VectorScalar's. Expressions are
+   *  returned unchanged.
+   */
+  template<class T> requires (LazyVector<T> || LazyScalar<T>)
+  auto lazy_operand(const T & x);
+
+  //! @brief lazy elementwise sum. See VectorExpression.
+  template<class Left, class Right> requires LazyOperands<Left, Right>
+  auto operator+(const Left & left, const Right & right);
+
+  //! @brief lazy elementwise difference. See VectorExpression.
+  template<class Left, class Right> requires LazyOperands<Left, Right>
+  auto operator-(const Left & left, const Right & right);
+
+  //! @brief lazy elementwise product. See VectorExpression.
+  template<class Left, class Right> requires LazyOperands<Left, Right>
+  auto operator*(const Left & left, const Right & right);
+
+  //! @brief lazy elementwise quotient. See VectorExpression.
+  template<class Left, class Right> requires LazyOperands<Left, Right>
+  auto operator/(const Left & left, const Right & right);
+
+  //! @brief lazy elementwise negation. See VectorExpression.
+  template<LazyVector Operand>
+  auto operator-(const Operand & x);
+
+  //! @brief lazy elementwise absolute value (modulus for complex values)
+  template<LazyVector Operand>
+  auto abs(const Operand & x);
+
+  //! @brief lazy elementwise square root
+  template<LazyVector Operand>
+  auto sqrt(const Operand & x);
+
+  //! @brief lazy elementwise exponential function
+  template<LazyVector Operand>
+  auto exp(const Operand & x);
+
+  //! @brief lazy elementwise natural logarithm
+  template<LazyVector Operand>
+  auto log(const Operand & x);
+
+  /**
+   * @brief lazily applies \c function to each element of \c x
+   *
+   * \c function should be cheap to copy and free of side effects, as it may
+   * be called any number of times per element, in any order.
+   */
+  template<LazyVector Operand, class Function>
+  auto map(const Operand & x, Function function);
+
+  /**
+   * @brief computes all elements of \c x in a single loop into \c target,
+   *  which is resized to the size of \c x
+   *
+   * No memory is allocated if \c target is large enough already. \c target
+   * may be an operand of \c x, as each element of the result only depends on
+   * the elements of the operands with the same index.
+   */
+  template<class T, LazyVector Operand>
+  void assign(std::vector<T> & target, const Operand & x);
+
   // ------------------------------------------------------------------------ //
   // find nearby
 
+  /**
+   * @brief projects a value onto the positive reals via \c std::abs. The
+   *  default \c absfunc of findNearby().
+   */
+  struct AbsoluteValue {
+    template<class T>
+    double operator()(const T & x) const;
+  };
+
   /**
    * @brief returns an iterator to the first object within \c epsilon of a
    *  searchword.
@@ -181,15 +455,48 @@ namespace BCG {
    * @param absfunc function used to project the difference between \c val and
    *  the container element onto the positive reals
    *
+   * \c absfunc and \c difffunc may be any callables, e.g. lambdas, function
+   * pointers or \c std::function objects. They are passed as template
+   * parameters, so they can be inlined into the loop.
+   *
+   * The default \c difffunc computes the difference in the common type of
+   * element and \c value, so e.g. an integer literal is not truncated when
+   * searched in a range of \c double.
+   *
+   * For contiguous ranges of \c double, \c float or \c std::complex<double>
+   * with a \c value of the same type and the default \c absfunc and
+   * \c difffunc, the search is forwarded to the SIMD versions below.
    */
-  template<typename Iterator, typename T>
+  template<typename Iterator, typename T, class Abs = AbsoluteValue, class Difference = std::minus<>>
   Iterator findNearby(Iterator begin, Iterator end,
                       const T & value,
                       double epsilon,
-                      std::function<double(T)> absfunc = static_cast<double (*)(T)>(&std::abs),
-                      std::function<T(T, T)>   difffunc = std::minus<T>()
+                      Abs        absfunc  = Abs(),
+                      Difference difffunc = Difference()
                      );
 
+  /**
+   * @brief SIMD version of findNearby() for \c double
+   *
+   * Compares blocks of 16 (AVX2) or 32 (AVX-512) elements at once and stops
+   * at the first block that contains a match, selected at runtime. The
+   * result is the same as that of the generic version.
+   */
+  const double * findNearby(const double * begin, const double * end, const double value, const double epsilon);
+
+  //! @brief SIMD version of findNearby() for \c float. The differences are computed in \c float, as in the generic version.
+  const float * findNearby(const float * begin, const float * end, const float value, const double epsilon);
+
+  /**
+   * @brief SIMD version of findNearby() for \c std::complex<double>
+   *
+   * Elements are preselected by the larger of the absolute differences of
+   * the real and imaginary parts, which is never larger than the modulus.
+   * Candidates are then checked with \c std::abs, so the result is the same
+   * as that of the generic version.
+   */
+  const std::complex<double> * findNearby(const std::complex<double> * begin, const std::complex<double> * end, const std::complex<double> value, const double epsilon);
+
   /**
    * @brief returns the index of the first element in an STL container that is
    *  closer to \c value than \c epsilon
@@ -197,14 +504,146 @@ namespace BCG {
    * The parameters are the same as in findNearby(), and the index returned is
    * the result of \c std::difference().
    */
-  template<typename Iterator, typename T>
+  template<typename Iterator, typename T, class Abs = AbsoluteValue, class Difference = std::minus<>>
   int findNearbyIdx(Iterator begin, Iterator end,
                     const T & value,
                     double epsilon,
-                    std::function<double(T)> absfunc = static_cast<double (*)(T)>(&std::abs),
-                    std::function<T(T, T)>   difffunc = std::minus<T>()
+                    Abs        absfunc  = Abs(),
+                    Difference difffunc = Difference()
                    );
 
+  /**
+   * @brief findNearby() for a range sorted in ascending order, by binary
+   *  search in @f$O(\log n)@f$
+   *
+   * For real values, the elements within \c epsilon of \c value form a
+   * contiguous run of a sorted range. Its first element is found with
+   * \c std::partition_point, using the same difference <tt>x - value</tt> as
+   * the default findNearby(), so the result is the same as that of the
+   * linear search. The range must not contain NaN.
+   */
+  template<typename Iterator, typename T>
+  Iterator findNearbySorted(Iterator begin, Iterator end, const T & value, double epsilon);
+
+  //! @brief findNearbyIdx() for a range sorted in ascending order, cf. findNearbySorted()
+  template<typename Iterator, typename T>
+  int findNearbyIdxSorted(Iterator begin, Iterator end, const T & value, double epsilon);
+
+  /**
+   * @brief findNearbyIdx() for many values on the same sorted range, in one
+   *  sweep
+   *
+   * The values are visited in ascending order (they are sorted internally,
+   * unless they are sorted already), so the position of the run of nearby
+   * elements only moves forward. On random access ranges, the next position
+   * is found by exponential search from the previous one, which costs
+   * @f$O(m \log(n / m))@f$ for @f$m@f$ values on @f$n@f$ elements; other
+   * ranges are swept linearly in @f$O(n + m)@f$.
+   *
+   * @returns the indices in the order of \c values, -1 where there is no
+   *  element within \c epsilon
+   */
+  template<typename Iterator, typename T>
+  std::vector<int> findNearbyIdxSorted(Iterator begin, Iterator end, const std::vector<T> & values, double epsilon);
+
+  /**
+   * @brief findNearby() for a sorted, (nearly) uniform grid such as the
+   *  output of linspace() or arange(), in @f$O(1)@f$
+   *
+   * The position of the first nearby element is computed from the first and
+   * last element of the range, assuming equal spacing, and then verified on
+   * the actual elements. Grids built by repeated addition deviate slightly
+   * from equal spacing; if the computed position is off by more than one
+   * element, the search falls back to findNearbySorted(). Hence the result
+   * is the same as that of findNearby() on any sorted random access range.
+   */
+  template<typename Iterator, typename T>
+  Iterator findNearbyUniform(Iterator begin, Iterator end, const T & value, double epsilon);
+
+  //! @brief findNearbyIdx() for a sorted, (nearly) uniform grid, cf. findNearbyUniform()
+  template<typename Iterator, typename T>
+  int findNearbyIdxUniform(Iterator begin, Iterator end, const T & value, double epsilon);
+
+  // ------------------------------------------------------------------------ //
+  // deduplication and grouping
+
+  /**
+   * @brief removes values that are within \c epsilon of a value kept before
+   *
+   * The result is the same as that of the loop
+   * @code
+   * std::vector<T> reVal;
+   * for (auto it = begin; it != end; ++it) {
+   *   if (BCG::findNearby(reVal.begin(), reVal.end(), *it, epsilon) == reVal.end()) {reVal.push_back(*it);}
+   * }
+   * @endcode
+   * i.e. the kept values are in input order, and a value is dropped if it is
+   * closer than \c epsilon to a kept value, even if it is farther from the
+   * value that dropped the one in between. Instead of @f$O(n^2)@f$, this
+   * needs @f$O(n \log n)@f$: the values are sorted once, the range of
+   * sorted positions within \c epsilon of each value is determined in one
+   * sweep, and the kept values are counted in a Fenwick tree over the sorted
+   * positions. NaN is always kept, as it is not within \c epsilon of
+   * anything.
+   *
+   * @param begin iterator to the first element of a range of real values
+   * @param end iterator past the last element
+   * @param epsilon values closer than this are considered equal
+   */
+  template<typename Iterator>
+  std::vector<typename std::iterator_traits<Iterator>::value_type> unique_within(Iterator begin, Iterator end, double epsilon);
+
+  /**
+   * @brief groups values that are connected by steps of less than
+   *  \c epsilon (single linkage clustering)
+   *
+   * Two values are in the same group if they are closer than \c epsilon, or
+   * if they are both in the same group as a third value. Hence, the values
+   * of a group may span more than \c epsilon, unlike the values dropped by
+   * unique_within(). For real values, the groups are runs of the sorted
+   * values with gaps smaller than \c epsilon, found by one sort and sweep in
+   * @f$O(n \log n)@f$. NaN forms a group of its own.
+   *
+   * @returns a group label for each element, where the groups are numbered
+   *  from 0 in the order of their first element in the range
+   */
+  template<typename Iterator>
+  std::vector<size_t> group_within(Iterator begin, Iterator end, double epsilon);
+
+  /**
+   * @brief unique_within() for points, with the Euclidean distance
+   *
+   * Returns the indices of the kept points, in ascending order. The points
+   * are sorted into a grid of cells of size 2 \c epsilon along their first
+   * (up to) three coordinates, so only points in the same or adjacent cells
+   * are compared. For large inputs, the comparisons are distributed over
+   * \c threads threads with parallel_for(); the decision which points to
+   * keep is then made in one pass in input order.
+   *
+   * The cost grows with the number of pairs closer than \c epsilon, so
+   * \c epsilon should be small compared to the extent of the point set. For
+   * other norms or for nearest neighbour queries, see the KDTree in the
+   * Maths module.
+   *
+   * @param threads the number of threads to use. 0 means \c BCG::nThreads.
+   *
+   * @throws std::invalid_argument if the points are not all of the same
+   *  dimension
+   */
+  std::vector<size_t> unique_within(const std::vector<std::vector<double>> & points, double epsilon, unsigned int threads = 0);
+
+  /**
+   * @brief group_within() for points, with the Euclidean distance
+   *
+   * The pairs of points closer than \c epsilon are found on the same grid as
+   * in unique_within(const std::vector<std::vector<double>> &, double, unsigned int),
+   * and merged into groups with a union-find structure.
+   *
+   * @throws std::invalid_argument if the points are not all of the same
+   *  dimension
+   */
+  std::vector<size_t> group_within(const std::vector<std::vector<double>> & points, double epsilon, unsigned int threads = 0);
+
   //! @}
 }
 
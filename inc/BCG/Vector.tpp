@@ -89,35 +89,381 @@ static inline std::string BCG::vecvec_to_string(const std::vector<std::vector<T>
   return reVal.str();
 }
 
+// -------------------------------------------------------------------------- //
+// lazy vector arithmetic
+
+template<class Expression>
+BCG::VectorExpressionIterator<Expression> BCG::VectorExpression<Expression>::begin() const {
+  return VectorExpressionIterator<Expression>(static_cast<const Expression *>(this), 0);
+}
+// .......................................................................... //
+template<class Expression>
+BCG::VectorExpressionIterator<Expression> BCG::VectorExpression<Expression>::end() const {
+  const Expression * self = static_cast<const Expression *>(this);
+  return VectorExpressionIterator<Expression>(self, self->size());
+}
+// .......................................................................... //
+template<class Expression>
+auto BCG::VectorExpression<Expression>::evaluate() const {
+  std::vector<typename Expression::value_type> reVal;
+  BCG::assign(reVal, static_cast<const Expression &>(*this));
+  return reVal;
+}
+// .......................................................................... //
+template<class Expression>
+template<class T>
+BCG::VectorExpression<Expression>::operator std::vector<T>() const {
+  std::vector<T> reVal;
+  BCG::assign(reVal, static_cast<const Expression &>(*this));
+  return reVal;
+}
+
+// .......................................................................... //
+
+template<class Expression>
+BCG::VectorExpressionIterator<Expression>::VectorExpressionIterator(const Expression * expression, const difference_type index) :
+  expression(expression),
+  index     (index)
+{}
+// .......................................................................... //
+template<class E> inline auto BCG::VectorExpressionIterator<E>::operator* () const -> value_type {return (*expression)[index];}
+template<class E> inline auto BCG::VectorExpressionIterator<E>::operator[](const difference_type n) const -> value_type {return (*expression)[index + n];}
+
+template<class E> inline auto BCG::VectorExpressionIterator<E>::operator++()    -> VectorExpressionIterator & {++index; return *this;}
+template<class E> inline auto BCG::VectorExpressionIterator<E>::operator--()    -> VectorExpressionIterator & {--index; return *this;}
+template<class E> inline auto BCG::VectorExpressionIterator<E>::operator++(int) -> VectorExpressionIterator   {auto reVal = *this; ++index; return reVal;}
+template<class E> inline auto BCG::VectorExpressionIterator<E>::operator--(int) -> VectorExpressionIterator   {auto reVal = *this; --index; return reVal;}
+
+template<class E> inline auto BCG::VectorExpressionIterator<E>::operator+=(const difference_type n) -> VectorExpressionIterator & {index += n; return *this;}
+template<class E> inline auto BCG::VectorExpressionIterator<E>::operator-=(const difference_type n) -> VectorExpressionIterator & {index -= n; return *this;}
+template<class E> inline auto BCG::VectorExpressionIterator<E>::operator+ (const difference_type n) const -> VectorExpressionIterator {return VectorExpressionIterator(expression, index + n);}
+template<class E> inline auto BCG::VectorExpressionIterator<E>::operator- (const difference_type n) const -> VectorExpressionIterator {return VectorExpressionIterator(expression, index - n);}
+template<class E> inline auto BCG::VectorExpressionIterator<E>::operator- (const VectorExpressionIterator & other) const -> difference_type {return index - other.index;}
+
+template<class E> inline bool                 BCG::VectorExpressionIterator<E>::operator== (const VectorExpressionIterator & other) const {return index == other.index;}
+template<class E> inline std::strong_ordering BCG::VectorExpressionIterator<E>::operator<=>(const VectorExpressionIterator & other) const {return index <=> other.index;}
+
+// .......................................................................... //
+
+template<class T>
+BCG::VectorReference<T>::VectorReference(const std::vector<T> & vector) : elements(vector.data()), N(vector.size()) {}
+
+template<class T> inline size_t    BCG::VectorReference<T>::size() const {return N;}
+template<class T> inline const T & BCG::VectorReference<T>::operator[](const size_t i) const {return elements[i];}
+// .......................................................................... //
+template<class T>
+BCG::VectorScalar<T>::VectorScalar(const T & value) : value(value) {}
+
+template<class T> inline const T & BCG::VectorScalar<T>::operator[](const size_t) const {return value;}
+// .......................................................................... //
+template<class Operation, class Operand>
+BCG::VectorUnaryExpression<Operation, Operand>::VectorUnaryExpression(const Operand & operand, const Operation & operation) :
+  operand  (operand),
+  operation(operation)
+{}
+
+template<class Operation, class Operand>
+inline size_t BCG::VectorUnaryExpression<Operation, Operand>::size() const {return operand.size();}
+
+template<class Operation, class Operand>
+inline auto BCG::VectorUnaryExpression<Operation, Operand>::operator[](const size_t i) const -> value_type {return operation(operand[i]);}
+// .......................................................................... //
+template<class Operation, class Left, class Right>
+BCG::VectorBinaryExpression<Operation, Left, Right>::VectorBinaryExpression(const Left & left, const Right & right, const Operation & operation) :
+  left     (left),
+  right    (right),
+  operation(operation)
+{
+  constexpr bool scalarLeft  = std::is_same_v<Left,  VectorScalar<typename Left ::value_type>>;
+  constexpr bool scalarRight = std::is_same_v<Right, VectorScalar<typename Right::value_type>>;
+
+  if      constexpr (scalarLeft)  {N = right.size();}
+  else if constexpr (scalarRight) {N = left .size();}
+  else {
+    if (left.size() != right.size()) {throw std::invalid_argument(THROWTEXT("    vectors are not of same dimension!"));}
+    N = left.size();
+  }
+}
+
+template<class Operation, class Left, class Right>
+inline size_t BCG::VectorBinaryExpression<Operation, Left, Right>::size() const {return N;}
+
+template<class Operation, class Left, class Right>
+inline auto BCG::VectorBinaryExpression<Operation, Left, Right>::operator[](const size_t i) const -> value_type {return operation(left[i], right[i]);}
+
+// .......................................................................... //
+
+template<class T>
+inline BCG::VectorReference<T> BCG::lazy(const std::vector<T> & vector) {return VectorReference<T>(vector);}
+// .......................................................................... //
+template<class T> requires (BCG::LazyVector<T> || BCG::LazyScalar<T>)
+inline auto BCG::lazy_operand(const T & x) {
+  if      constexpr (LazyScalar<T>)                          {return VectorScalar<T>(x);}
+  else if constexpr (std::is_base_of_v<VectorExpression<T>, T>) {return x;}
+  else                                                       {return VectorReference<typename T::value_type>(x);}
+}
+// .......................................................................... //
+template<class Left, class Right> requires BCG::LazyOperands<Left, Right>
+inline auto BCG::operator+(const Left & left, const Right & right) {
+  return VectorBinaryExpression(lazy_operand(left), lazy_operand(right), std::plus<>());
+}
+template<class Left, class Right> requires BCG::LazyOperands<Left, Right>
+inline auto BCG::operator-(const Left & left, const Right & right) {
+  return VectorBinaryExpression(lazy_operand(left), lazy_operand(right), std::minus<>());
+}
+template<class Left, class Right> requires BCG::LazyOperands<Left, Right>
+inline auto BCG::operator*(const Left & left, const Right & right) {
+  return VectorBinaryExpression(lazy_operand(left), lazy_operand(right), std::multiplies<>());
+}
+template<class Left, class Right> requires BCG::LazyOperands<Left, Right>
+inline auto BCG::operator/(const Left & left, const Right & right) {
+  return VectorBinaryExpression(lazy_operand(left), lazy_operand(right), std::divides<>());
+}
+// .......................................................................... //
+template<BCG::LazyVector Operand>
+inline auto BCG::operator-(const Operand & x) {return VectorUnaryExpression(lazy_operand(x), std::negate<>());}
+
+template<BCG::LazyVector Operand>
+inline auto BCG::abs (const Operand & x) {return BCG::map(x, [] (const auto & y) {return std::abs (y);});}
+template<BCG::LazyVector Operand>
+inline auto BCG::sqrt(const Operand & x) {return BCG::map(x, [] (const auto & y) {return std::sqrt(y);});}
+template<BCG::LazyVector Operand>
+inline auto BCG::exp (const Operand & x) {return BCG::map(x, [] (const auto & y) {return std::exp (y);});}
+template<BCG::LazyVector Operand>
+inline auto BCG::log (const Operand & x) {return BCG::map(x, [] (const auto & y) {return std::log (y);});}
+
+template<BCG::LazyVector Operand, class Function>
+inline auto BCG::map(const Operand & x, Function function) {return VectorUnaryExpression(lazy_operand(x), function);}
+// .......................................................................... //
+template<class T, BCG::LazyVector Operand>
+void BCG::assign(std::vector<T> & target, const Operand & x) {
+  const auto   expression = lazy_operand(x);
+  const size_t N          = expression.size();
+
+  target.resize(N);
+  T * result = target.data();
+  for (size_t i = 0; i < N; ++i) {result[i] = expression[i];}
+}
+
 // -------------------------------------------------------------------------- //
 // find nearby
 
-template<class Iterator, class T>
+template<class T>
+double BCG::AbsoluteValue::operator()(const T & x) const {return std::abs(x);}
+// .......................................................................... //
+template<class Iterator, class T, class Abs, class Difference>
 Iterator BCG::findNearby(Iterator begin, Iterator end,
                     const T & value,
                     double epsilon,
-                    std::function<double(T)> absfunc,
-                    std::function<T(T, T)> difffunc
+                    Abs        absfunc,
+                    Difference difffunc
 ) {
-  auto it = begin;
-  for (; it != end; ++it) {
-    if (absfunc( difffunc(*it, value)) < epsilon) {break;}
-  }
+  constexpr bool simd = std::contiguous_iterator<Iterator>                                     &&
+                        std::is_same_v<std::iter_value_t<Iterator>, T>                         &&
+                        (std::is_same_v<T, double> || std::is_same_v<T, float> || std::is_same_v<T, std::complex<double>>) &&
+                        std::is_same_v<Abs, AbsoluteValue> && std::is_same_v<Difference, std::minus<>>;
+
+  if constexpr (simd) {
+    const T * first = std::to_address(begin);
+    return begin + (BCG::findNearby(first, first + (end - begin), value, epsilon) - first);
+  } else {
+    auto it = begin;
+    for (; it != end; ++it) {
+      if (absfunc( difffunc(*it, value)) < epsilon) {break;}
+    }
 
-  return it;
+    return it;
+  }
 }
 // .......................................................................... //
-template<typename Iterator, typename T>
+template<typename Iterator, typename T, class Abs, class Difference>
 int BCG::findNearbyIdx(Iterator begin, Iterator end,
                        const T & value,
                        double epsilon,
-                       std::function<double(T)> absfunc,
-                       std::function<T(T, T)>   difffunc
+                       Abs        absfunc,
+                       Difference difffunc
 ) {
   auto spot = findNearby(begin, end, value, epsilon, absfunc, difffunc);
   if (spot == end) {return -1;}
   else             {return std::distance(begin, spot);}
 }
+// .......................................................................... //
+template<typename Iterator, typename T>
+Iterator BCG::findNearbySorted(Iterator begin, Iterator end, const T & value, double epsilon) {
+  // true for the elements left of the run within epsilon
+  auto below = [&] (const auto & x) {return !(static_cast<double>(std::minus<>()(x, value)) > -epsilon);};
+
+  auto spot = std::partition_point(begin, end, below);
+  if (spot != end && AbsoluteValue()(std::minus<>()(*spot, value)) < epsilon) {return spot;}
+  else                                                                        {return end;}
+}
+// .......................................................................... //
+template<typename Iterator, typename T>
+int BCG::findNearbyIdxSorted(Iterator begin, Iterator end, const T & value, double epsilon) {
+  auto spot = findNearbySorted(begin, end, value, epsilon);
+  if (spot == end) {return -1;}
+  else             {return std::distance(begin, spot);}
+}
+// .......................................................................... //
+template<typename Iterator, typename T>
+std::vector<int> BCG::findNearbyIdxSorted(Iterator begin, Iterator end, const std::vector<T> & values, double epsilon) {
+  std::vector<int> reVal(values.size(), -1);
+
+  // the values in ascending order, NaN excluded as it is not within epsilon of anything
+  std::vector<size_t> order(values.size());
+  std::iota(order.begin(), order.end(), 0);
+  const auto nValues = std::stable_partition(order.begin(), order.end(), [&] (const size_t i) {return values[i] == values[i];}) - order.begin();
+  auto ascending = [&] (const size_t lhs, const size_t rhs) {return values[lhs] < values[rhs];};
+  if (!std::is_sorted(order.begin(), order.begin() + nValues, ascending)) {
+    std::sort(order.begin(), order.begin() + nValues, ascending);
+  }
+
+  // the run within epsilon only moves right for increasing values
+  Iterator  spot     = begin;
+  ptrdiff_t position = 0;
+  for (ptrdiff_t n = 0; n < nValues; ++n) {
+    const T & value = values[order[n]];
+    auto below = [&] (const auto & x) {return !(static_cast<double>(std::minus<>()(x, value)) > -epsilon);};
+
+    if constexpr (std::random_access_iterator<Iterator>) {
+      // exponential search: everything left of lower is below, upper is not (or the end)
+      const ptrdiff_t N = end - begin;
+      ptrdiff_t lower = position, upper = position, step = 1;
+      while (upper < N && below(begin[upper])) {
+        lower  = upper + 1;
+        upper  = std::min(N, upper + step);
+        step  *= 2;
+      }
+      spot     = std::partition_point(begin + lower, begin + upper, below);
+      position = spot - begin;
+    } else {
+      while (spot != end && below(*spot)) {++spot; ++position;}
+    }
+
+    if (spot != end && AbsoluteValue()(std::minus<>()(*spot, value)) < epsilon) {reVal[order[n]] = position;}
+  }
+
+  return reVal;
+}
+// .......................................................................... //
+template<typename Iterator, typename T>
+Iterator BCG::findNearbyUniform(Iterator begin, Iterator end, const T & value, double epsilon) {
+  const ptrdiff_t N = end - begin;
+  if (N < 2) {return findNearbySorted(begin, end, value, epsilon);}
+
+  auto below = [&] (const auto & x) {return !(static_cast<double>(std::minus<>()(x, value)) > -epsilon);};
+  auto isPartitionPoint = [&] (const ptrdiff_t p) {
+    return (p == 0 || below(begin[p - 1])) && (p == N || !below(begin[p]));
+  };
+
+  // the first element greater than value - epsilon on an equally spaced grid
+  const double first    = static_cast<double>(*begin);
+  const double last     = static_cast<double>(*(end - 1));
+  const double estimate = (static_cast<double>(value) - epsilon - first) / (last - first) * (N - 1);
+  const ptrdiff_t position = estimate > 0 ? (estimate < N ? static_cast<ptrdiff_t>(std::ceil(estimate)) : N) : 0;
+
+  Iterator spot;
+  if      (                isPartitionPoint(position    )) {spot = begin + position;}
+  else if (position > 0 && isPartitionPoint(position - 1)) {spot = begin + position - 1;}
+  else if (position < N && isPartitionPoint(position + 1)) {spot = begin + position + 1;}
+  else if (position < N && below(begin[position]))         {spot = std::partition_point(begin + position + 1, end, below);}
+  else                                                     {spot = std::partition_point(begin, begin + position, below);}
+
+  if (spot != end && AbsoluteValue()(std::minus<>()(*spot, value)) < epsilon) {return spot;}
+  else                                                                        {return end;}
+}
+// .......................................................................... //
+template<typename Iterator, typename T>
+int BCG::findNearbyIdxUniform(Iterator begin, Iterator end, const T & value, double epsilon) {
+  auto spot = findNearbyUniform(begin, end, value, epsilon);
+  if (spot == end) {return -1;}
+  else             {return std::distance(begin, spot);}
+}
+
+// -------------------------------------------------------------------------- //
+// deduplication and grouping
+
+template<typename Iterator>
+std::vector<typename std::iterator_traits<Iterator>::value_type> BCG::unique_within(Iterator begin, Iterator end, double epsilon) {
+  using T = typename std::iterator_traits<Iterator>::value_type;
+
+  const std::vector<T> values(begin, end);
+  const size_t N = values.size();
+
+  // the indices in the order of their values, NaN excluded
+  std::vector<size_t> order(N);
+  std::iota(order.begin(), order.end(), 0);
+  const size_t nValid = std::partition(order.begin(), order.end(), [&] (const size_t i) {return values[i] == values[i];}) - order.begin();
+  std::sort(order.begin(), order.begin() + nValid, [&] (const size_t lhs, const size_t rhs) {return values[lhs] < values[rhs];});
+
+  // the sorted positions [lower, upper) within epsilon of each value. Both
+  // bounds only move right for increasing values, cf. findNearbySorted().
+  std::vector<size_t> position(N, N), lower(nValid), upper(nValid);
+  for (size_t p = 0, lo = 0, hi = 0; p < nValid; ++p) {
+    const T & x = values[order[p]];
+    position[order[p]] = p;
+
+    while (lo < nValid && !(static_cast<double>(std::minus<T>()(values[order[lo]], x)) > -epsilon)) {++lo;}
+    hi = std::max(hi, lo);
+    while (hi < nValid &&   static_cast<double>(std::minus<T>()(values[order[hi]], x)) <  epsilon ) {++hi;}
+
+    lower[p] = lo;
+    upper[p] = hi;
+  }
+
+  // Fenwick tree over the sorted positions, counting the kept values
+  std::vector<size_t> kept(nValid + 1, 0);
+  auto countBelow = [&] (size_t p) {
+    size_t reVal = 0;
+    for (; p > 0; p &= p - 1) {reVal += kept[p];}
+    return reVal;
+  };
+  auto insert = [&] (size_t p) {
+    for (++p; p <= nValid; p += p & (0 - p)) {++kept[p];}
+  };
+
+  std::vector<T> reVal;
+  for (size_t i = 0; i < N; ++i) {
+    const size_t p = position[i];
+    if      (p == N)                                        {reVal.push_back(values[i]);}
+    else if (countBelow(upper[p]) == countBelow(lower[p])) {reVal.push_back(values[i]); insert(p);}
+  }
+
+  return reVal;
+}
+// .......................................................................... //
+template<typename Iterator>
+std::vector<size_t> BCG::group_within(Iterator begin, Iterator end, double epsilon) {
+  using T = typename std::iterator_traits<Iterator>::value_type;
+  constexpr size_t none = std::numeric_limits<size_t>::max();
+
+  const std::vector<T> values(begin, end);
+  const size_t N = values.size();
+
+  std::vector<size_t> order(N);
+  std::iota(order.begin(), order.end(), 0);
+  const size_t nValid = std::partition(order.begin(), order.end(), [&] (const size_t i) {return values[i] == values[i];}) - order.begin();
+  std::sort(order.begin(), order.begin() + nValid, [&] (const size_t lhs, const size_t rhs) {return values[lhs] < values[rhs];});
+
+  // a group is a run of sorted values with gaps below epsilon, identified by the position of its first value
+  std::vector<size_t> run(N, none);
+  for (size_t p = 0, first = 0; p < nValid; ++p) {
+    if (p > 0 && !(AbsoluteValue()(std::minus<T>()(values[order[p]], values[order[p - 1]])) < epsilon)) {first = p;}
+    run[order[p]] = first;
+  }
+
+  std::vector<size_t> reVal(N), label(nValid, none);
+  size_t nGroups = 0;
+  for (size_t i = 0; i < N; ++i) {
+    if (run[i] == none) {reVal[i] = nGroups++; continue;}
+
+    size_t & group = label[run[i]];
+    if (group == none) {group = nGroups++;}
+    reVal[i] = group;
+  }
+
+  return reVal;
+}
 
 // ============================================================================ //
 
@@ -8,6 +8,9 @@ void unittest_BCG_STRING ();
 void unittest_BCG_CONSOLE();
 void unittest_BCG_FILES  ();
 void unittest_BCG_TYPES  ();
+void unittest_BCG_PARALLEL  ();
+void unittest_BCG_MONTECARLO();
+void unittest_BCG_MATRIX    ();
 void unittest_BCG_ALL    ();                                                    // runs unit tests with all modules active
 
 #endif
@@ -3,6 +3,8 @@
 
 // STL
 #include <stdexcept>
+#include <thread>
+#include <algorithm>
 
 // unix terminal
 #include <unistd.h>
@@ -21,7 +23,10 @@
 void BCG::init() {
   isTTY = isatty(fileno(stdout));
   reset_PRNG( trueRNG() );
+  reset_CBRNG( seedRNG );
 
   rand_phase_distribution       = std::uniform_real_distribution<>(0.0, 6.28318530718);   // symbol BCG::PI depends on BCG_MATHS being set
   rand_percentage_distribution  = std::uniform_real_distribution<>(0.0, 1.0          );
+
+  nThreads = std::max(std::thread::hardware_concurrency(), 1u);                 // hardware_concurrency may return 0 if unknown
 }
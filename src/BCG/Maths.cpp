@@ -0,0 +1,734 @@
+// ========================================================================= //
+// dependencies
+
+// STL
+#include <stdexcept>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <array>
+#include <complex>
+
+// own
+#include "BCG.hpp"
+#include "Simd.hpp"
+
+// ========================================================================== //
+// local macro
+
+#define THROWTEXT(msg) (std::string("RUNTIME EXCEPTION IN ") + (__PRETTY_FUNCTION__) + "\n" + msg)
+
+// ========================================================================== //
+// local procs
+
+/* Each kernel exists in a generic, an AVX2 and an AVX-512 version, selected
+ * at runtime (cf. Simd.hpp). All versions accumulate in double precision,
+ * also for float input, and use four independent accumulators to hide the
+ * latency of the additions.
+ *
+ * The compensated kernels first add groups of four terms per lane naively and
+ * then add the group sums to two independent pairs of sum and compensation
+ * (Neumaier). Grouping halves the number of compensated additions, and the
+ * error it introduces is bounded by a few ulp of the result, independent of
+ * the length of the vector. As all terms are non-negative, the larger of
+ * running sum and new term is found with max/min instead of comparing their
+ * absolute values.
+ */
+
+// -------------------------------------------------------------------------- //
+// generic kernels
+
+template<class T>
+static double modSquareSumGeneric(const T * x, const size_t N) {
+  double acc[4] = {0.0, 0.0, 0.0, 0.0};
+
+  size_t i = 0;
+  for (; i + 4 <= N; i += 4) {
+    for (size_t l = 0; l < 4; ++l) {acc[l] += static_cast<double>(x[i + l]) * x[i + l];}
+  }
+  for (; i < N; ++i) {acc[0] += static_cast<double>(x[i]) * x[i];}
+
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+// .......................................................................... //
+template<class T>
+static double absSumGeneric(const T * x, const size_t N) {
+  double acc[4] = {0.0, 0.0, 0.0, 0.0};
+
+  size_t i = 0;
+  for (; i + 4 <= N; i += 4) {
+    for (size_t l = 0; l < 4; ++l) {acc[l] += std::abs(static_cast<double>(x[i + l]));}
+  }
+  for (; i < N; ++i) {acc[0] += std::abs(static_cast<double>(x[i]));}
+
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+// .......................................................................... //
+// adds the non-negative term x to sum and compensation
+static inline void neumaierAdd(double & sum, double & compensation, const double x) {
+  const double t = sum + x;
+  compensation += (std::max(sum, x) - t) + std::min(sum, x);
+  sum = t;
+}
+// .......................................................................... //
+// adds up n non-negative partial sums, each given with its compensation
+static double neumaierMerge(const double * sums, const double * compensations, const size_t n) {
+  double sum = 0.0, compensation = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    neumaierAdd(sum, compensation, sums[i]);
+    compensation += compensations[i];
+  }
+  return sum + compensation;
+}
+// .......................................................................... //
+template<bool squares, class T>
+static inline double term(const T x) {
+  if constexpr (squares) {return static_cast<double>(x) * x;}
+  else                   {return std::abs(static_cast<double>(x));}
+}
+// .......................................................................... //
+template<bool squares, class T>
+static double neumaierSumGeneric(const T * x, const size_t N) {
+  double sums[2] = {0.0, 0.0}, compensations[2] = {0.0, 0.0};
+
+  size_t i = 0;
+  for (; i + 8 <= N; i += 8) {
+    neumaierAdd(sums[0], compensations[0], (term<squares>(x[i    ]) + term<squares>(x[i + 1])) + (term<squares>(x[i + 2]) + term<squares>(x[i + 3])));
+    neumaierAdd(sums[1], compensations[1], (term<squares>(x[i + 4]) + term<squares>(x[i + 5])) + (term<squares>(x[i + 6]) + term<squares>(x[i + 7])));
+  }
+  for (; i < N; ++i) {neumaierAdd(sums[0], compensations[0], term<squares>(x[i]));}
+
+  return neumaierMerge(sums, compensations, 2);
+}
+// .......................................................................... //
+// sum of (xr + i xi) * (yr + i yi), with x conjugated if requested
+template<bool conjugate>
+static std::complex<double> dotGeneric(const double * xr, const double * xi, const double * yr, const double * yi, const size_t N) {
+  double re[4] = {0.0, 0.0, 0.0, 0.0}, im[4] = {0.0, 0.0, 0.0, 0.0};
+
+  auto step = [&] (const size_t l, const size_t i) {
+    if constexpr (conjugate) {re[l] += xr[i] * yr[i] + xi[i] * yi[i]; im[l] += xr[i] * yi[i] - xi[i] * yr[i];}
+    else                     {re[l] += xr[i] * yr[i] - xi[i] * yi[i]; im[l] += xr[i] * yi[i] + xi[i] * yr[i];}
+  };
+
+  size_t i = 0;
+  for (; i + 4 <= N; i += 4) {
+    for (size_t l = 0; l < 4; ++l) {step(l, i + l);}
+  }
+  for (; i < N; ++i) {step(0, i);}
+
+  return {(re[0] + re[1]) + (re[2] + re[3]), (im[0] + im[1]) + (im[2] + im[3])};
+}
+// .......................................................................... //
+// elementwise generic kernels; the AVX versions use them for the tail
+static inline void axpyLoop(const double ar, const double ai,
+                            const double * xr, const double * xi,
+                            double * yr, double * yi, const size_t N
+) {
+  for (size_t i = 0; i < N; ++i) {
+    const double r = xr[i], m = xi[i];
+    yr[i] += ar * r - ai * m;
+    yi[i] += ar * m + ai * r;
+  }
+}
+// .......................................................................... //
+static inline void multiplyLoop(const double * xr, const double * xi,
+                                const double * yr, const double * yi,
+                                double * zr, double * zi, const size_t N
+) {
+  for (size_t i = 0; i < N; ++i) {
+    const double r = xr[i] * yr[i] - xi[i] * yi[i];
+    const double m = xr[i] * yi[i] + xi[i] * yr[i];
+    zr[i] = r;
+    zi[i] = m;
+  }
+}
+
+#ifdef BCG_X86_SIMD
+// -------------------------------------------------------------------------- //
+// AVX2 kernels
+
+TARGET_AVX2 static inline double horizontalSum(__m256d a, __m256d b, __m256d c, __m256d d) {
+  const __m256d sum  = _mm256_add_pd(_mm256_add_pd(a, b), _mm256_add_pd(c, d));
+  const __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+}
+// .......................................................................... //
+// loads 4 values as doubles
+TARGET_AVX2 static inline __m256d load4(const double * x) {return _mm256_loadu_pd(x);}
+TARGET_AVX2 static inline __m256d load4(const float  * x) {return _mm256_cvtps_pd(_mm_loadu_ps(x));}
+// .......................................................................... //
+template<class T>
+TARGET_AVX2 static double modSquareSumAVX2(const T * x, const size_t N) {
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+  __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+
+  size_t i = 0;
+  for (; i + 16 <= N; i += 16) {
+    const __m256d x0 = load4(x + i     ), x1 = load4(x + i +  4);
+    const __m256d x2 = load4(x + i +  8), x3 = load4(x + i + 12);
+    acc0 = _mm256_fmadd_pd(x0, x0, acc0);
+    acc1 = _mm256_fmadd_pd(x1, x1, acc1);
+    acc2 = _mm256_fmadd_pd(x2, x2, acc2);
+    acc3 = _mm256_fmadd_pd(x3, x3, acc3);
+  }
+  for (; i + 4 <= N; i += 4) {
+    const __m256d x0 = load4(x + i);
+    acc0 = _mm256_fmadd_pd(x0, x0, acc0);
+  }
+
+  double reVal = horizontalSum(acc0, acc1, acc2, acc3);
+  for (; i < N; ++i) {reVal += static_cast<double>(x[i]) * x[i];}
+  return reVal;
+}
+// .......................................................................... //
+template<class T>
+TARGET_AVX2 static double absSumAVX2(const T * x, const size_t N) {
+  const __m256d signMask = _mm256_set1_pd(-0.0);
+
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+  __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+
+  size_t i = 0;
+  for (; i + 16 <= N; i += 16) {
+    acc0 = _mm256_add_pd(acc0, _mm256_andnot_pd(signMask, load4(x + i     )));
+    acc1 = _mm256_add_pd(acc1, _mm256_andnot_pd(signMask, load4(x + i +  4)));
+    acc2 = _mm256_add_pd(acc2, _mm256_andnot_pd(signMask, load4(x + i +  8)));
+    acc3 = _mm256_add_pd(acc3, _mm256_andnot_pd(signMask, load4(x + i + 12)));
+  }
+  for (; i + 4 <= N; i += 4) {
+    acc0 = _mm256_add_pd(acc0, _mm256_andnot_pd(signMask, load4(x + i)));
+  }
+
+  double reVal = horizontalSum(acc0, acc1, acc2, acc3);
+  for (; i < N; ++i) {reVal += std::abs(static_cast<double>(x[i]));}
+  return reVal;
+}
+// .......................................................................... //
+template<bool squares>
+TARGET_AVX2 static inline __m256d term4(const __m256d x) {
+  if constexpr (squares) {return _mm256_mul_pd(x, x);}
+  else                   {return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);}
+}
+// .......................................................................... //
+TARGET_AVX2 static inline void neumaierAdd4(__m256d & sum, __m256d & compensation, const __m256d x) {
+  const __m256d t = _mm256_add_pd(sum, x);
+  compensation = _mm256_add_pd(compensation, _mm256_add_pd(_mm256_sub_pd(_mm256_max_pd(sum, x), t), _mm256_min_pd(sum, x)));
+  sum = t;
+}
+// .......................................................................... //
+// the naive sum of the terms of 4 x 4 values
+template<bool squares, class T>
+TARGET_AVX2 static inline __m256d groupSum4(const T * x) {
+  const __m256d x0 = load4(x     ), x1 = load4(x +  4);
+  const __m256d x2 = load4(x +  8), x3 = load4(x + 12);
+  if constexpr (squares) {
+    return _mm256_add_pd(_mm256_fmadd_pd(x1, x1, _mm256_mul_pd(x0, x0)), _mm256_fmadd_pd(x3, x3, _mm256_mul_pd(x2, x2)));
+  }
+  else {
+    return _mm256_add_pd(_mm256_add_pd(term4<false>(x0), term4<false>(x1)), _mm256_add_pd(term4<false>(x2), term4<false>(x3)));
+  }
+}
+// .......................................................................... //
+template<bool squares, class T>
+TARGET_AVX2 static double neumaierSumAVX2(const T * x, const size_t N) {
+  __m256d sum0 = _mm256_setzero_pd(), compensation0 = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd(), compensation1 = _mm256_setzero_pd();
+
+  size_t i = 0;
+  for (; i + 32 <= N; i += 32) {
+    neumaierAdd4(sum0, compensation0, groupSum4<squares>(x + i     ));
+    neumaierAdd4(sum1, compensation1, groupSum4<squares>(x + i + 16));
+  }
+  for (; i + 4 <= N; i += 4) {
+    neumaierAdd4(sum0, compensation0, term4<squares>(load4(x + i)));
+  }
+
+  alignas(32) double sums[9], compensations[9];
+  _mm256_store_pd(sums,              sum0);
+  _mm256_store_pd(sums + 4,          sum1);
+  _mm256_store_pd(compensations,     compensation0);
+  _mm256_store_pd(compensations + 4, compensation1);
+
+  sums[8] = compensations[8] = 0.0;
+  for (; i < N; ++i) {neumaierAdd(sums[8], compensations[8], term<squares>(x[i]));}
+
+  return neumaierMerge(sums, compensations, 9);
+}
+// .......................................................................... //
+template<bool conjugate>
+TARGET_AVX2 static inline void dotStep4(__m256d & re, __m256d & im,
+                                        const double * xr, const double * xi, const double * yr, const double * yi
+) {
+  const __m256d a = _mm256_loadu_pd(xr), b = _mm256_loadu_pd(xi);
+  const __m256d c = _mm256_loadu_pd(yr), d = _mm256_loadu_pd(yi);
+  if constexpr (conjugate) {
+    re = _mm256_fmadd_pd (b, d, _mm256_fmadd_pd(a, c, re));
+    im = _mm256_fnmadd_pd(b, c, _mm256_fmadd_pd(a, d, im));
+  }
+  else {
+    re = _mm256_fnmadd_pd(b, d, _mm256_fmadd_pd(a, c, re));
+    im = _mm256_fmadd_pd (b, c, _mm256_fmadd_pd(a, d, im));
+  }
+}
+// .......................................................................... //
+template<bool conjugate>
+TARGET_AVX2 static std::complex<double> dotAVX2(const double * xr, const double * xi, const double * yr, const double * yi, const size_t N) {
+  __m256d re0 = _mm256_setzero_pd(), im0 = _mm256_setzero_pd();
+  __m256d re1 = _mm256_setzero_pd(), im1 = _mm256_setzero_pd();
+
+  size_t i = 0;
+  for (; i + 8 <= N; i += 8) {
+    dotStep4<conjugate>(re0, im0, xr + i,     xi + i,     yr + i,     yi + i    );
+    dotStep4<conjugate>(re1, im1, xr + i + 4, xi + i + 4, yr + i + 4, yi + i + 4);
+  }
+  for (; i + 4 <= N; i += 4) {
+    dotStep4<conjugate>(re0, im0, xr + i, xi + i, yr + i, yi + i);
+  }
+
+  const __m256d zero = _mm256_setzero_pd();
+  const std::complex<double> tail = dotGeneric<conjugate>(xr + i, xi + i, yr + i, yi + i, N - i);
+  return std::complex<double>(horizontalSum(re0, re1, zero, zero), horizontalSum(im0, im1, zero, zero)) + tail;
+}
+// .......................................................................... //
+// yr, yi += (ar + i ai) * (xr + i xi) for four elements
+TARGET_AVX2 static inline void axpyStep4(const __m256d ar, const __m256d ai, const double * xr, const double * xi, double * yr, double * yi) {
+  const __m256d a = _mm256_loadu_pd(xr), b = _mm256_loadu_pd(xi);
+  _mm256_storeu_pd(yr, _mm256_fmadd_pd(ar, a, _mm256_fnmadd_pd(ai, b, _mm256_loadu_pd(yr))));
+  _mm256_storeu_pd(yi, _mm256_fmadd_pd(ar, b, _mm256_fmadd_pd (ai, a, _mm256_loadu_pd(yi))));
+}
+// .......................................................................... //
+TARGET_AVX2 static void axpyAVX2(const double ar, const double ai, const double * xr, const double * xi, double * yr, double * yi, const size_t N) {
+  const __m256d vr = _mm256_set1_pd(ar), vi = _mm256_set1_pd(ai);
+
+  size_t i = 0;
+  for (; i + 8 <= N; i += 8) {
+    axpyStep4(vr, vi, xr + i,     xi + i,     yr + i,     yi + i    );
+    axpyStep4(vr, vi, xr + i + 4, xi + i + 4, yr + i + 4, yi + i + 4);
+  }
+  for (; i + 4 <= N; i += 4) {
+    axpyStep4(vr, vi, xr + i, xi + i, yr + i, yi + i);
+  }
+  axpyLoop(ar, ai, xr + i, xi + i, yr + i, yi + i, N - i);
+}
+// .......................................................................... //
+// zr, zi = (xr + i xi) * (yr + i yi) for four elements; all loads precede the stores, so z may alias x or y
+TARGET_AVX2 static inline void multiplyStep4(const double * xr, const double * xi, const double * yr, const double * yi, double * zr, double * zi) {
+  const __m256d a = _mm256_loadu_pd(xr), b = _mm256_loadu_pd(xi);
+  const __m256d c = _mm256_loadu_pd(yr), d = _mm256_loadu_pd(yi);
+  const __m256d re = _mm256_fmsub_pd(a, c, _mm256_mul_pd(b, d));
+  const __m256d im = _mm256_fmadd_pd(a, d, _mm256_mul_pd(b, c));
+  _mm256_storeu_pd(zr, re);
+  _mm256_storeu_pd(zi, im);
+}
+// .......................................................................... //
+TARGET_AVX2 static void multiplyAVX2(const double * xr, const double * xi, const double * yr, const double * yi, double * zr, double * zi, const size_t N) {
+  size_t i = 0;
+  for (; i + 8 <= N; i += 8) {
+    multiplyStep4(xr + i,     xi + i,     yr + i,     yi + i,     zr + i,     zi + i    );
+    multiplyStep4(xr + i + 4, xi + i + 4, yr + i + 4, yi + i + 4, zr + i + 4, zi + i + 4);
+  }
+  for (; i + 4 <= N; i += 4) {
+    multiplyStep4(xr + i, xi + i, yr + i, yi + i, zr + i, zi + i);
+  }
+  multiplyLoop(xr + i, xi + i, yr + i, yi + i, zr + i, zi + i, N - i);
+}
+
+// -------------------------------------------------------------------------- //
+// AVX-512 kernels
+
+BCG_AVX512_BEGIN
+
+// loads up to 8 values as doubles, filling the lanes beyond N with zeros
+TARGET_AVX512 static inline __m512d load8(const double * x) {return _mm512_loadu_pd(x);}
+TARGET_AVX512 static inline __m512d load8(const float  * x) {return _mm512_cvtps_pd(_mm256_loadu_ps(x));}
+TARGET_AVX512 static inline __m512d load8(const double * x, const __mmask8 mask) {return _mm512_maskz_loadu_pd(mask, x);}
+TARGET_AVX512 static inline __m512d load8(const float  * x, const __mmask8 mask) {return _mm512_cvtps_pd(_mm512_castps512_ps256(_mm512_maskz_loadu_ps(mask, x)));}
+// .......................................................................... //
+template<class T>
+TARGET_AVX512 static double modSquareSumAVX512(const T * x, const size_t N) {
+  __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+  __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+
+  size_t i = 0;
+  for (; i + 32 <= N; i += 32) {
+    const __m512d x0 = load8(x + i     ), x1 = load8(x + i +  8);
+    const __m512d x2 = load8(x + i + 16), x3 = load8(x + i + 24);
+    acc0 = _mm512_fmadd_pd(x0, x0, acc0);
+    acc1 = _mm512_fmadd_pd(x1, x1, acc1);
+    acc2 = _mm512_fmadd_pd(x2, x2, acc2);
+    acc3 = _mm512_fmadd_pd(x3, x3, acc3);
+  }
+  for (; i < N; i += 8) {
+    const __mmask8 mask = (N - i >= 8) ? 0xFF : (1u << (N - i)) - 1;
+    const __m512d  x0   = load8(x + i, mask);
+    acc0 = _mm512_fmadd_pd(x0, x0, acc0);
+  }
+
+  return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+}
+// .......................................................................... //
+template<class T>
+TARGET_AVX512 static double absSumAVX512(const T * x, const size_t N) {
+  __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+  __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+
+  size_t i = 0;
+  for (; i + 32 <= N; i += 32) {
+    acc0 = _mm512_add_pd(acc0, _mm512_abs_pd(load8(x + i     )));
+    acc1 = _mm512_add_pd(acc1, _mm512_abs_pd(load8(x + i +  8)));
+    acc2 = _mm512_add_pd(acc2, _mm512_abs_pd(load8(x + i + 16)));
+    acc3 = _mm512_add_pd(acc3, _mm512_abs_pd(load8(x + i + 24)));
+  }
+  for (; i < N; i += 8) {
+    const __mmask8 mask = (N - i >= 8) ? 0xFF : (1u << (N - i)) - 1;
+    acc0 = _mm512_add_pd(acc0, _mm512_abs_pd(load8(x + i, mask)));
+  }
+
+  return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+}
+// .......................................................................... //
+template<bool squares>
+TARGET_AVX512 static inline __m512d term8(const __m512d x) {
+  if constexpr (squares) {return _mm512_mul_pd(x, x);}
+  else                   {return _mm512_abs_pd(x);}
+}
+// .......................................................................... //
+TARGET_AVX512 static inline void neumaierAdd8(__m512d & sum, __m512d & compensation, const __m512d x) {
+  const __m512d t = _mm512_add_pd(sum, x);
+  compensation = _mm512_add_pd(compensation, _mm512_add_pd(_mm512_sub_pd(_mm512_max_pd(sum, x), t), _mm512_min_pd(sum, x)));
+  sum = t;
+}
+// .......................................................................... //
+// the naive sum of the terms of 4 x 8 values
+template<bool squares, class T>
+TARGET_AVX512 static inline __m512d groupSum8(const T * x) {
+  const __m512d x0 = load8(x     ), x1 = load8(x +  8);
+  const __m512d x2 = load8(x + 16), x3 = load8(x + 24);
+  if constexpr (squares) {
+    return _mm512_add_pd(_mm512_fmadd_pd(x1, x1, _mm512_mul_pd(x0, x0)), _mm512_fmadd_pd(x3, x3, _mm512_mul_pd(x2, x2)));
+  }
+  else {
+    return _mm512_add_pd(_mm512_add_pd(term8<false>(x0), term8<false>(x1)), _mm512_add_pd(term8<false>(x2), term8<false>(x3)));
+  }
+}
+// .......................................................................... //
+template<bool squares, class T>
+TARGET_AVX512 static double neumaierSumAVX512(const T * x, const size_t N) {
+  __m512d sum0 = _mm512_setzero_pd(), compensation0 = _mm512_setzero_pd();
+  __m512d sum1 = _mm512_setzero_pd(), compensation1 = _mm512_setzero_pd();
+
+  size_t i = 0;
+  for (; i + 64 <= N; i += 64) {
+    neumaierAdd8(sum0, compensation0, groupSum8<squares>(x + i     ));
+    neumaierAdd8(sum1, compensation1, groupSum8<squares>(x + i + 32));
+  }
+  for (; i < N; i += 8) {
+    const __mmask8 mask = (N - i >= 8) ? 0xFF : (1u << (N - i)) - 1;
+    neumaierAdd8(sum0, compensation0, term8<squares>(load8(x + i, mask)));
+  }
+
+  alignas(64) double sums[16], compensations[16];
+  _mm512_store_pd(sums,              sum0);
+  _mm512_store_pd(sums + 8,          sum1);
+  _mm512_store_pd(compensations,     compensation0);
+  _mm512_store_pd(compensations + 8, compensation1);
+
+  return neumaierMerge(sums, compensations, 16);
+}
+// .......................................................................... //
+template<bool conjugate>
+TARGET_AVX512 static inline void dotStep8(__m512d & re, __m512d & im, const __mmask8 mask,
+                                          const double * xr, const double * xi, const double * yr, const double * yi
+) {
+  const __m512d a = _mm512_maskz_loadu_pd(mask, xr), b = _mm512_maskz_loadu_pd(mask, xi);
+  const __m512d c = _mm512_maskz_loadu_pd(mask, yr), d = _mm512_maskz_loadu_pd(mask, yi);
+  if constexpr (conjugate) {
+    re = _mm512_fmadd_pd (b, d, _mm512_fmadd_pd(a, c, re));
+    im = _mm512_fnmadd_pd(b, c, _mm512_fmadd_pd(a, d, im));
+  }
+  else {
+    re = _mm512_fnmadd_pd(b, d, _mm512_fmadd_pd(a, c, re));
+    im = _mm512_fmadd_pd (b, c, _mm512_fmadd_pd(a, d, im));
+  }
+}
+// .......................................................................... //
+template<bool conjugate>
+TARGET_AVX512 static std::complex<double> dotAVX512(const double * xr, const double * xi, const double * yr, const double * yi, const size_t N) {
+  __m512d re0 = _mm512_setzero_pd(), im0 = _mm512_setzero_pd();
+  __m512d re1 = _mm512_setzero_pd(), im1 = _mm512_setzero_pd();
+
+  size_t i = 0;
+  for (; i + 16 <= N; i += 16) {
+    dotStep8<conjugate>(re0, im0, 0xFF, xr + i,     xi + i,     yr + i,     yi + i    );
+    dotStep8<conjugate>(re1, im1, 0xFF, xr + i + 8, xi + i + 8, yr + i + 8, yi + i + 8);
+  }
+  for (; i < N; i += 8) {
+    const __mmask8 mask = (N - i >= 8) ? 0xFF : (1u << (N - i)) - 1;
+    dotStep8<conjugate>(re0, im0, mask, xr + i, xi + i, yr + i, yi + i);
+  }
+
+  return std::complex<double>(_mm512_reduce_add_pd(_mm512_add_pd(re0, re1)), _mm512_reduce_add_pd(_mm512_add_pd(im0, im1)));
+}
+// .......................................................................... //
+TARGET_AVX512 static inline void axpyStep8(const __m512d ar, const __m512d ai, const __mmask8 mask,
+                                           const double * xr, const double * xi, double * yr, double * yi
+) {
+  const __m512d a = _mm512_maskz_loadu_pd(mask, xr), b = _mm512_maskz_loadu_pd(mask, xi);
+  _mm512_mask_storeu_pd(yr, mask, _mm512_fmadd_pd(ar, a, _mm512_fnmadd_pd(ai, b, _mm512_maskz_loadu_pd(mask, yr))));
+  _mm512_mask_storeu_pd(yi, mask, _mm512_fmadd_pd(ar, b, _mm512_fmadd_pd (ai, a, _mm512_maskz_loadu_pd(mask, yi))));
+}
+// .......................................................................... //
+TARGET_AVX512 static void axpyAVX512(const double ar, const double ai, const double * xr, const double * xi, double * yr, double * yi, const size_t N) {
+  const __m512d vr = _mm512_set1_pd(ar), vi = _mm512_set1_pd(ai);
+
+  size_t i = 0;
+  for (; i + 16 <= N; i += 16) {
+    axpyStep8(vr, vi, 0xFF, xr + i,     xi + i,     yr + i,     yi + i    );
+    axpyStep8(vr, vi, 0xFF, xr + i + 8, xi + i + 8, yr + i + 8, yi + i + 8);
+  }
+  for (; i < N; i += 8) {
+    const __mmask8 mask = (N - i >= 8) ? 0xFF : (1u << (N - i)) - 1;
+    axpyStep8(vr, vi, mask, xr + i, xi + i, yr + i, yi + i);
+  }
+}
+// .......................................................................... //
+TARGET_AVX512 static inline void multiplyStep8(const __mmask8 mask,
+                                               const double * xr, const double * xi, const double * yr, const double * yi,
+                                               double * zr, double * zi
+) {
+  const __m512d a = _mm512_maskz_loadu_pd(mask, xr), b = _mm512_maskz_loadu_pd(mask, xi);
+  const __m512d c = _mm512_maskz_loadu_pd(mask, yr), d = _mm512_maskz_loadu_pd(mask, yi);
+  const __m512d re = _mm512_fmsub_pd(a, c, _mm512_mul_pd(b, d));
+  const __m512d im = _mm512_fmadd_pd(a, d, _mm512_mul_pd(b, c));
+  _mm512_mask_storeu_pd(zr, mask, re);
+  _mm512_mask_storeu_pd(zi, mask, im);
+}
+// .......................................................................... //
+TARGET_AVX512 static void multiplyAVX512(const double * xr, const double * xi, const double * yr, const double * yi, double * zr, double * zi, const size_t N) {
+  size_t i = 0;
+  for (; i + 16 <= N; i += 16) {
+    multiplyStep8(0xFF, xr + i,     xi + i,     yr + i,     yi + i,     zr + i,     zi + i    );
+    multiplyStep8(0xFF, xr + i + 8, xi + i + 8, yr + i + 8, yi + i + 8, zr + i + 8, zi + i + 8);
+  }
+  for (; i < N; i += 8) {
+    const __mmask8 mask = (N - i >= 8) ? 0xFF : (1u << (N - i)) - 1;
+    multiplyStep8(mask, xr + i, xi + i, yr + i, yi + i, zr + i, zi + i);
+  }
+}
+BCG_AVX512_END
+#endif
+
+// -------------------------------------------------------------------------- //
+// dispatch
+
+template<class T>
+static double modSquareSumNaive(const T * x, const size_t N) {
+  switch (simdLevel()) {
+#ifdef BCG_X86_SIMD
+    case SimdLevel::AVX512 : return modSquareSumAVX512(x, N);
+    case SimdLevel::AVX2   : return modSquareSumAVX2  (x, N);
+#endif
+    default                : return modSquareSumGeneric(x, N);
+  }
+}
+// .......................................................................... //
+template<class T>
+static double absSumNaive(const T * x, const size_t N) {
+  switch (simdLevel()) {
+#ifdef BCG_X86_SIMD
+    case SimdLevel::AVX512 : return absSumAVX512(x, N);
+    case SimdLevel::AVX2   : return absSumAVX2  (x, N);
+#endif
+    default                : return absSumGeneric(x, N);
+  }
+}
+// .......................................................................... //
+template<bool squares, class T>
+static double neumaierSum(const T * x, const size_t N) {
+  switch (simdLevel()) {
+#ifdef BCG_X86_SIMD
+    case SimdLevel::AVX512 : return neumaierSumAVX512<squares>(x, N);
+    case SimdLevel::AVX2   : return neumaierSumAVX2  <squares>(x, N);
+#endif
+    default                : return neumaierSumGeneric<squares>(x, N);
+  }
+}
+// .......................................................................... //
+// naive sums of blocks, merged like a binary counter, cf. BCG::summation
+template<class T, class Kernel>
+static double pairwiseSum(const T * x, const size_t N, Kernel naive) {
+  constexpr size_t blockSize = 1024;
+
+  double partials[64];
+  size_t height  = 0;
+  size_t nBlocks = 0;
+
+  for (size_t i = 0; i < N; i += blockSize) {
+    double block = naive(x + i, std::min(blockSize, N - i));
+
+    ++nBlocks;
+    for (size_t n = nBlocks; (n & 1) == 0; n >>= 1) {block = partials[--height] + block;}
+    partials[height++] = block;
+  }
+
+  double reVal = 0.0;
+  while (height) {reVal = partials[--height] + reVal;}
+  return reVal;
+}
+// .......................................................................... //
+template<class T>
+static double modSquareSum(const T * x, const size_t N, const BCG::SummationMode mode) {
+  switch (mode) {
+    case BCG::SummationMode::Pairwise : return pairwiseSum(x, N, modSquareSumNaive<T>);
+    case BCG::SummationMode::Neumaier : return neumaierSum<true>(x, N);
+    default                           : return modSquareSumNaive(x, N);
+  }
+}
+// .......................................................................... //
+template<class T>
+static double absSum(const T * x, const size_t N, const BCG::SummationMode mode) {
+  switch (mode) {
+    case BCG::SummationMode::Pairwise : return pairwiseSum(x, N, absSumNaive<T>);
+    case BCG::SummationMode::Neumaier : return neumaierSum<false>(x, N);
+    default                           : return absSumNaive(x, N);
+  }
+}
+
+// .......................................................................... //
+template<bool conjugate>
+static std::complex<double> dot(const double * xr, const double * xi, const double * yr, const double * yi, const size_t N) {
+  switch (simdLevel()) {
+#ifdef BCG_X86_SIMD
+    case SimdLevel::AVX512 : return dotAVX512<conjugate>(xr, xi, yr, yi, N);
+    case SimdLevel::AVX2   : return dotAVX2  <conjugate>(xr, xi, yr, yi, N);
+#endif
+    default                : return dotGeneric<conjugate>(xr, xi, yr, yi, N);
+  }
+}
+// .......................................................................... //
+static void axpy(const double ar, const double ai, const double * xr, const double * xi, double * yr, double * yi, const size_t N) {
+  switch (simdLevel()) {
+#ifdef BCG_X86_SIMD
+    case SimdLevel::AVX512 : return axpyAVX512(ar, ai, xr, xi, yr, yi, N);
+    case SimdLevel::AVX2   : return axpyAVX2  (ar, ai, xr, xi, yr, yi, N);
+#endif
+    default                : return axpyLoop  (ar, ai, xr, xi, yr, yi, N);
+  }
+}
+// .......................................................................... //
+static void multiply(const double * xr, const double * xi, const double * yr, const double * yi, double * zr, double * zi, const size_t N) {
+  switch (simdLevel()) {
+#ifdef BCG_X86_SIMD
+    case SimdLevel::AVX512 : return multiplyAVX512(xr, xi, yr, yi, zr, zi, N);
+    case SimdLevel::AVX2   : return multiplyAVX2  (xr, xi, yr, yi, zr, zi, N);
+#endif
+    default                : return multiplyLoop  (xr, xi, yr, yi, zr, zi, N);
+  }
+}
+
+// -------------------------------------------------------------------------- //
+// combinatorics
+
+static const std::array<double, 1024> logFactorialTable = [] () {
+  std::array<double, 1024> reVal;
+  for (size_t n = 0; n < reVal.size(); ++n) {reVal[n] = std::lgamma(n + 1.0);}
+  return reVal;
+}();
+
+// ========================================================================== //
+// procs
+
+double BCG::norm_modSquareSum_real(const double * begin, const double * end, const SummationMode mode) {return modSquareSum(begin, end - begin, mode);}
+double BCG::norm_modSquareSum_real(const float  * begin, const float  * end, const SummationMode mode) {return modSquareSum(begin, end - begin, mode);}
+// .......................................................................... //
+double BCG::norm_absSum_real      (const double * begin, const double * end, const SummationMode mode) {return absSum      (begin, end - begin, mode);}
+double BCG::norm_absSum_real      (const float  * begin, const float  * end, const SummationMode mode) {return absSum      (begin, end - begin, mode);}
+
+// -------------------------------------------------------------------------- //
+// pairwise distances
+
+std::vector<double> BCG::flatten_points(const std::vector<std::vector<double>> & points, const size_t dim) {
+  std::vector<double> reVal;
+  reVal.reserve(points.size() * dim);
+  for (const auto & point : points) {
+    if (point.size() != dim) {
+      throw std::invalid_argument(THROWTEXT("    points are not of same dimension!"));
+    }
+    reVal.insert(reVal.end(), point.begin(), point.end());
+  }
+  return reVal;
+}
+
+// -------------------------------------------------------------------------- //
+// split complex vectors
+
+BCG::ComplexVector::ComplexVector(const size_t N) : re(N), im(N) {}
+// .......................................................................... //
+BCG::ComplexVector::ComplexVector(const std::vector<complex_d_t> & interleaved) : re(interleaved.size()), im(interleaved.size()) {
+  for (size_t i = 0; i < interleaved.size(); ++i) {
+    re[i] = interleaved[i].real();
+    im[i] = interleaved[i].imag();
+  }
+}
+// .......................................................................... //
+std::vector<BCG::complex_d_t> BCG::ComplexVector::to_interleaved() const {
+  std::vector<complex_d_t> reVal(re.size());
+  for (size_t i = 0; i < re.size(); ++i) {reVal[i] = complex_d_t(re[i], im[i]);}
+  return reVal;
+}
+// .......................................................................... //
+void BCG::ComplexVector::resize(const size_t N) {
+  re.resize(N, 0.0);
+  im.resize(N, 0.0);
+}
+// .......................................................................... //
+double BCG::norm_modSquareSum(const ComplexVector & x, const SummationMode mode) {
+  return modSquareSum(x.real(), x.size(), mode) + modSquareSum(x.imag(), x.size(), mode);
+}
+// .......................................................................... //
+double BCG::norm_Euclidean(const ComplexVector & x, const SummationMode mode) {return std::sqrt(BCG::norm_modSquareSum(x, mode));}
+// .......................................................................... //
+BCG::complex_d_t BCG::dot(const ComplexVector & x, const ComplexVector & y) {
+  if (x.size() != y.size()) {throw std::invalid_argument(THROWTEXT("    vectors are not of same dimension!"));}
+  return ::dot<false>(x.real(), x.imag(), y.real(), y.imag(), x.size());
+}
+// .......................................................................... //
+BCG::complex_d_t BCG::vdot(const ComplexVector & x, const ComplexVector & y) {
+  if (x.size() != y.size()) {throw std::invalid_argument(THROWTEXT("    vectors are not of same dimension!"));}
+  return ::dot<true>(x.real(), x.imag(), y.real(), y.imag(), x.size());
+}
+// .......................................................................... //
+void BCG::axpy(const complex_d_t a, const ComplexVector & x, ComplexVector & y) {
+  if (x.size() != y.size()) {throw std::invalid_argument(THROWTEXT("    vectors are not of same dimension!"));}
+  ::axpy(a.real(), a.imag(), x.real(), x.imag(), y.real(), y.imag(), x.size());
+}
+// .......................................................................... //
+void BCG::multiply(const ComplexVector & x, const ComplexVector & y, ComplexVector & z) {
+  if (x.size() != y.size()) {throw std::invalid_argument(THROWTEXT("    vectors are not of same dimension!"));}
+
+  z.resize(x.size());
+  ::multiply(x.real(), x.imag(), y.real(), y.imag(), z.real(), z.imag(), x.size());
+}
+// .......................................................................... //
+BCG::ComplexVector BCG::multiply(const ComplexVector & x, const ComplexVector & y) {
+  ComplexVector reVal;
+  BCG::multiply(x, y, reVal);
+  return reVal;
+}
+
+// -------------------------------------------------------------------------- //
+// combinatorics
+
+double BCG::logFactorial(const unsigned long long n) {
+  if (n < logFactorialTable.size()) {return logFactorialTable[n];}
+  return std::lgamma(n + 1.0);
+}
+// .......................................................................... //
+void BCG::multinomial(const unsigned int * k, const size_t nVectors, const size_t m, unsigned long long * result) {
+  for (size_t i = 0; i < nVectors; ++i) {result[i] = BCG::multinomial(k + i * m, k + i * m + m);}
+}
+// .......................................................................... //
+void BCG::logMultinomial(const unsigned int * k, const size_t nVectors, const size_t m, double * result) {
+  for (size_t i = 0; i < nVectors; ++i) {result[i] = BCG::logMultinomial(k + i * m, k + i * m + m);}
+}
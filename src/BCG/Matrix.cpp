@@ -0,0 +1,322 @@
+// ========================================================================= //
+// dependencies
+
+// STL
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+
+// own
+#include "BCG.hpp"
+#include "Simd.hpp"
+
+// ========================================================================== //
+// local macro
+
+#define THROWTEXT(msg) (std::string("RUNTIME EXCEPTION IN ") + (__PRETTY_FUNCTION__) + "\n" + msg)
+
+// ========================================================================== //
+// local procs
+
+/* The matrix product follows the usual scheme of optimized BLAS libraries: B
+ * is packed into panels of NR columns and A, block by block, into panels of
+ * MR rows, both ordered such that the kernel reads them strictly
+ * sequentially. The kernel computes an MR x NR tile of the product in
+ * registers over KC steps of the inner index; a panel of B then stays in the
+ * L1 cache and a block of A in the L2 cache. Edge tiles are computed in full
+ * on zero padded panels and only partially added to the result.
+ *
+ * As in the Maths module, each kernel exists in a generic, an AVX2 and an
+ * AVX-512 version, selected at runtime.
+ */
+
+// -------------------------------------------------------------------------- //
+// generic kernels
+
+static void gemmKernelGeneric(const size_t kb, const double * a, const double * b, double * tile) {
+  double acc[4][4] = {};
+
+  for (size_t p = 0; p < kb; ++p, a += 4, b += 4) {
+    for   (size_t ir = 0; ir < 4; ++ir) {
+      for (size_t jr = 0; jr < 4; ++jr) {acc[ir][jr] += a[ir] * b[jr];}
+    }
+  }
+
+  for   (size_t ir = 0; ir < 4; ++ir) {
+    for (size_t jr = 0; jr < 4; ++jr) {tile[ir * 4 + jr] = acc[ir][jr];}
+  }
+}
+// .......................................................................... //
+static void rowDotsGeneric(const double * const * rows, const double * x, const size_t N, double * y) {
+  double acc[4] = {0.0, 0.0, 0.0, 0.0};
+
+  for   (size_t j = 0; j < N; ++j) {
+    for (size_t r = 0; r < 4; ++r) {acc[r] += rows[r][j] * x[j];}
+  }
+
+  for (size_t r = 0; r < 4; ++r) {y[r] = acc[r];}
+}
+
+#ifdef BCG_X86_SIMD
+// -------------------------------------------------------------------------- //
+// AVX2 kernels
+
+TARGET_AVX2 static inline double horizontalSum(const __m256d x) {
+  const __m128d half = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+}
+// .......................................................................... //
+// one row of the tile: c0, c1 += a * (b0, b1)
+TARGET_AVX2 static inline void gemmRowAVX2(const double * a, const __m256d b0, const __m256d b1, __m256d & c0, __m256d & c1) {
+  const __m256d ai = _mm256_broadcast_sd(a);
+  c0 = _mm256_fmadd_pd(ai, b0, c0);
+  c1 = _mm256_fmadd_pd(ai, b1, c1);
+}
+// .......................................................................... //
+// 6 x 8 tile in 12 registers. Named accumulators, as GCC does not keep an
+// array of vectors in registers.
+TARGET_AVX2 static void gemmKernelAVX2(const size_t kb, const double * a, const double * b, double * tile) {
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+  __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+  for (size_t p = 0; p < kb; ++p, a += 6, b += 8) {
+    const __m256d b0 = _mm256_loadu_pd(b);
+    const __m256d b1 = _mm256_loadu_pd(b + 4);
+    gemmRowAVX2(a,     b0, b1, c00, c01);
+    gemmRowAVX2(a + 1, b0, b1, c10, c11);
+    gemmRowAVX2(a + 2, b0, b1, c20, c21);
+    gemmRowAVX2(a + 3, b0, b1, c30, c31);
+    gemmRowAVX2(a + 4, b0, b1, c40, c41);
+    gemmRowAVX2(a + 5, b0, b1, c50, c51);
+  }
+
+  _mm256_storeu_pd(tile,      c00); _mm256_storeu_pd(tile +  4, c01);
+  _mm256_storeu_pd(tile +  8, c10); _mm256_storeu_pd(tile + 12, c11);
+  _mm256_storeu_pd(tile + 16, c20); _mm256_storeu_pd(tile + 20, c21);
+  _mm256_storeu_pd(tile + 24, c30); _mm256_storeu_pd(tile + 28, c31);
+  _mm256_storeu_pd(tile + 32, c40); _mm256_storeu_pd(tile + 36, c41);
+  _mm256_storeu_pd(tile + 40, c50); _mm256_storeu_pd(tile + 44, c51);
+}
+// .......................................................................... //
+TARGET_AVX2 static void rowDotsAVX2(const double * const * rows, const double * x, const size_t N, double * y) {
+  const double * row0 = rows[0], * row1 = rows[1], * row2 = rows[2], * row3 = rows[3];
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd(), acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+
+  size_t j = 0;
+  for (; j + 4 <= N; j += 4) {
+    const __m256d xj = _mm256_loadu_pd(x + j);
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(row0 + j), xj, acc0);
+    acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(row1 + j), xj, acc1);
+    acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(row2 + j), xj, acc2);
+    acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(row3 + j), xj, acc3);
+  }
+
+  y[0] = horizontalSum(acc0);
+  y[1] = horizontalSum(acc1);
+  y[2] = horizontalSum(acc2);
+  y[3] = horizontalSum(acc3);
+  for (; j < N; ++j) {
+    y[0] += row0[j] * x[j];
+    y[1] += row1[j] * x[j];
+    y[2] += row2[j] * x[j];
+    y[3] += row3[j] * x[j];
+  }
+}
+
+// -------------------------------------------------------------------------- //
+// AVX-512 kernels
+
+BCG_AVX512_BEGIN
+
+// one row of the tile: c0, c1 += a * (b0, b1)
+TARGET_AVX512 static inline void gemmRowAVX512(const double * a, const __m512d b0, const __m512d b1, __m512d & c0, __m512d & c1) {
+  const __m512d ai = _mm512_set1_pd(*a);
+  c0 = _mm512_fmadd_pd(ai, b0, c0);
+  c1 = _mm512_fmadd_pd(ai, b1, c1);
+}
+// .......................................................................... //
+// 8 x 16 tile in 16 registers
+TARGET_AVX512 static void gemmKernelAVX512(const size_t kb, const double * a, const double * b, double * tile) {
+  __m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd();
+  __m512d c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd();
+  __m512d c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd();
+  __m512d c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd();
+  __m512d c40 = _mm512_setzero_pd(), c41 = _mm512_setzero_pd();
+  __m512d c50 = _mm512_setzero_pd(), c51 = _mm512_setzero_pd();
+  __m512d c60 = _mm512_setzero_pd(), c61 = _mm512_setzero_pd();
+  __m512d c70 = _mm512_setzero_pd(), c71 = _mm512_setzero_pd();
+
+  for (size_t p = 0; p < kb; ++p, a += 8, b += 16) {
+    const __m512d b0 = _mm512_loadu_pd(b);
+    const __m512d b1 = _mm512_loadu_pd(b + 8);
+    gemmRowAVX512(a,     b0, b1, c00, c01);
+    gemmRowAVX512(a + 1, b0, b1, c10, c11);
+    gemmRowAVX512(a + 2, b0, b1, c20, c21);
+    gemmRowAVX512(a + 3, b0, b1, c30, c31);
+    gemmRowAVX512(a + 4, b0, b1, c40, c41);
+    gemmRowAVX512(a + 5, b0, b1, c50, c51);
+    gemmRowAVX512(a + 6, b0, b1, c60, c61);
+    gemmRowAVX512(a + 7, b0, b1, c70, c71);
+  }
+
+  _mm512_storeu_pd(tile,       c00); _mm512_storeu_pd(tile +   8, c01);
+  _mm512_storeu_pd(tile +  16, c10); _mm512_storeu_pd(tile +  24, c11);
+  _mm512_storeu_pd(tile +  32, c20); _mm512_storeu_pd(tile +  40, c21);
+  _mm512_storeu_pd(tile +  48, c30); _mm512_storeu_pd(tile +  56, c31);
+  _mm512_storeu_pd(tile +  64, c40); _mm512_storeu_pd(tile +  72, c41);
+  _mm512_storeu_pd(tile +  80, c50); _mm512_storeu_pd(tile +  88, c51);
+  _mm512_storeu_pd(tile +  96, c60); _mm512_storeu_pd(tile + 104, c61);
+  _mm512_storeu_pd(tile + 112, c70); _mm512_storeu_pd(tile + 120, c71);
+}
+// .......................................................................... //
+TARGET_AVX512 static void rowDotsAVX512(const double * const * rows, const double * x, const size_t N, double * y) {
+  const double * row0 = rows[0], * row1 = rows[1], * row2 = rows[2], * row3 = rows[3];
+  __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd(), acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+
+  size_t j = 0;
+  for (; j + 8 <= N; j += 8) {
+    const __m512d xj = _mm512_loadu_pd(x + j);
+    acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(row0 + j), xj, acc0);
+    acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(row1 + j), xj, acc1);
+    acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(row2 + j), xj, acc2);
+    acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(row3 + j), xj, acc3);
+  }
+  if (j < N) {
+    const __mmask8 mask = (1u << (N - j)) - 1;
+    const __m512d  xj   = _mm512_maskz_loadu_pd(mask, x + j);
+    acc0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, row0 + j), xj, acc0);
+    acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, row1 + j), xj, acc1);
+    acc2 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, row2 + j), xj, acc2);
+    acc3 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, row3 + j), xj, acc3);
+  }
+
+  y[0] = _mm512_reduce_add_pd(acc0);
+  y[1] = _mm512_reduce_add_pd(acc1);
+  y[2] = _mm512_reduce_add_pd(acc2);
+  y[3] = _mm512_reduce_add_pd(acc3);
+}
+BCG_AVX512_END
+#endif
+
+// -------------------------------------------------------------------------- //
+// drivers
+
+template<size_t MR, size_t NR, class Kernel>
+static void gemm(const BCG::MatrixView<const double> & A, const BCG::MatrixView<const double> & B, double * C, const unsigned int threads, Kernel kernel) {
+  constexpr size_t KC = 256;
+  constexpr size_t MC = 96;
+
+  const size_t M = A.rows(), N = B.cols(), K = A.cols();
+  const size_t nPanelsB = (N + NR - 1) / NR;
+
+  // The rows p0 ... p0 + kb of B occupy [p0 * nPanelsB * NR, (p0 + kb) * nPanelsB * NR),
+  // panel jp therein starts at jp * kb * NR and holds the element (p, jr) at p * NR + jr.
+  std::vector<double> packedB(K * nPanelsB * NR, 0.0);
+  for     (size_t p0 = 0; p0 < K; p0 += KC) {
+    const size_t kb = std::min(KC, K - p0);
+    for   (size_t j = 0; j < N; ++j) {
+      double * panel = packedB.data() + p0 * nPanelsB * NR + (j / NR) * kb * NR + j % NR;
+      for (size_t p = 0; p < kb; ++p) {panel[p * NR] = B(p0 + p, j);}
+    }
+  }
+
+  const size_t nRowBlocks = (M + MC - 1) / MC;
+  BCG::parallel_for(nRowBlocks, [&] (const size_t rowBlockID) {
+    const size_t i0       = rowBlockID * MC;
+    const size_t mb       = std::min(MC, M - i0);
+    const size_t nPanelsA = (mb + MR - 1) / MR;
+
+    std::vector<double> packedA(nPanelsA * MR * KC);
+    alignas(64) double  tile[MR * NR];
+
+    for (size_t p0 = 0; p0 < K; p0 += KC) {
+      const size_t kb = std::min(KC, K - p0);
+
+      // panel ip holds the element (ir, p) at ip * kb * MR + p * MR + ir
+      std::fill(packedA.begin(), packedA.end(), 0.0);
+      for   (size_t i = 0; i < mb; ++i) {
+        double * panel = packedA.data() + (i / MR) * kb * MR + i % MR;
+        for (size_t p = 0; p < kb; ++p) {panel[p * MR] = A(i0 + i, p0 + p);}
+      }
+
+      for   (size_t jp = 0; jp < nPanelsB; ++jp) {
+        const double * panelB = packedB.data() + p0 * nPanelsB * NR + jp * kb * NR;
+        const size_t   nr     = std::min(NR, N - jp * NR);
+
+        for (size_t ip = 0; ip < nPanelsA; ++ip) {
+          kernel(kb, packedA.data() + ip * kb * MR, panelB, tile);
+
+          const size_t mr = std::min(MR, mb - ip * MR);
+          double *     c  = C + (i0 + ip * MR) * N + jp * NR;
+          for   (size_t ir = 0; ir < mr; ++ir) {
+            for (size_t jr = 0; jr < nr; ++jr) {c[ir * N + jr] += tile[ir * NR + jr];}
+          }
+        }
+      }
+    }
+  }, threads);
+}
+// .......................................................................... //
+template<class Kernel>
+static void rowDots(const BCG::MatrixView<const double> & A, const double * x, double * y, Kernel kernel) {
+  const size_t M = A.rows(), N = A.cols();
+
+  for (size_t i = 0; i < M; i += 4) {
+    // repeat the last row to fill up the group of four
+    const double * rows[4];
+    for (size_t r = 0; r < 4; ++r) {rows[r] = &A(std::min(i + r, M - 1), 0);}
+
+    double result[4];
+    kernel(rows, x, N, result);
+    std::copy(result, result + std::min<size_t>(4, M - i), y + i);
+  }
+}
+
+// ========================================================================== //
+// procs
+
+BCG::Matrix<double> BCG::multiply(const MatrixView<const double> & A, const MatrixView<const double> & B, unsigned int threads) {
+  if (A.cols() != B.rows()) {throw std::invalid_argument(THROWTEXT("    matrices are not of compatible dimensions!"));}
+
+  Matrix<double> reVal(A.rows(), B.cols(), 0.0);
+  if (reVal.size() == 0 || A.cols() == 0) {return reVal;}
+
+  switch (simdLevel()) {
+#ifdef BCG_X86_SIMD
+    case SimdLevel::AVX512 : gemm<8, 16>(A, B, reVal.data(), threads, gemmKernelAVX512); break;
+    case SimdLevel::AVX2   : gemm<6,  8>(A, B, reVal.data(), threads, gemmKernelAVX2  ); break;
+#endif
+    default                : gemm<4,  4>(A, B, reVal.data(), threads, gemmKernelGeneric); break;
+  }
+
+  return reVal;
+}
+// .......................................................................... //
+std::vector<double> BCG::multiply(const MatrixView<const double> & A, const std::vector<double> & x) {
+  if (A.cols() != x.size()) {throw std::invalid_argument(THROWTEXT("    matrix and vector are not of compatible dimensions!"));}
+
+  const size_t M = A.rows(), N = A.cols();
+  std::vector<double> reVal(M, 0.0);
+  if (M == 0 || N == 0) {return reVal;}
+
+  if (A.colStride() != 1) {
+    for   (size_t j = 0; j < N; ++j) {
+      for (size_t i = 0; i < M; ++i) {reVal[i] += A(i, j) * x[j];}
+    }
+    return reVal;
+  }
+
+  switch (simdLevel()) {
+#ifdef BCG_X86_SIMD
+    case SimdLevel::AVX512 : rowDots(A, x.data(), reVal.data(), rowDotsAVX512); break;
+    case SimdLevel::AVX2   : rowDots(A, x.data(), reVal.data(), rowDotsAVX2  ); break;
+#endif
+    default                : rowDots(A, x.data(), reVal.data(), rowDotsGeneric); break;
+  }
+
+  return reVal;
+}
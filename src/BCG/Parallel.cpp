@@ -0,0 +1,12 @@
+// ========================================================================= //
+// dependencies
+
+// own
+#include "BCG.hpp"
+
+// ========================================================================== //
+// globals
+
+namespace BCG {
+  unsigned int nThreads = 1;
+}
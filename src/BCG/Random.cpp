@@ -4,12 +4,29 @@
 // STL
 #include <stdexcept>
 #include <random>
+#include <complex>
+#include <cmath>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <bit>
+#include <mutex>
+
+// own
+#include "BCG.hpp"
 
 // ========================================================================== //
 // local macro
 
 #define THROWTEXT(msg) (std::string("RUNTIME EXCEPTION IN ") + (__PRETTY_FUNCTION__) + "\n" + msg)
 
+// compile the bulk kernels for several instruction sets and pick one at runtime
+#if defined(__GNUC__) && defined(__x86_64__)
+#define TARGET_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define TARGET_CLONES
+#endif
+
 // ========================================================================== //
 // globals
 
@@ -18,7 +35,927 @@ namespace BCG {
 
   std::random_device trueRNG;
   std::mt19937          PRNG;
+  Philox4x32           CBRNG;
 
   std::uniform_real_distribution<> rand_phase_distribution;
   std::uniform_real_distribution<> rand_percentage_distribution;
+
+  thread_local std::mt19937 threadPRNG;
+}
+
+// -------------------------------------------------------------------------- //
+// ziggurat tables
+
+/* Layer boundaries of the 256 layer ziggurat for the unnormalized density
+ * f(x) = exp(-x^2/2), after Marsaglia and Tsang (2000). R is the start of the
+ * tail and V the common area of all layers.
+ */
+static std::array<double, 257> makeZigguratX() {
+  constexpr double R = 3.6541528853610088;
+  constexpr double V = 0.00492867323399;
+
+  std::array<double, 257> x;
+  x[0] = V / std::exp(-0.5 * R * R);
+  x[1] = R;
+  for (size_t i = 1; i < 255; ++i) {
+    x[i + 1] = std::sqrt(-2.0 * std::log(V / x[i] + std::exp(-0.5 * x[i] * x[i])));
+  }
+  x[256] = 0.0;
+
+  return x;
+}
+// .......................................................................... //
+static std::array<double, 257> makeZigguratF(const std::array<double, 257> & x) {
+  std::array<double, 257> f;
+  for (size_t i = 0; i < 257; ++i) {f[i] = std::exp(-0.5 * x[i] * x[i]);}
+  return f;
+}
+// .......................................................................... //
+namespace BCG {
+  const std::array<double, 257> ziggurat_x = makeZigguratX();
+  const std::array<double, 257> ziggurat_f = makeZigguratF(ziggurat_x);
+}
+
+// ========================================================================== //
+// local procs
+
+using namespace BCG;
+
+/* maps two 32 bit outputs onto [0, 1) with 52 bits of resolution by putting
+ * the random bits into the mantissa of a double in [1, 2). Unlike an integer
+ * to double conversion, this only needs integer instructions available in all
+ * SIMD instruction sets.
+ */
+static inline double bitsToUnit(const uint32_t hi, const uint32_t lo) {
+  const uint64_t mantissa = (static_cast<uint64_t>(hi) << 32u | lo) >> 12u;
+  return std::bit_cast<double>(mantissa | 0x3FF0000000000000ull) - 1.0;
+}
+// .......................................................................... //
+/* Computes the Philox4x32-10 blocks firstBlock .. firstBlock + LANES - 1 in
+ * independent lanes, which the compiler turns into SIMD code.
+ */
+constexpr size_t LANES = 16;
+
+struct PhiloxLanes {uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];};
+
+static inline void computePhiloxLanes(PhiloxLanes & lanes,
+                                      const unsigned long long firstBlock,
+                                      const std::array<uint32_t, 2> & key
+) {
+  constexpr uint64_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+  constexpr uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+  auto & [c0, c1, c2, c3] = lanes;
+
+  for (size_t l = 0; l < LANES; ++l) {
+    const unsigned long long blockIdx = firstBlock + l;
+    c0[l] = static_cast<uint32_t>(blockIdx);
+    c1[l] = static_cast<uint32_t>(blockIdx >> 32u);
+    c2[l] = 0u;
+    c3[l] = 0u;
+  }
+
+  uint32_t k0 = key[0], k1 = key[1];
+  for (int round = 0; round < 10; ++round) {
+    // keep the lane loop rolled, such that it is vectorized as a whole
+    #pragma GCC unroll 1
+    for (size_t l = 0; l < LANES; ++l) {
+      const uint64_t p0 = M0 * c0[l];
+      const uint64_t p1 = M1 * c2[l];
+
+      const uint32_t n0 = static_cast<uint32_t>(p1 >> 32u) ^ c1[l] ^ k0;
+      const uint32_t n2 = static_cast<uint32_t>(p0 >> 32u) ^ c3[l] ^ k1;
+
+      c0[l] = n0;
+      c1[l] = static_cast<uint32_t>(p1);
+      c2[l] = n2;
+      c3[l] = static_cast<uint32_t>(p0);
+    }
+    k0 += W0;
+    k1 += W1;
+  }
+}
+// .......................................................................... //
+// writes two uniform doubles per block for nBlocks blocks
+TARGET_CLONES
+static void fillUniformFromPhilox(double * out, const size_t nBlocks,
+                                  const unsigned long long firstBlock,
+                                  const std::array<uint32_t, 2> & key,
+                                  const double offset, const double scale
+) {
+  PhiloxLanes lanes;
+
+  for (size_t group = 0; group < nBlocks; group += LANES) {
+    computePhiloxLanes(lanes, firstBlock + group, key);
+
+    double values[2 * LANES];
+    for (size_t l = 0; l < LANES; ++l) {
+      values[2 * l    ] = offset + scale * bitsToUnit(lanes.c0[l], lanes.c1[l]);
+      values[2 * l + 1] = offset + scale * bitsToUnit(lanes.c2[l], lanes.c3[l]);
+    }
+
+    const size_t nValid = std::min(LANES, nBlocks - group);
+    std::copy(values, values + 2 * nValid, out + 2 * group);
+  }
+}
+// .......................................................................... //
+// writes two 64 bit words per block for nBlocks blocks
+TARGET_CLONES
+static void fillBitsFromPhilox(uint64_t * out, const size_t nBlocks,
+                               const unsigned long long firstBlock,
+                               const std::array<uint32_t, 2> & key
+) {
+  PhiloxLanes lanes;
+
+  for (size_t group = 0; group < nBlocks; group += LANES) {
+    computePhiloxLanes(lanes, firstBlock + group, key);
+
+    uint64_t words[2 * LANES];
+    for (size_t l = 0; l < LANES; ++l) {
+      words[2 * l    ] = static_cast<uint64_t>(lanes.c0[l]) << 32u | lanes.c1[l];
+      words[2 * l + 1] = static_cast<uint64_t>(lanes.c2[l]) << 32u | lanes.c3[l];
+    }
+
+    const size_t nValid = std::min(LANES, nBlocks - group);
+    std::copy(words, words + 2 * nValid, out + 2 * group);
+  }
+}
+// .......................................................................... //
+/* Fills out with values made from two consecutive outputs of CBRNG each.
+ * convert(hi, lo) makes a single value, kernel(data, nBlocks, firstBlock, key)
+ * makes two values per Philox block.
+ */
+template<class T, class Convert, class Kernel>
+static void fillFromCBRNG(std::span<T> out, Convert convert, Kernel kernel) {
+  auto it  = out.begin();
+  auto end = out.end();
+
+  // the kernel starts at block boundaries. With an even counter, a single
+  // value suffices to get there; an odd counter (left by plain calls to
+  // CBRNG()) never reaches one and is served by the scalar loop below.
+  if (it != end && (CBRNG.get_counter() & 3u) == 2u) {
+    const uint32_t hi = CBRNG();
+    const uint32_t lo = CBRNG();
+    *it++ = convert(hi, lo);
+  }
+
+  const size_t nBlocks = (CBRNG.get_counter() & 1u) ? 0u : (end - it) / 2;
+  if (nBlocks) {
+    kernel(&*it, nBlocks, CBRNG.get_counter() >> 2u, CBRNG.get_key());
+    CBRNG.discard(4 * nBlocks);
+    it += 2 * nBlocks;
+  }
+
+  while (it != end) {
+    const uint32_t hi = CBRNG();
+    const uint32_t lo = CBRNG();
+    *it++ = convert(hi, lo);
+  }
+}
+// .......................................................................... //
+static void fillUniform(std::span<double> out, const double offset, const double scale) {
+  fillFromCBRNG(out,
+                [=] (const uint32_t hi, const uint32_t lo) {return offset + scale * bitsToUnit(hi, lo);},
+                [=] (double * data, const size_t nBlocks, const unsigned long long firstBlock, const std::array<uint32_t, 2> & key) {
+                  fillUniformFromPhilox(data, nBlocks, firstBlock, key, offset, scale);
+                }
+  );
+}
+// .......................................................................... //
+static void fillBits(std::span<uint64_t> out) {
+  fillFromCBRNG(out,
+                [] (const uint32_t hi, const uint32_t lo) {return static_cast<uint64_t>(hi) << 32u | lo;},
+                fillBitsFromPhilox
+  );
+}
+
+// .......................................................................... //
+/* Writes N unit phase factors to re[i * stride] and im[i * stride]. Candidate
+ * points are generated in batches; computing the doubled angle for a whole
+ * batch is vectorized, only picking the accepted points is done serially.
+ */
+static void fillPhaseFactors(double * re, double * im, const size_t stride, const size_t N) {
+  constexpr size_t BATCH = 1024;
+
+  std::vector<double> xy(2 * BATCH), cosines(BATCH), sines(BATCH);
+  std::vector<char>   accepted(BATCH);
+
+  size_t done = 0;
+  while (done < N) {
+    fillUniform(xy, -1.0, 2.0);
+
+    for (size_t i = 0; i < BATCH; ++i) {
+      const double x  = xy[2 * i    ];
+      const double y  = xy[2 * i + 1];
+      const double r2 = x * x + y * y;
+
+      accepted[i] = (r2 > 0.0) && (r2 <= 1.0);
+      cosines [i] = (x * x - y * y) / r2;
+      sines   [i] = (2.0 * x * y)   / r2;
+    }
+
+    for (size_t i = 0; i < BATCH && done < N; ++i) {
+      if (!accepted[i]) {continue;}
+
+      re[done * stride] = cosines[i];
+      im[done * stride] = sines  [i];
+      ++done;
+    }
+  }
+}
+
+// .......................................................................... //
+/* Evaluates the fast path of the ziggurat for N candidates: x[i] is the
+ * candidate value and accepted[i] tells whether it was accepted right away.
+ */
+TARGET_CLONES
+static void zigguratFastPath(const uint64_t * bits, double * x, char * accepted, const size_t N) {
+  for (size_t i = 0; i < N; ++i) {
+    const size_t layer = bits[i] & 0xFFu;
+    const double u     = (static_cast<int64_t>(bits[i]) >> 11) * 0x1.0p-52;
+
+    x       [i] = u * ziggurat_x[layer];
+    accepted[i] = std::abs(x[i]) < ziggurat_x[layer + 1];
+  }
+}
+// .......................................................................... //
+/* Completes a candidate that failed the fast path, with the same steps as
+ * get_randNormal(Engine &): a sample from the tail or a wedge test. If the
+ * latter fails, a new sample is drawn from scratch.
+ */
+static double zigguratSlowPath(const uint64_t bits, const double x) {
+  constexpr double R = 3.6541528853610088;
+  const size_t layer = bits & 0xFFu;
+
+  if (layer == 0) {
+    double tx, ty;
+    do {
+      tx = -std::log(1.0 - (get_randBits64(CBRNG) >> 11) * 0x1.0p-53) / R;
+      ty = -std::log(1.0 - (get_randBits64(CBRNG) >> 11) * 0x1.0p-53);
+    } while (ty + ty < tx * tx);
+
+    return (x < 0) ? -(R + tx) : (R + tx);
+  }
+
+  const double y = ziggurat_f[layer] + (get_randBits64(CBRNG) >> 11) * 0x1.0p-53 * (ziggurat_f[layer + 1] - ziggurat_f[layer]);
+  if (y < std::exp(-0.5 * x * x)) {return x;}
+
+  return get_randNormal(CBRNG);
+}
+
+
+// -------------------------------------------------------------------------- //
+// jump ahead for MT19937
+
+/* Polynomials over GF(2) are stored as bit arrays, where bit i of the array
+ * is the coefficient of x^i.
+ */
+typedef std::vector<uint64_t> GF2Polynomial;
+
+static inline bool gf2Get (const GF2Polynomial & p, const size_t i) {return (p[i / 64] >> (i % 64)) & 1u;}
+static inline void gf2Flip(      GF2Polynomial & p, const size_t i) {p[i / 64] ^= uint64_t(1) << (i % 64);}
+// .......................................................................... //
+// target += src * x^shift, truncated to the size of target
+static void gf2AddShifted(GF2Polynomial & target, const GF2Polynomial & src, const size_t shift) {
+  const size_t words = shift / 64;
+  const size_t bits  = shift % 64;
+
+  for (size_t i = 0; i < src.size() && i + words < target.size(); ++i) {
+    target[i + words] ^= src[i] << bits;
+    if (bits && i + words + 1 < target.size()) {target[i + words + 1] ^= src[i] >> (64 - bits);}
+  }
+}
+// .......................................................................... //
+// reduces p modulo phi, which has degree degPhi
+static void gf2Reduce(GF2Polynomial & p, const GF2Polynomial & phi, const size_t degPhi) {
+  for (size_t i = 64 * p.size(); i-- > degPhi; ) {
+    if (gf2Get(p, i)) {gf2AddShifted(p, phi, i - degPhi);}
+  }
+  p.resize(degPhi / 64 + 1);
+}
+// .......................................................................... //
+// squaring over GF(2) only spreads the bits: (sum a_i x^i)^2 = sum a_i x^2i
+static GF2Polynomial gf2Square(const GF2Polynomial & p) {
+  auto spread = [] (uint64_t x) {
+    x = (x | x << 16u) & 0x0000FFFF0000FFFFull;
+    x = (x | x <<  8u) & 0x00FF00FF00FF00FFull;
+    x = (x | x <<  4u) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | x <<  2u) & 0x3333333333333333ull;
+    x = (x | x <<  1u) & 0x5555555555555555ull;
+    return x;
+  };
+
+  GF2Polynomial reVal(2 * p.size());
+  for (size_t i = 0; i < p.size(); ++i) {
+    reVal[2 * i    ] = spread(p[i] & 0xFFFFFFFFu);
+    reVal[2 * i + 1] = spread(p[i] >> 32u);
+  }
+
+  return reVal;
+}
+// .......................................................................... //
+static GF2Polynomial gf2TimesX(const GF2Polynomial & p) {
+  GF2Polynomial reVal(p.size() + 1);
+
+  uint64_t carry = 0u;
+  for (size_t i = 0; i < p.size(); ++i) {
+    reVal[i] = p[i] << 1u | carry;
+    carry    = p[i] >> 63u;
+  }
+  reVal.back() = carry;
+
+  return reVal;
+}
+// .......................................................................... //
+/* Finds the minimal polynomial of the sequence formed by the lowest bit of
+ * consecutive MT19937 outputs via Berlekamp-Massey. As the characteristic
+ * polynomial of MT19937 is irreducible, this is the characteristic polynomial
+ * itself. The result is cached.
+ */
+static const GF2Polynomial & mt19937CharacteristicPolynomial() {
+  static const GF2Polynomial phi = [] () {
+    constexpr size_t DEGREE = 19937;
+    constexpr size_t LENGTH = 2 * DEGREE;
+    constexpr size_t WORDS  = LENGTH / 64 + 3;
+
+    // store the sequence in reverse, such that the discrepancy is a word-wise
+    // product of the connection polynomial with a window of the sequence
+    GF2Polynomial reversed(WORDS, 0u);
+    std::mt19937 engine;
+    for (size_t n = 0; n < LENGTH; ++n) {
+      if (engine() & 1u) {gf2Flip(reversed, LENGTH - 1 - n);}
+    }
+
+    GF2Polynomial C(WORDS, 0u), B(WORDS, 0u);
+    C[0] = B[0] = 1u;
+    size_t L = 0, m = 1;
+
+    for (size_t n = 0; n < LENGTH; ++n) {
+      // discrepancy: sum_{i = 0 .. L} C_i s_{n - i}
+      const size_t offset = LENGTH - 1 - n;
+      const size_t ow = offset / 64, ob = offset % 64;
+
+      uint64_t products = 0u;
+      for (size_t k = 0; k <= L / 64; ++k) {
+        uint64_t window = reversed[ow + k] >> ob;
+        if (ob) {window |= reversed[ow + k + 1] << (64 - ob);}
+        products ^= C[k] & window;
+      }
+
+      if (!(std::popcount(products) & 1)) {++m; continue;}
+
+      if (2 * L <= n) {
+        const GF2Polynomial T = C;
+        gf2AddShifted(C, B, m);
+        L = n + 1 - L;
+        B = T;
+        m = 1;
+      } else {
+        gf2AddShifted(C, B, m);
+        ++m;
+      }
+    }
+
+    if (L != DEGREE) {
+      throw std::logic_error(THROWTEXT("    unexpected degree of the MT19937 characteristic polynomial!"));
+    }
+
+    // the characteristic polynomial is the reciprocal of the connection polynomial
+    GF2Polynomial reVal(DEGREE / 64 + 1, 0u);
+    for (size_t i = 0; i <= DEGREE; ++i) {
+      if (gf2Get(C, DEGREE - i)) {gf2Flip(reVal, i);}
+    }
+
+    return reVal;
+  } ();
+
+  return phi;
+}
+// .......................................................................... //
+/* Evaluates p(T) on the state window, where T advances the window of 624
+ * consecutive MT19937 words by one word. Horner's scheme is used, with the
+ * window sliding through a buffer, such that T only appends a new word.
+ */
+static std::vector<uint32_t> mt19937ApplyPolynomial(const std::vector<uint32_t> & window, const GF2Polynomial & p) {
+  constexpr size_t   N = 624, M = 397;
+  constexpr uint32_t MATRIX_A   = 0x9908B0DFu;
+  constexpr uint32_t UPPER_MASK = 0x80000000u;
+  constexpr uint32_t LOWER_MASK = 0x7FFFFFFFu;
+
+  size_t degree = 64 * p.size();
+  while (degree-- > 0 && !gf2Get(p, degree)) {}
+
+  std::vector<uint32_t> buffer(N + degree + 1);
+  std::copy(window.begin(), window.end(), buffer.begin());
+
+  size_t start = 0;
+  for (size_t i = degree; i-- > 0; ) {
+    const uint32_t y = (buffer[start] & UPPER_MASK) | (buffer[start + 1] & LOWER_MASK);
+    buffer[start + N] = buffer[start + M] ^ (y >> 1u) ^ ((y & 1u) ? MATRIX_A : 0u);
+    ++start;
+
+    if (gf2Get(p, i)) {
+      for (size_t j = 0; j < N; ++j) {buffer[start + j] ^= window[j];}
+    }
+  }
+
+  return std::vector<uint32_t>(buffer.begin() + start, buffer.begin() + start + N);
+}
+
+// -------------------------------------------------------------------------- //
+// low discrepancy sequences
+
+/* Polynomials over GF(2) of degree up to 31 are stored as bit masks, where
+ * bit i is the coefficient of x^i. Products fit into 64 bits.
+ */
+static uint64_t gf2MulMod(uint64_t a, uint64_t b, const uint64_t p, const int degree) {
+  uint64_t product = 0;
+  while (b) {
+    if (b & 1u) {product ^= a;}
+    b >>= 1u;
+    a <<= 1u;
+    if ((a >> degree) & 1u) {a ^= p;}
+  }
+  return product;
+}
+// .......................................................................... //
+static uint64_t gf2PowXMod(uint64_t n, const uint64_t p, const int degree) {
+  uint64_t result = 1, base = 2;
+  if (degree == 1) {base = p ^ 2u;}                                             // x mod (x + 1)
+
+  while (n) {
+    if (n & 1u) {result = gf2MulMod(result, base, p, degree);}
+    base = gf2MulMod(base, base, p, degree);
+    n >>= 1u;
+  }
+  return result;
+}
+// .......................................................................... //
+/* p of degree s is primitive iff x has the multiplicative order 2^s - 1
+ * modulo p, i.e. iff x^(2^s - 1) = 1 and x^((2^s - 1) / q) != 1 for all prime
+ * factors q of 2^s - 1.
+ */
+static bool isPrimitive(const uint64_t p, const int degree, const std::vector<uint64_t> & primeFactors) {
+  if (!(p & 1u)) {return false;}
+
+  const uint64_t order = (uint64_t(1) << degree) - 1;
+  if (gf2PowXMod(order, p, degree) != 1u) {return false;}
+
+  for (auto q : primeFactors) {
+    if (gf2PowXMod(order / q, p, degree) == 1u) {return false;}
+  }
+
+  return true;
+}
+// .......................................................................... //
+/* returns the first N primitive polynomials, ordered by degree and then by
+ * their bit masks. The list is extended as needed and cached.
+ */
+static std::vector<uint64_t> primitivePolynomials(const size_t N) {
+  static std::vector<uint64_t> cache;
+  static int                   nextDegree = 1;
+  static std::mutex            lock;
+
+  std::lock_guard<std::mutex> guard(lock);
+
+  while (cache.size() < N) {
+    if (nextDegree > 31) {
+      throw std::invalid_argument(THROWTEXT("    too many dimensions for the Sobol sequence!"));
+    }
+
+    const uint64_t leading = uint64_t(1) << nextDegree;
+
+    std::vector<uint64_t> primeFactors;
+    uint64_t rest = leading - 1;
+    for (uint64_t q = 2; q * q <= rest; ++q) {
+      if (rest % q) {continue;}
+      primeFactors.push_back(q);
+      while (rest % q == 0) {rest /= q;}
+    }
+    if (rest > 1) {primeFactors.push_back(rest);}
+
+    for (uint64_t p = leading | 1u; p < 2 * leading; p += 2) {
+      if (isPrimitive(p, nextDegree, primeFactors)) {cache.push_back(p);}
+    }
+    ++nextDegree;
+  }
+
+  return std::vector<uint64_t>(cache.begin(), cache.begin() + N);
+}
+// .......................................................................... //
+/* The direction numbers v_k = m_k / 2^k of dimension j follow from the
+ * recurrence of Bratley and Fox with the j-th primitive polynomial
+ *   x^s + a_1 x^(s-1) + ... + a_(s-1) x + 1
+ * as
+ *   m_k = 2 a_1 m_(k-1) ^ 4 a_2 m_(k-2) ^ ... ^ 2^s m_(k-s) ^ m_(k-s)
+ * The initial values m_1 .. m_s are arbitrary odd numbers below 2^k, taken
+ * from a fixed pseudorandom sequence. Dimension 0 is the van der Corput
+ * sequence in base 2.
+ */
+static std::vector<uint32_t> sobolDirections(const size_t dims) {
+  constexpr int BITS = 32;
+  std::vector<uint32_t> directions(BITS * dims);
+
+  for (int k = 0; k < BITS; ++k) {directions[k * dims] = uint32_t(1) << (BITS - 1 - k);}
+
+  const auto polynomials = primitivePolynomials(dims - 1);
+  std::mt19937 initialValues(0x50B01u);
+
+  for (size_t j = 1; j < dims; ++j) {
+    const uint64_t p = polynomials[j - 1];
+    const int      s = 63 - std::countl_zero(p);
+
+    std::array<uint64_t, BITS> m;
+    for (int k = 0; k < BITS; ++k) {
+      if (k < s) {
+        m[k] = (initialValues() & ((uint64_t(2) << k) - 1)) | 1u;
+        continue;
+      }
+
+      m[k] = (m[k - s] << s) ^ m[k - s];
+      for (int i = 1; i < s; ++i) {
+        if ((p >> (s - i)) & 1u) {m[k] ^= m[k - i] << i;}
+      }
+    }
+
+    for (int k = 0; k < BITS; ++k) {directions[k * dims + j] = m[k] << (BITS - 1 - k);}
+  }
+
+  return directions;
+}
+
+// ========================================================================== //
+// procs
+
+std::mt19937 BCG::get_PRNG_stream(const unsigned long long streamID) {
+  // std::seed_seq only consumes the lower 32 bits of each value
+  std::seed_seq sequence {
+    static_cast<unsigned int>(seedRNG         ),
+    static_cast<unsigned int>(seedRNG   >> 32u),
+    static_cast<unsigned int>(streamID        ),
+    static_cast<unsigned int>(streamID  >> 32u)
+  };
+
+  return std::mt19937(sequence);
+}
+// -------------------------------------------------------------------------- //
+void BCG::jump_mt19937(std::mt19937 & engine, const unsigned long long n) {
+  // below this, discarding is faster than evaluating the jump polynomial
+  constexpr unsigned long long JUMP_THRESHOLD = 10000000ull;
+  constexpr size_t N = 624;
+
+  if (n < JUMP_THRESHOLD) {engine.discard(n); return;}
+
+  /* The textual state consists of 624 consecutive words, followed by the
+   * position of the next output within them in libstdc++. Without the
+   * position, the next output is the word following the 624 words, which
+   * equals position 624.
+   */
+  std::stringstream state;
+  state << engine;
+
+  std::vector<unsigned long long> values;
+  unsigned long long value;
+  while (state >> value) {values.push_back(value);}
+
+  if (values.size() != N && values.size() != N + 1) {
+    throw std::runtime_error(THROWTEXT("    unknown textual representation of std::mt19937!"));
+  }
+
+  const unsigned long long position = (values.size() == N + 1) ? values[N] : N;
+  std::vector<uint32_t> window(values.begin(), values.begin() + N);
+
+  // the new window are the 624 words before the new position
+  const unsigned long long steps = n - (N - position);
+
+  const auto & phi = mt19937CharacteristicPolynomial();
+  constexpr size_t DEGREE = 19937;
+
+  GF2Polynomial jump = {1u};
+  for (int bit = 63 - std::countl_zero(steps); bit >= 0; --bit) {
+    jump = gf2Square(jump);
+    gf2Reduce(jump, phi, DEGREE);
+
+    if ((steps >> bit) & 1u) {
+      jump = gf2TimesX(jump);
+      gf2Reduce(jump, phi, DEGREE);
+    }
+  }
+
+  window = mt19937ApplyPolynomial(window, jump);
+
+  std::stringstream newState;
+  for (auto word : window) {newState << word << ' ';}
+  if (values.size() == N + 1) {newState << N;}
+  newState >> engine;
+}
+// .......................................................................... //
+std::mt19937 BCG::get_PRNG_substream(const unsigned long long index, const unsigned long long length) {
+  if (length && index > UINT64_MAX / length) {
+    throw std::overflow_error(THROWTEXT("    offset of the substream exceeds 2^64 - 1!"));
+  }
+
+  std::mt19937 reVal(seedRNG);
+  jump_mt19937(reVal, index * length);
+
+  return reVal;
+}
+// -------------------------------------------------------------------------- //
+void BCG::fill_randPhase(std::span<double> out) {
+  fillUniform(out, rand_phase_distribution.a(), rand_phase_distribution.b() - rand_phase_distribution.a());
+}
+// .......................................................................... //
+void BCG::fill_randPercentage(std::span<double> out) {
+  fillUniform(out, rand_percentage_distribution.a(), rand_percentage_distribution.b() - rand_percentage_distribution.a());
+}
+// .......................................................................... //
+void BCG::fill_randPhaseFactor(std::span<std::complex<double>> out) {
+  // std::complex<double> is guaranteed to be laid out as double[2]
+  auto data = reinterpret_cast<double *>(out.data());
+  fillPhaseFactors(data, data + 1, 2, out.size());
+}
+// .......................................................................... //
+void BCG::fill_randPhaseFactor(std::span<double> re, std::span<double> im) {
+  if (re.size() != im.size()) {
+    throw std::invalid_argument(THROWTEXT("    're' and 'im' are not of same size!"));
+  }
+
+  fillPhaseFactors(re.data(), im.data(), 1, re.size());
+}
+// .......................................................................... //
+void BCG::fill_randNormal(std::span<double> out) {
+  constexpr size_t BATCH = 1024;
+
+  std::vector<uint64_t> bits(BATCH);
+  std::vector<double>   x   (BATCH);
+  std::vector<char>     accepted(BATCH);
+
+  for (size_t first = 0; first < out.size(); first += BATCH) {
+    const size_t N = std::min(BATCH, out.size() - first);
+
+    fillBits(std::span(bits).first(N));
+    zigguratFastPath(bits.data(), x.data(), accepted.data(), N);
+
+    for (size_t i = 0; i < N; ++i) {
+      out[first + i] = accepted[i] ? x[i] : zigguratSlowPath(bits[i], x[i]);
+    }
+  }
+}
+// -------------------------------------------------------------------------- //
+BCG::AliasTable::AliasTable(const std::vector<double> & weights) {
+  const size_t N = weights.size();
+
+  if (N == 0) {
+    throw std::invalid_argument(THROWTEXT("    no weights given!"));
+  }
+  if (N > UINT32_MAX) {
+    throw std::invalid_argument(THROWTEXT("    too many categories!"));
+  }
+
+  double sum = 0.0;
+  for (auto w : weights) {
+    if (w < 0 || !std::isfinite(w)) {
+      throw std::invalid_argument(THROWTEXT("    weights must be non-negative and finite!"));
+    }
+    sum += w;
+  }
+  if (sum <= 0) {
+    throw std::invalid_argument(THROWTEXT("    weights must not sum up to zero!"));
+  }
+
+  probabilities.resize(N);
+  threshold    .resize(N);
+  alias        .resize(N);
+
+  // Vose: scale to mean 1, then pair each small column with a large one
+  std::vector<uint32_t> small, large;
+  for (size_t i = 0; i < N; ++i) {
+    probabilities[i] = weights[i] / sum;
+    threshold    [i] = probabilities[i] * N;
+    alias        [i] = i;
+    (threshold[i] < 1.0 ? small : large).push_back(i);
+  }
+
+  while (!small.empty() && !large.empty()) {
+    const uint32_t s = small.back(); small.pop_back();
+    const uint32_t l = large.back();
+
+    alias[s]      = l;
+    threshold[l] -= 1.0 - threshold[s];
+
+    if (threshold[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+
+  // whatever is left is 1 up to rounding errors
+  for (auto i : small) {threshold[i] = 1.0;}
+  for (auto i : large) {threshold[i] = 1.0;}
+}
+// -------------------------------------------------------------------------- //
+BCG::SobolSequence::SobolSequence(const size_t dimensions) :
+  dims      (dimensions),
+  directions(),
+  shift     (dimensions, 0u),
+  state     (dimensions, 0u)
+{
+  if (dimensions == 0) {
+    throw std::invalid_argument(THROWTEXT("    dimensions must be positive!"));
+  }
+
+  directions = sobolDirections(dims);
+}
+// .......................................................................... //
+BCG::SobolSequence::SobolSequence(const size_t dimensions, const unsigned long long scrambleSeed) :
+  SobolSequence(dimensions)
+{
+  std::seed_seq sequence {static_cast<unsigned int>(scrambleSeed), static_cast<unsigned int>(scrambleSeed >> 32u)};
+  std::mt19937  engine(sequence);
+
+  /* column j of the lower triangular matrix has the digit j set and random
+   * less significant digits. As the matrix is linear, it can be applied to the
+   * direction numbers once, rather than to each point.
+   */
+  for (size_t d = 0; d < dims; ++d) {
+    std::array<uint32_t, 32> columns;
+    for (int j = 0; j < 32; ++j) {
+      const uint32_t digit = uint32_t(1) << (31 - j);
+      columns[j] = digit | (engine() & (digit - 1));
+    }
+
+    for (int k = 0; k < 32; ++k) {
+      const uint32_t v = directions[k * dims + d];
+      uint32_t scrambled = 0;
+      for (int j = 0; j < 32; ++j) {
+        if ((v >> (31 - j)) & 1u) {scrambled ^= columns[j];}
+      }
+      directions[k * dims + d] = scrambled;
+    }
+
+    shift[d] = engine();
+  }
+
+  state = shift;
+}
+// .......................................................................... //
+std::vector<double> BCG::SobolSequence::operator()() {
+  std::vector<double> reVal(dims);
+  fill(reVal);
+  return reVal;
+}
+// .......................................................................... //
+void BCG::SobolSequence::fill(std::span<double> out) {
+  if (out.size() % dims) {
+    throw std::invalid_argument(THROWTEXT("    size of 'out' is not a multiple of the dimensions!"));
+  }
+
+  const size_t nPoints = out.size() / dims;
+  if (nPoints > max_index - index) {
+    throw std::out_of_range(THROWTEXT("    Sobol sequence exhausted!"));
+  }
+
+  for (size_t i = 0; i < nPoints; ++i) {
+    double * point = out.data() + i * dims;
+    for (size_t d = 0; d < dims; ++d) {point[d] = state[d] * 0x1.0p-32;}
+    advance();
+  }
+}
+// .......................................................................... //
+void BCG::SobolSequence::set_index(const unsigned long long index) {
+  if (index > max_index) {
+    throw std::out_of_range(THROWTEXT("    index exceeds the length of the Sobol sequence!"));
+  }
+
+  this->index = index;
+  state       = shift;
+
+  // point i is the sum of the direction numbers selected by the Gray code of i
+  const unsigned long long gray = index ^ (index >> 1u);
+  for (int k = 0; k < 32; ++k) {
+    if (!((gray >> k) & 1u)) {continue;}
+
+    const uint32_t * v = directions.data() + k * dims;
+    for (size_t d = 0; d < dims; ++d) {state[d] ^= v[d];}
+  }
+}
+// .......................................................................... //
+void BCG::SobolSequence::advance() {
+  ++index;
+  if (index == max_index) {return;}
+
+  // the Gray codes of index - 1 and index differ in the lowest set bit of index
+  const uint32_t * v = directions.data() + std::countr_zero(index) * dims;
+  for (size_t d = 0; d < dims; ++d) {state[d] ^= v[d];}
+}
+// -------------------------------------------------------------------------- //
+BCG::HaltonSequence::HaltonSequence(const size_t dimensions) {
+  init(dimensions, nullptr);
+}
+// .......................................................................... //
+BCG::HaltonSequence::HaltonSequence(const size_t dimensions, const unsigned long long scrambleSeed) {
+  init(dimensions, &scrambleSeed);
+}
+// .......................................................................... //
+void BCG::HaltonSequence::init(const size_t dimensions, const unsigned long long * scrambleSeed) {
+  if (dimensions == 0) {
+    throw std::invalid_argument(THROWTEXT("    dimensions must be positive!"));
+  }
+
+  std::vector<uint32_t> primes;
+  for (uint32_t candidate = 2; primes.size() < dimensions; ++candidate) {
+    bool isPrime = true;
+    for (auto p : primes) {
+      if (p * p > candidate) {break;}
+      if (candidate % p == 0) {isPrime = false; break;}
+    }
+    if (isPrime) {primes.push_back(candidate);}
+  }
+
+  std::mt19937 engine;
+  if (scrambleSeed) {
+    std::seed_seq sequence {static_cast<unsigned int>(*scrambleSeed), static_cast<unsigned int>(*scrambleSeed >> 32u)};
+    engine.seed(sequence);
+  }
+
+  size_t offset = 0, permutationOffset = 0;
+  for (auto b : primes) {
+    // enough digits for any 64 bit index
+    size_t nDigits = 0;
+    for (unsigned long long rest = UINT64_MAX; rest; rest /= b) {++nDigits;}
+
+    dims.push_back({b, nDigits, offset, permutationOffset});
+
+    for (size_t k = 0; k < nDigits; ++k) {scales.push_back(std::pow(static_cast<double>(b), -static_cast<double>(k + 1)));}
+    scales.push_back(0.0);
+
+    const auto first = permutations.size();
+    for (uint32_t a = 0; a < b; ++a) {permutations.push_back(a);}
+    if (scrambleSeed) {std::shuffle(permutations.begin() + first + 1, permutations.end(), engine);}
+
+    offset            += nDigits + 1;
+    permutationOffset += b;
+  }
+
+  digits     .assign(offset, 0u);
+  partialSums.assign(offset, 0.0);
+
+  set_index(0);
+}
+// .......................................................................... //
+std::vector<double> BCG::HaltonSequence::operator()() {
+  std::vector<double> reVal(dims.size());
+  fill(reVal);
+  return reVal;
+}
+// .......................................................................... //
+void BCG::HaltonSequence::fill(std::span<double> out) {
+  const size_t D = dims.size();
+
+  if (out.size() % D) {
+    throw std::invalid_argument(THROWTEXT("    size of 'out' is not a multiple of the dimensions!"));
+  }
+
+  const size_t nPoints = out.size() / D;
+  for (size_t i = 0; i < nPoints; ++i) {
+    double * point = out.data() + i * D;
+    for (size_t d = 0; d < D; ++d) {point[d] = partialSums[dims[d].offset];}
+    advance();
+  }
+}
+// .......................................................................... //
+void BCG::HaltonSequence::set_index(const unsigned long long index) {
+  this->index = index;
+
+  for (const auto & [b, nDigits, offset, permutationOffset] : dims) {
+    unsigned long long rest = index;
+    for (size_t k = 0; k < nDigits; ++k) {
+      digits[offset + k] = rest % b;
+      rest /= b;
+    }
+
+    // summed from the most significant digit down, exactly as in advance()
+    for (size_t k = nDigits; k-- > 0; ) {
+      partialSums[offset + k] = partialSums[offset + k + 1] + permutations[permutationOffset + digits[offset + k]] * scales[offset + k];
+    }
+  }
+}
+// .......................................................................... //
+void BCG::HaltonSequence::advance() {
+  if (index == UINT64_MAX) {
+    throw std::out_of_range(THROWTEXT("    Halton sequence exhausted!"));
+  }
+  ++index;
+
+  for (const auto & [b, nDigits, offset, permutationOffset] : dims) {
+    uint32_t * digit = digits.data() + offset;
+
+    size_t k = 0;
+    while (++digit[k] == b) {digit[k++] = 0;}
+
+    // only the sums including the changed digits 0 .. k need to be updated
+    for (size_t j = k + 1; j-- > 0; ) {
+      partialSums[offset + j] = partialSums[offset + j + 1] + permutations[permutationOffset + digit[j]] * scales[offset + j];
+    }
+  }
 }
@@ -0,0 +1,58 @@
+/* Internal header, shared by the translation units with hand written SIMD
+ * kernels. Not part of the public interface.
+ *
+ * Each kernel exists in a generic, an AVX2 and an AVX-512 version. The AVX
+ * versions are compiled for their instruction set via the target attribute,
+ * independent of the compiler flags, and are only called if simdLevel()
+ * reports that the host CPU supports them.
+ */
+
+#ifndef BCG_SIMD_HPP
+#define BCG_SIMD_HPP
+
+// ========================================================================= //
+// dependencies
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define BCG_X86_SIMD
+#endif
+
+// ========================================================================== //
+// macros
+
+#ifdef BCG_X86_SIMD
+#define TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+
+// enclose the AVX-512 kernels: GCC 12 falsely reports the _mm512_undefined_*
+// placeholders inside its own intrinsics as uninitialized
+#define BCG_AVX512_BEGIN \
+  _Pragma("GCC diagnostic push") \
+  _Pragma("GCC diagnostic ignored \"-Wuninitialized\"") \
+  _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define BCG_AVX512_END \
+  _Pragma("GCC diagnostic pop")
+#endif
+
+// ========================================================================== //
+// runtime dispatch
+
+enum class SimdLevel {Generic, AVX2, AVX512};
+
+inline SimdLevel detectSimdLevel() {
+#ifdef BCG_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))                                    {return SimdLevel::AVX512;}
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))     {return SimdLevel::AVX2;}
+#endif
+  return SimdLevel::Generic;
+}
+// .......................................................................... //
+// detected once per program, shared by all translation units
+inline SimdLevel simdLevel() {
+  static const SimdLevel level = detectSimdLevel();
+  return level;
+}
+
+#endif
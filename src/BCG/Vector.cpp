@@ -5,15 +5,320 @@
 #include <stdexcept>
 
 #include <iostream>
+#include <complex>
+#include <cmath>
+#include <limits>
+#include <array>
+#include <vector>
+#include <utility>
+#include <numeric>
+#include <algorithm>
 
 // own
 #include "BCG.hpp"
+#include "Simd.hpp"
 
 // ========================================================================== //
 // local macro
 
 #define THROWTEXT(msg) (std::string("RUNTIME EXCEPTION IN ") + (__PRETTY_FUNCTION__) + "\n" + msg)
 
+// ========================================================================== //
+// local procs
+
+/* The findNearby kernels compare blocks of four SIMD registers against the
+ * threshold and only look at the individual elements of a block that
+ * contains a match. The AVX versions are compiled for their instruction set
+ * via the target attribute and are only called if the host CPU supports
+ * them, cf. Simd.hpp.
+ */
+
+// -------------------------------------------------------------------------- //
+// generic kernels
+
+// the first index in [first, last) that the generic findNearby would return, or last
+template<class T>
+static size_t scanGeneric(const T * x, size_t first, const size_t last, const T value, const double epsilon) {
+  for (; first < last; ++first) {
+    if (BCG::AbsoluteValue()(x[first] - value) < epsilon) {break;}
+  }
+  return first;
+}
+// .......................................................................... //
+// the smallest float not less than epsilon, i.e. for any float d,
+// d < epsilon if and only if d < floatThreshold(epsilon)
+static float floatThreshold(const double epsilon) {
+  if (epsilon > std::numeric_limits<float>::max()) {return std::numeric_limits<float>::infinity();}
+
+  float reVal = static_cast<float>(epsilon);
+  if (reVal < epsilon) {reVal = std::nextafter(reVal, std::numeric_limits<float>::infinity());}
+  return reVal;
+}
+
+#ifdef BCG_X86_SIMD
+// -------------------------------------------------------------------------- //
+// AVX2 kernels
+
+// lanes where |x - v| < threshold
+TARGET_AVX2 static inline __m256d nearMask(const double * x, const __m256d v, const __m256d threshold) {
+  const __m256d difference = _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_sub_pd(_mm256_loadu_pd(x), v));
+  return _mm256_cmp_pd(difference, threshold, _CMP_LT_OQ);
+}
+TARGET_AVX2 static inline __m256  nearMask(const float  * x, const __m256  v, const __m256  threshold) {
+  const __m256  difference = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), _mm256_sub_ps(_mm256_loadu_ps(x), v));
+  return _mm256_cmp_ps(difference, threshold, _CMP_LT_OQ);
+}
+// lanes of the complex numbers at x where both real and imaginary part are nearer than threshold
+TARGET_AVX2 static inline __m256d candidateMask(const double * x, const __m256d v, const __m256d threshold) {
+  const __m256d m = nearMask(x, v, threshold);
+  return _mm256_and_pd(m, _mm256_permute_pd(m, 0b0101));
+}
+// .......................................................................... //
+TARGET_AVX2 static size_t findNearbyAVX2(const double * x, const size_t N, const double value, const double epsilon) {
+  const __m256d v = _mm256_set1_pd(value), threshold = _mm256_set1_pd(epsilon);
+
+  size_t i = 0;
+  for (; i + 16 <= N; i += 16) {
+    const __m256d m0 = nearMask(x + i,     v, threshold), m1 = nearMask(x + i +  4, v, threshold);
+    const __m256d m2 = nearMask(x + i + 8, v, threshold), m3 = nearMask(x + i + 12, v, threshold);
+    if (_mm256_movemask_pd(_mm256_or_pd(_mm256_or_pd(m0, m1), _mm256_or_pd(m2, m3)))) {return scanGeneric(x, i, i + 16, value, epsilon);}
+  }
+
+  return scanGeneric(x, i, N, value, epsilon);
+}
+// .......................................................................... //
+TARGET_AVX2 static size_t findNearbyAVX2(const float * x, const size_t N, const float value, const double epsilon) {
+  const __m256 v = _mm256_set1_ps(value), threshold = _mm256_set1_ps(floatThreshold(epsilon));
+
+  size_t i = 0;
+  for (; i + 32 <= N; i += 32) {
+    const __m256 m0 = nearMask(x + i,      v, threshold), m1 = nearMask(x + i +  8, v, threshold);
+    const __m256 m2 = nearMask(x + i + 16, v, threshold), m3 = nearMask(x + i + 24, v, threshold);
+    if (_mm256_movemask_ps(_mm256_or_ps(_mm256_or_ps(m0, m1), _mm256_or_ps(m2, m3)))) {return scanGeneric(x, i, i + 32, value, epsilon);}
+  }
+
+  return scanGeneric(x, i, N, value, epsilon);
+}
+// .......................................................................... //
+TARGET_AVX2 static size_t findNearbyAVX2(const std::complex<double> * x, const size_t N, const std::complex<double> value, const double epsilon) {
+  const double * xd = reinterpret_cast<const double *>(x);
+  const __m256d  v  = _mm256_setr_pd(value.real(), value.imag(), value.real(), value.imag());
+  const __m256d  threshold = _mm256_set1_pd(epsilon);
+
+  size_t i = 0;
+  for (; i + 8 <= N; i += 8) {
+    const __m256d m0 = candidateMask(xd + 2 * i,     v, threshold), m1 = candidateMask(xd + 2 * i +  4, v, threshold);
+    const __m256d m2 = candidateMask(xd + 2 * i + 8, v, threshold), m3 = candidateMask(xd + 2 * i + 12, v, threshold);
+    if (_mm256_movemask_pd(_mm256_or_pd(_mm256_or_pd(m0, m1), _mm256_or_pd(m2, m3)))) {
+      const size_t hit = scanGeneric(x, i, i + 8, value, epsilon);
+      if (hit < i + 8) {return hit;}
+    }
+  }
+
+  return scanGeneric(x, i, N, value, epsilon);
+}
+
+// -------------------------------------------------------------------------- //
+// AVX-512 kernels
+
+BCG_AVX512_BEGIN
+
+// lanes where |x - v| < threshold
+TARGET_AVX512 static inline __mmask8  nearMask(const double * x, const __m512d v, const __m512d threshold) {
+  return _mm512_cmp_pd_mask(_mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(x), v)), threshold, _CMP_LT_OQ);
+}
+TARGET_AVX512 static inline __mmask16 nearMask(const float  * x, const __m512  v, const __m512  threshold) {
+  return _mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(x), v)), threshold, _CMP_LT_OQ);
+}
+// the even lanes of the complex numbers at x where both real and imaginary part are nearer than threshold
+TARGET_AVX512 static inline unsigned int candidateMask(const double * x, const __m512d v, const __m512d threshold) {
+  const unsigned int m = nearMask(x, v, threshold);
+  return m & (m >> 1) & 0x55u;
+}
+// .......................................................................... //
+TARGET_AVX512 static size_t findNearbyAVX512(const double * x, const size_t N, const double value, const double epsilon) {
+  const __m512d v = _mm512_set1_pd(value), threshold = _mm512_set1_pd(epsilon);
+
+  size_t i = 0;
+  for (; i + 32 <= N; i += 32) {
+    const unsigned int m0 = nearMask(x + i,      v, threshold), m1 = nearMask(x + i +  8, v, threshold);
+    const unsigned int m2 = nearMask(x + i + 16, v, threshold), m3 = nearMask(x + i + 24, v, threshold);
+    if ((m0 | m1) | (m2 | m3)) {return scanGeneric(x, i, i + 32, value, epsilon);}
+  }
+
+  return scanGeneric(x, i, N, value, epsilon);
+}
+// .......................................................................... //
+TARGET_AVX512 static size_t findNearbyAVX512(const float * x, const size_t N, const float value, const double epsilon) {
+  const __m512 v = _mm512_set1_ps(value), threshold = _mm512_set1_ps(floatThreshold(epsilon));
+
+  size_t i = 0;
+  for (; i + 64 <= N; i += 64) {
+    const unsigned int m0 = nearMask(x + i,      v, threshold), m1 = nearMask(x + i + 16, v, threshold);
+    const unsigned int m2 = nearMask(x + i + 32, v, threshold), m3 = nearMask(x + i + 48, v, threshold);
+    if ((m0 | m1) | (m2 | m3)) {return scanGeneric(x, i, i + 64, value, epsilon);}
+  }
+
+  return scanGeneric(x, i, N, value, epsilon);
+}
+// .......................................................................... //
+TARGET_AVX512 static size_t findNearbyAVX512(const std::complex<double> * x, const size_t N, const std::complex<double> value, const double epsilon) {
+  const double * xd = reinterpret_cast<const double *>(x);
+  const __m512d  v  = _mm512_setr_pd(value.real(), value.imag(), value.real(), value.imag(),
+                                     value.real(), value.imag(), value.real(), value.imag());
+  const __m512d  threshold = _mm512_set1_pd(epsilon);
+
+  size_t i = 0;
+  for (; i + 16 <= N; i += 16) {
+    const unsigned int m0 = candidateMask(xd + 2 * i,      v, threshold), m1 = candidateMask(xd + 2 * i +  8, v, threshold);
+    const unsigned int m2 = candidateMask(xd + 2 * i + 16, v, threshold), m3 = candidateMask(xd + 2 * i + 24, v, threshold);
+    if ((m0 | m1) | (m2 | m3)) {
+      const size_t hit = scanGeneric(x, i, i + 16, value, epsilon);
+      if (hit < i + 16) {return hit;}
+    }
+  }
+
+  return scanGeneric(x, i, N, value, epsilon);
+}
+
+BCG_AVX512_END
+#endif
+
+// -------------------------------------------------------------------------- //
+// dispatch
+
+template<class T>
+static size_t findNearbyKernel(const T * x, const size_t N, const T value, const double epsilon) {
+  switch (simdLevel()) {
+#ifdef BCG_X86_SIMD
+    case SimdLevel::AVX512 : return findNearbyAVX512(x, N, value, epsilon);
+    case SimdLevel::AVX2   : return findNearbyAVX2  (x, N, value, epsilon);
+#endif
+    default                : return scanGeneric(x, 0, N, value, epsilon);
+  }
+}
+
+// -------------------------------------------------------------------------- //
+// deduplication and grouping
+
+/* The points are sorted into cells of size 2 epsilon along their first (up
+ * to) three coordinates, so the points within epsilon of x lie in at most
+ * 2 x 2 x 2 cells. These are found as floor((x_k -+ epsilon) / (2 epsilon))
+ * per coordinate, which stays exact under rounding as all operations
+ * involved are monotonic. Cell keys are doubles, so coordinates far beyond
+ * the range of integers still work.
+ */
+
+static constexpr size_t gridDimensions = 3;
+typedef std::array<double, gridDimensions> CellKey;
+
+// the next cell key after k, also where k + 1 is not representable
+static double nextKey(const double k) {return k + 1 > k ? k + 1 : std::nextafter(k, std::numeric_limits<double>::infinity());}
+// .......................................................................... //
+// calls consume(i, begin, end) for all points i in ascending order, where
+// [begin, end) are the indices j < i of the points closer than epsilon
+template<class Consumer>
+static void forEarlierNeighbours(const std::vector<std::vector<double>> & points, const double epsilon, unsigned int threads, Consumer consume) {
+  constexpr size_t cellsPerChunk = 256;
+
+  const size_t N        = points.size();
+  const size_t dim      = N ? points[0].size() : 0;
+  const double cellSize = 2 * epsilon;
+  // a single cell if epsilon is too large for a grid
+  const size_t h        = std::isfinite(cellSize) ? std::min(dim, gridDimensions) : 0;
+  for (const auto & point : points) {
+    if (point.size() != dim) {
+      throw std::invalid_argument(THROWTEXT("    points are not of same dimension!"));
+    }
+  }
+
+  // points with NaN or infinite coordinates are not closer than epsilon to
+  // anything. The others are sorted by cell, and by index within a cell.
+  std::vector<std::pair<CellKey, size_t>> entries;
+  CellKey minKey = {}, maxKey = {};
+  if (epsilon > 0) {
+    for (size_t i = 0; i < N; ++i) {
+      if (std::all_of(points[i].begin(), points[i].end(), [] (const double x) {return std::isfinite(x);})) {
+        CellKey key = {};
+        for (size_t k = 0; k < h; ++k) {
+          key[k]    = std::floor(points[i][k] / cellSize);
+          minKey[k] = entries.empty() ? key[k] : std::min(minKey[k], key[k]);
+          maxKey[k] = entries.empty() ? key[k] : std::max(maxKey[k], key[k]);
+        }
+        entries.emplace_back(key, i);
+      }
+    }
+  }
+  std::sort(entries.begin(), entries.end());
+
+  // the occupied cells, each a range of order, and the coordinates in the same order
+  std::vector<size_t>  order(entries.size());
+  std::vector<CellKey> cells;
+  std::vector<size_t>  cellBegin;
+  std::vector<double>  coordinates(entries.size() * dim);
+  for (size_t n = 0; n < entries.size(); ++n) {
+    if (n == 0 || entries[n].first != cells.back()) {
+      cells.push_back(entries[n].first);
+      cellBegin.push_back(n);
+    }
+    order[n] = entries[n].second;
+    std::copy(points[order[n]].begin(), points[order[n]].end(), coordinates.data() + n * dim);
+  }
+  entries = {};
+  cellBegin.push_back(order.size());
+
+  // pairs (i, j) of neighbours with j < i, found cell by cell, such that
+  // the lookups of consecutive points hit the same part of cells
+  const size_t nChunks = (cells.size() + cellsPerChunk - 1) / cellsPerChunk;
+  std::vector<std::vector<std::pair<size_t, size_t>>> pairs(nChunks);
+
+  BCG::parallel_for(nChunks, [&] (const size_t chunk) {
+    const size_t lastCell = std::min(cells.size(), chunk * cellsPerChunk + cellsPerChunk);
+    for (size_t n = cellBegin[chunk * cellsPerChunk]; n < cellBegin[lastCell]; ++n) {
+      const double * x = coordinates.data() + n * dim;
+
+      CellKey lower = {}, upper = {};
+      for (size_t k = 0; k < h; ++k) {
+        // clamped to the occupied keys, which also catches x +- epsilon overflowing
+        lower[k] = std::max(std::floor((x[k] - epsilon) / cellSize), minKey[k]);
+        upper[k] = std::min(std::floor((x[k] + epsilon) / cellSize), maxKey[k]);
+      }
+
+      // the cells with key[2] in [lower[2], upper[2]] are adjacent in cells
+      CellKey key = lower;
+      for   (key[0] = lower[0]; key[0] <= upper[0]; key[0] = nextKey(key[0])) {
+        for (key[1] = lower[1]; key[1] <= upper[1]; key[1] = nextKey(key[1])) {
+          size_t c = std::lower_bound(cells.begin(), cells.end(), key) - cells.begin();
+          for (; c < cells.size() && cells[c][0] == key[0] && cells[c][1] == key[1] && cells[c][2] <= upper[2]; ++c) {
+            // within a cell, the points are in ascending order
+            for (size_t m = cellBegin[c]; m < cellBegin[c + 1] && order[m] < order[n]; ++m) {
+              const double * y = coordinates.data() + m * dim;
+
+              double sum = 0.0;
+              for (size_t k = 0; k < dim; ++k) {sum += (x[k] - y[k]) * (x[k] - y[k]);}
+              if (std::sqrt(sum) < epsilon) {pairs[chunk].emplace_back(order[n], order[m]);}
+            }
+          }
+        }
+      }
+    }
+  }, threads);
+
+  // the neighbours of each point, in order of the points
+  std::vector<size_t> offsets(N + 1, 0);
+  for (const auto & chunk : pairs) {for (const auto & pair : chunk) {++offsets[pair.first + 1];}}
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  std::vector<size_t> neighbours(offsets.back());
+  std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+  for (auto & chunk : pairs) {
+    for (const auto & pair : chunk) {neighbours[fill[pair.first]++] = pair.second;}
+    chunk = {};
+  }
+
+  for (size_t i = 0; i < N; ++i) {consume(i, neighbours.data() + offsets[i], neighbours.data() + offsets[i + 1]);}
+}
+
 // ========================================================================== //
 // procs
 
@@ -67,3 +372,58 @@ std::vector<double> BCG::arange(const double start, const double end, const doub
 
   return reVal;
 }
+// -------------------------------------------------------------------------- //
+const double * BCG::findNearby(const double * begin, const double * end, const double value, const double epsilon) {
+  return begin + findNearbyKernel(begin, end - begin, value, epsilon);
+}
+// .......................................................................... //
+const float * BCG::findNearby(const float * begin, const float * end, const float value, const double epsilon) {
+  return begin + findNearbyKernel(begin, end - begin, value, epsilon);
+}
+// .......................................................................... //
+const std::complex<double> * BCG::findNearby(const std::complex<double> * begin, const std::complex<double> * end, const std::complex<double> value, const double epsilon) {
+  return begin + findNearbyKernel(begin, end - begin, value, epsilon);
+}
+// -------------------------------------------------------------------------- //
+std::vector<size_t> BCG::unique_within(const std::vector<std::vector<double>> & points, double epsilon, unsigned int threads) {
+  std::vector<size_t> reVal;
+  std::vector<bool>   kept(points.size(), false);
+
+  forEarlierNeighbours(points, epsilon, threads, [&] (const size_t i, const size_t * begin, const size_t * end) {
+    if (std::none_of(begin, end, [&] (const size_t j) {return kept[j];})) {
+      kept[i] = true;
+      reVal.push_back(i);
+    }
+  });
+
+  return reVal;
+}
+// .......................................................................... //
+std::vector<size_t> BCG::group_within(const std::vector<std::vector<double>> & points, double epsilon, unsigned int threads) {
+  const size_t N = points.size();
+
+  // union-find, where the root of each tree is its smallest index
+  std::vector<size_t> parent(N);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&] (size_t i) {
+    while (parent[i] != i) {i = parent[i] = parent[parent[i]];}
+    return i;
+  };
+
+  forEarlierNeighbours(points, epsilon, threads, [&] (const size_t i, const size_t * begin, const size_t * end) {
+    for (; begin != end; ++begin) {
+      const size_t a = find(i), b = find(*begin);
+      parent[std::max(a, b)] = std::min(a, b);
+    }
+  });
+
+  // roots are the first points of their groups, and precede all other members
+  std::vector<size_t> reVal(N);
+  size_t nGroups = 0;
+  for (size_t i = 0; i < N; ++i) {
+    const size_t root = find(i);
+    reVal[i] = root == i ? nGroups++ : reVal[root];
+  }
+
+  return reVal;
+}
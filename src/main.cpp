@@ -25,5 +25,8 @@ int main () {
   //unittest_BCG_CONSOLE();
   unittest_BCG_FILES();
   unittest_BCG_TYPES();
+  unittest_BCG_PARALLEL();
+  unittest_BCG_MONTECARLO();
+  unittest_BCG_MATRIX();
   unittest_BCG_ALL();
 }
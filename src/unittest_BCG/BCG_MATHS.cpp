@@ -6,10 +6,13 @@
 #include <iomanip>
 
 #include <vector>
+#include <list>
 #include <complex>
 using namespace std::complex_literals;
 #include <string>
 using namespace std::string_literals;
+#include <random>
+#include <chrono>
 
 // own
 #define BCG_MATHS
@@ -21,138 +24,6 @@ using namespace std::string_literals;
 
 // ========================================================================== //
 
-template<typename Iterator>
-void vd_test (Iterator beginA, Iterator endA,
-              Iterator beginB, Iterator endB
-) {
-  auto N = std::distance(beginA, endA);
-  if (N != std::distance(beginB, endB)) {
-    throw std::invalid_argument("    vectors are not of same dimension!");
-  }
-
-  auto difffunc = std::minus<>();
-
-  std::vector<typename std::iterator_traits<Iterator>::value_type> delta(N);
-  std::transform(
-    beginB, endB,
-    beginA,
-    delta.begin(),
-    difffunc
-  );
-
-  std::vector<double> delta_d(N);
-  std::transform(
-    beginB, endB,
-    beginA,
-    delta_d.begin(),
-    difffunc
-  );
-
-  std::cout << "int" << std::endl;
-  for (auto & elm : delta) {
-    std::cout << elm << std::endl;
-  }
-  std::cout << BCG::norm_Euclidean(delta  .begin(), delta  .end()) << std::endl;
-
-  std::cout << "double" << std::endl;
-  for (auto & elm : delta_d) {
-    std::cout << elm << std::endl;
-  }
-  std::cout << BCG::norm_Euclidean(delta_d.begin(), delta_d.end()) << std::endl;
-
-}
-
-
-template<typename Iterator>
-double vd_test_full(Iterator beginA, Iterator endA,
-                    Iterator beginB, Iterator endB,
-                    std::function<
-                      double(
-                      Iterator,
-                      Iterator
-                    )> normfunc = BCG::norm_Euclidean<Iterator>,
-                    std::function<
-                      typename std::iterator_traits<Iterator>::value_type(
-                      typename std::iterator_traits<Iterator>::value_type,
-                      typename std::iterator_traits<Iterator>::value_type
-                    )> difffunc = std::minus<typename std::iterator_traits<Iterator>::value_type>()
-) {
-  // this is a copy of the vector_distance code in BCG.
-
-  auto N = std::distance(beginA, endA);
-  if (N != std::distance(beginB, endB)) {
-    throw std::invalid_argument(THROWTEXT("    vectors are not of same dimension!"));
-  }
-
-  // and this is what causes the problem if you plug in anything other than a
-  // std::vector for A and B:
-  std::vector<typename std::iterator_traits<Iterator>::value_type> delta(N);
-  std::transform(
-    beginB, endB,
-    beginA,
-    delta.begin(),
-    difffunc
-  );
-
-  /* while delta can be computed from any compatible containers, it will always
-   * be a std::vector.
-   * in the return statement, normfunc is invoked, which assumes its parameters
-   * are of type Iterator, which is related to the container and might not be
-   * a std::vector::iterator.
-   *
-   * There's two ways of fixing this issue:
-   * A) demanding that normfunc has to be a templated in std::vector::iterator
-   *    (probably the easier one)
-   * B) dynamically deciding the type of delta to match that of A, B.
-   */
-
-  // ------------------------------------------------------------------------ //
-  // type test system
-
-  typename std::iterator_traits<Iterator>::value_type iteratorBase;
-
-  const std::type_info& TI_iteratorBase = typeid(iteratorBase);
-  const std::type_info& TI_iterator     = typeid(Iterator);
-  const std::type_info& TI_normfunc     = typeid(normfunc);
-  const std::type_info& TI_difffunc     = typeid(difffunc);
-  const std::type_info& TI_aim          = typeid(BCG::norm_modSquareSum<Iterator>);
-  const std::type_info& TI_delta_begin  = typeid(delta.begin());
-
-  std::cout << "# ---- #" << std::endl;
-  std::cout << "TI_iterator    : " << TI_iterator    .name() << std::endl;
-  std::cout << "TI_iteratorBase: " << TI_iteratorBase.name() << std::endl;
-  std::cout << "TI_difffunc    : " << TI_difffunc    .name() << std::endl;
-  std::cout << "TI_normfunc    : " << TI_normfunc    .name() << std::endl;
-  std::cout << "TI_aim         : " << TI_aim         .name() << std::endl;
-  std::cout << "TI_delta_begin : " << TI_delta_begin .name() << std::endl;
-  /* use c++filt -t in console to demangle the output of these.
-   *
-   * e.g.:
-   * blue-chameleon@blue-chameleon-HP-250-G7-Notebook-PC:~/Codes/Parrot$ c++filt -t
-   * St8functionIFdPKiS1_EE
-   * std::function<double (int const*, int const*)>
-   *
-   * FdPKiS0_E
-   * double (int const*, int const*)
-   *
-   *
-   * With:
-   * TI_iterator    : PKi                         int const*
-   * TI_iteratorBase: i                           int
-   * TI_difffunc    : St8functionIFiiiEE          std::function<int (int, int)>
-   * TI_normfunc    : St8functionIFdPKiS1_EE      std::function<double (int const*, int const*)>
-   * TI_aim         : FdPKiS0_E                                 double (int const*, int const*)
-   * TI_delta_begin : N9__gnu_cxx17__normal_iteratorIPiSt6vectorIiSaIiEEEE
-   *                                              __gnu_cxx::__normal_iterator<int*, std::vector<int, std::allocator<int> > >
-   */
-  std::cout << "# ---- #" << std::endl;
-  // ------------------------------------------------------------------------ //
-
-
-  return normfunc(delta.begin(), delta.end());
-  //return BCG::norm_modSquareSum(delta.begin(), delta.end());
-}
-
 // ========================================================================== //
 // unittest
 
@@ -175,6 +46,95 @@ void unittest_BCG_MATHS() {
   std::cout << "4! = " << BCG::factorial(4) << std::endl;
   std::cout << "(4.0)! = " << BCG::factorial( 4.0 ) << std::endl;
 
+  static_assert(BCG::factorial(20ull) == 2432902008176640000ull);
+  static_assert(BCG::binomial(67, 33) == 14226520737620288370ull);
+  static_assert(BCG::binomial(100, 3) == 161700);
+  std::cout << "20! = " << BCG::factorial(20ull) << ", 170! = " << std::scientific << BCG::factorial(170.0) << ", 171! = " << BCG::factorial(171.0) << std::fixed << std::endl;
+  try {
+    BCG::factorial(13);
+    std::cout << "13! as int: no exception" << std::endl;
+  } catch (const std::overflow_error &) {
+    std::cout << "13! as int: std::overflow_error" << std::endl;
+  }
+  std::cout << "binomial(10, 3) = " << BCG::binomial(10, 3) << ", binomial(3, 10) = " << BCG::binomial(3, 10)
+            << ", binomial(1000, 5) = " << BCG::binomial(1000, 5) << std::endl;
+  try {
+    BCG::binomial(68, 34);
+    std::cout << "binomial(68, 34): no exception" << std::endl;
+  } catch (const std::overflow_error &) {
+    std::cout << "binomial(68, 34): std::overflow_error" << std::endl;
+  }
+  {
+    // the table against Pascal's rule beyond the table
+    bool consistent = true;
+    for (unsigned int n = 2; n < 100; ++n) {
+      for (unsigned int k = 1; k < std::min(n, 9u); ++k) {consistent &= (BCG::binomial(n, k) == BCG::binomial(n - 1, k - 1) + BCG::binomial(n - 1, k));}
+    }
+    std::cout << "binomials follow Pascal's rule: " << (consistent ? "yes" : "NO") << std::endl;
+  }
+  std::cout << "ln(10!) = " << BCG::logFactorial(10) << ", ln(10^6 !) = " << BCG::logFactorial(1000000) << std::endl;
+
+  static_assert(BCG::multinomial({2, 3, 5}) == 2520);
+  std::cout << "multinomial(2, 3, 5)     = " << BCG::multinomial({2, 3, 5}) << std::endl;
+  std::cout << "multinomial(14, 14, 14)  = " << BCG::multinomial({14, 14, 14})
+            << " (via factorials: " << std::scientific << BCG::factorial(42.0) / std::pow(BCG::factorial(14.0), 3) << std::fixed << ")" << std::endl;
+  std::cout << "ln multinomial(14,14,14) = " << std::setprecision(12) << BCG::logMultinomial({14, 14, 14})
+            << " (exact: " << std::log(static_cast<double>(BCG::multinomial({14, 14, 14}))) << ")" << std::setprecision(2) << std::endl;
+  try {
+    BCG::multinomial({15, 15, 15});
+    std::cout << "multinomial(15, 15, 15): no exception" << std::endl;
+  } catch (const std::overflow_error &) {
+    std::cout << "multinomial(15, 15, 15): std::overflow_error" << std::endl;
+  }
+  {
+    // all compositions of 12 into 4 parts, in one batch
+    std::vector<unsigned int> counts;
+    for (unsigned int a = 0; a <= 12; ++a) {
+      for (unsigned int b = 0; a + b <= 12; ++b) {
+        for (unsigned int c = 0; a + b + c <= 12; ++c) {counts.insert(counts.end(), {a, b, c, 12 - a - b - c});}
+      }
+    }
+    const size_t nVectors = counts.size() / 4;
+
+    std::vector<unsigned long long> exact(nVectors);
+    std::vector<double>             logs (nVectors);
+    BCG::multinomial   (counts.data(), nVectors, 4, exact.data());
+    BCG::logMultinomial(counts.data(), nVectors, 4, logs .data());
+
+    double maxDeviation = 0.0;
+    for (size_t i = 0; i < nVectors; ++i) {maxDeviation = std::max(maxDeviation, std::abs(logs[i] - std::log(static_cast<double>(exact[i]))));}
+
+    // the multinomial theorem: the coefficients add up to 4^12
+    std::cout << "batch of " << nVectors << " count vectors: sum = " << std::accumulate(exact.begin(), exact.end(), 0ull)
+              << " (4^12 = " << (1ull << 24) << "), max. deviation of the logs: " << std::scientific << maxDeviation << std::fixed << std::endl;
+  }
+
+  {
+    // all factorials and binomials in the representable range, many times
+    constexpr size_t repetitions = 1000000;
+    unsigned long long sink = 0;
+
+    auto tic = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {
+      for (unsigned long long n = 0; n <= 20; ++n) {
+        unsigned long long loop = 1;
+        for (unsigned long long i = 2; i <= n; ++i) {loop *= i;}
+        sink += loop;
+        asm volatile("" : "+r" (sink));
+      }
+    }
+    auto tac = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {
+      for (unsigned long long n = 0; n <= 20; ++n) {
+        sink += BCG::factorial(n);
+        asm volatile("" : "+r" (sink));
+      }
+    }
+    auto toc = std::chrono::steady_clock::now();
+    std::cout << "factorials 0 .. 20, loop : " << std::chrono::duration<double, std::nano>(tac - tic).count() / (21 * repetitions) << " ns" << std::endl;
+    std::cout << "factorials 0 .. 20, table: " << std::chrono::duration<double, std::nano>(toc - tac).count() / (21 * repetitions) << " ns (checksum " << sink % 1000 << ")" << std::endl;
+  }
+
   auto        x = {-1, 2, 3};
   auto        y = {-4, 5, 6};
 
@@ -188,19 +148,513 @@ void unittest_BCG_MATHS() {
   std::cout << "modsquare_real norm of x  : "  << BCG::norm_modSquareSum_real(x.begin(), x.end()) << std::endl;
   std::cout << "   absSum_real-norm of x  :  " << BCG::norm_absSum_real      (x.begin(), x.end()) << std::endl;
 
+  std::vector<BCG::complex_d_t> c = {3.0 + 4.0i, -1.0i, 2.0};
+  std::cout << "modsquare norm of c       : "  << BCG::norm_modSquareSum(c.begin(), c.end()) << std::endl;
+  std::cout << "   absSum-norm of c       :  " << BCG::norm_absSum      (c.begin(), c.end()) << std::endl;
+  std::cout << "      norm_max of c       :  " << BCG::norm_max         (c.begin(), c.end()) << std::endl;
+
   std::cout << "euclidean norm of y       :  " << BCG::norm_Euclidean(v.begin(), v.end()) << std::endl;
   std::cout << "difference between v and w:  " << BCG::vector_distance(v.begin(), v.end(),
                                                                        w.begin(), w.end() ) << std::endl;
 
-  // this code will give an compile time error
-//   std::cout << "difference between x and y:  " << BCG::vector_distance(x.begin(), x.end(),
-//                                                                        y.begin(), y.end() ) << std::endl;
+  std::cout << "difference between x and y:  " << BCG::vector_distance(x.begin(), x.end(),
+                                                                       y.begin(), y.end() ) << std::endl;
+
+  std::list<int> l(x.begin(), x.end());
+  std::cout << "difference between v and l:  " << BCG::vector_distance(v.begin(), v.end(),
+                                                                       l.begin(), l.end() ) << std::endl;
+  std::cout << "  ... in the maximum norm :  " << BCG::vector_distance(v.begin(), v.end(),
+                                                                       l.begin(), l.end(),
+                                                                       BCG::NormMax()     ) << std::endl;
+  std::cout << "  ... by a range lambda   :  " << BCG::vector_distance(v.begin(), v.end(),
+                                                                       l.begin(), l.end(),
+                                                                       [] (auto begin, auto end) {return BCG::norm_absSum(begin, end);}
+                                                                      ) << std::endl;
+  std::cout << "difference of two vectors :  " << BCG::vector_distance(v, w) << std::endl;
+
+  try {
+    l.pop_back();
+    BCG::vector_distance(v.begin(), v.end(), l.begin(), l.end());
+    std::cout << "vectors of different length: no exception" << std::endl;
+  } catch (const std::invalid_argument &) {
+    std::cout << "vectors of different length: std::invalid_argument" << std::endl;
+  }
+
+  std::cout << std::endl;
+  std::cout << "nearest centroid search, 10^6 distances in 8 dimensions:" << std::endl;
+  {
+    constexpr size_t dim = 8, nPoints = 10000, nCentroids = 100;
+
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+    std::vector<std::vector<double>> points(nPoints, std::vector<double>(dim)), centroids(nCentroids, std::vector<double>(dim));
+    for (auto & point : points   ) {for (auto & x : point) {x = distribution(engine);}}
+    for (auto & point : centroids) {for (auto & x : point) {x = distribution(engine);}}
+
+    // the former implementation: buffer the differences, then take the norm
+    auto buffered = [] (const std::vector<double> & a, const std::vector<double> & b) {
+      std::vector<double> delta(a.size());
+      std::transform(b.begin(), b.end(), a.begin(), delta.begin(), std::minus<>());
+      return BCG::norm_Euclidean(delta.begin(), delta.end());
+    };
+
+    auto benchmark = [&] (const char * label, auto && distance) {
+      size_t checksum = 0;
+      const auto start = std::chrono::steady_clock::now();
+      for (const auto & point : points) {
+        size_t best = 0;
+        double bestDistance = distance(point, centroids[0]);
+        for (size_t c = 1; c < nCentroids; ++c) {
+          const double d = distance(point, centroids[c]);
+          if (d < bestDistance) {bestDistance = d; best = c;}
+        }
+        checksum += best;
+      }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      std::cout << label << elapsed.count() << " s (checksum " << checksum << ")" << std::endl;
+    };
+
+    benchmark("buffered difference vector: ", buffered);
+    benchmark("fused vector_distance     : ", [] (const std::vector<double> & a, const std::vector<double> & b) {return BCG::vector_distance(a, b);});
+  }
+
+  std::cout << std::endl;
+  std::cout << "pairwise distances:" << std::endl;
+  {
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+
+    auto randomPoints = [&] (const size_t N, const size_t dim) {
+      std::vector<std::vector<double>> reVal(N, std::vector<double>(dim));
+      for (auto & point : reVal) {for (auto & x : point) {x = distribution(engine);}}
+      return reVal;
+    };
+
+    // odd sizes, such that there are incomplete row blocks and panels
+    const auto A = randomPoints( 70, 7);
+    const auto B = randomPoints(530, 7);
+
+    auto maxDeviation = [&] (auto norm) {
+      const auto matrix = BCG::pairwise_distance(A, B, norm, 4);
+      double reVal = 0.0;
+      for (size_t i = 0; i < A.size(); ++i) {
+        for (size_t j = 0; j < B.size(); ++j) {
+          const double expected = BCG::vector_distance(A[i].begin(), A[i].end(), B[j].begin(), B[j].end(), norm);
+          reVal = std::max(reVal, std::abs(matrix[i * B.size() + j] - expected));
+        }
+      }
+      return reVal;
+    };
+
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "max. deviation from vector_distance, Euclidean   : " << maxDeviation(BCG::NormEuclidean   ()) << std::endl;
+    std::cout << "max. deviation from vector_distance, mod. square : " << maxDeviation(BCG::NormModSquareSum()) << std::endl;
+    std::cout << "max. deviation from vector_distance, taxicab     : " << maxDeviation(BCG::NormAbsSum      ()) << std::endl;
+    std::cout << "max. deviation from vector_distance, maximum     : " << maxDeviation(BCG::NormMax         ()) << std::endl;
+    std::cout << std::fixed;
+
+    std::cout << "distances of a point to itself (clamped)         : " << BCG::pairwise_distance(A, A)[0] << std::endl;
+
+    try {
+      auto C = B;
+      C[3].push_back(0.0);
+      BCG::pairwise_distance(A, C);
+      std::cout << "points of different dimension: no exception" << std::endl;
+    } catch (const std::invalid_argument &) {
+      std::cout << "points of different dimension: std::invalid_argument" << std::endl;
+    }
+
+    // throughput against the double loop over vector_distance
+    const auto P = randomPoints(2000, 16);
+    const auto Q = randomPoints(2000, 16);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<double> matrix(P.size() * Q.size());
+    for (size_t i = 0; i < P.size(); ++i) {
+      for (size_t j = 0; j < Q.size(); ++j) {matrix[i * Q.size() + j] = BCG::vector_distance(P[i], Q[j]);}
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "2000 x 2000 points in 16 dimensions, double loop      : " << elapsed.count() << " s (checksum " << matrix[12345] << ")" << std::endl;
+
+    start   = std::chrono::steady_clock::now();
+    matrix  = BCG::pairwise_distance(P, Q);
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "2000 x 2000 points in 16 dimensions, pairwise_distance: " << elapsed.count() << " s (checksum " << matrix[12345] << ")" << std::endl;
+  }
+
+  std::cout << std::endl;
+  std::cout << "parallel norms:" << std::endl;
+  {
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+    std::vector<double> xd(10000019);
+    for (auto & x : xd) {x = distribution(engine);}
+
+    const double reference = BCG::norm_Euclidean_parallel(xd.begin(), xd.end(), BCG::ReductionMode::Reproducible, 1);
+    bool reproducible = true;
+    for (unsigned int threads : {2, 3, 4, 8}) {
+      reproducible &= (BCG::norm_Euclidean_parallel(xd.begin(), xd.end(), BCG::ReductionMode::Reproducible, threads) == reference);
+    }
+
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "reproducible Euclidean norm, 1 .. 8 threads : " << (reproducible ? "bit-identical" : "DIFFERS") << std::endl;
+    std::cout << "relative deviation from the serial norm     : " << std::abs(reference / BCG::norm_Euclidean(xd.begin(), xd.end()) - 1.0) << std::endl;
+    std::cout << "fast Euclidean norm, rel. deviation         : " << std::abs(BCG::norm_Euclidean_parallel(xd.begin(), xd.end(), BCG::ReductionMode::Fast, 4) / reference - 1.0) << std::endl;
+    std::cout << "taxicab norm, rel. deviation                : " << std::abs(BCG::norm_absSum_parallel(xd.begin(), xd.end(), BCG::ReductionMode::Reproducible, 4) / BCG::norm_absSum(xd.begin(), xd.end()) - 1.0) << std::endl;
+    std::cout << std::fixed;
+    std::cout << "maximum norm matches serial                 : " << (BCG::norm_max_parallel(xd.begin(), xd.end()) == BCG::norm_max(xd.begin(), xd.end()) ? "yes" : "NO") << std::endl;
+
+    std::list<double> l(xd.begin(), xd.begin() + 1000);
+    std::cout << "list falls back to the serial norm          : " << (BCG::norm_absSum_parallel(l.begin(), l.end()) == BCG::norm_absSum(l.begin(), l.end()) ? "yes" : "NO") << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    double sink = BCG::norm_Euclidean(xd.begin(), xd.end());
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "10^7 elements, serial                       : " << elapsed.count() * 1e3 << " ms" << std::endl;
+
+    start    = std::chrono::steady_clock::now();
+    sink    += BCG::norm_Euclidean_parallel(xd.begin(), xd.end());
+    elapsed  = std::chrono::steady_clock::now() - start;
+    std::cout << "10^7 elements, " << std::setw(2) << BCG::nThreads << " threads, reproducible     : " << elapsed.count() * 1e3 << " ms (checksum " << sink << ")" << std::endl;
+  }
+
+  std::cout << std::endl;
+  std::cout << "SIMD kernels of the real norms:" << std::endl;
+  {
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+
+    // all tail lengths of the AVX-512 and AVX2 kernels, and a long vector
+    double maxDeviation = 0.0;
+    for (size_t N = 0; N < 1000100; N += (N < 70 ? 1 : 999999)) {
+      std::vector<double> xd(N);
+      std::vector<float>  xf(N);
+      for (size_t i = 0; i < N; ++i) {xd[i] = distribution(engine); xf[i] = xd[i];}
+
+      long double squaresD = 0, absD = 0, squaresF = 0, absF = 0;
+      for (size_t i = 0; i < N; ++i) {
+        squaresD += (long double) xd[i] * xd[i];  absD += std::abs((long double) xd[i]);
+        squaresF += (long double) xf[i] * xf[i];  absF += std::abs((long double) xf[i]);
+      }
+
+      auto deviation = [] (double value, long double reference) {return reference ? double(std::abs(value - reference) / reference) : std::abs(value);};
+      maxDeviation = std::max({maxDeviation,
+        deviation(BCG::norm_modSquareSum_real(xd.begin(), xd.end()), squaresD),
+        deviation(BCG::norm_absSum_real      (xd.begin(), xd.end()), absD    ),
+        deviation(BCG::norm_modSquareSum_real(xf.begin(), xf.end()), squaresF),
+        deviation(BCG::norm_absSum_real      (xf.begin(), xf.end()), absF    )
+      });
+    }
+    std::cout << "max. relative deviation from long double sums: " << std::scientific << maxDeviation << std::fixed << std::endl;
+
+    constexpr size_t N = 100000, repetitions = 1000;
+    std::vector<double> xd(N);
+    std::vector<float>  xf(N);
+    for (size_t i = 0; i < N; ++i) {xd[i] = distribution(engine); xf[i] = xd[i];}
+
+    double sink = 0.0;
+    auto tic = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {sink += std::transform_reduce(xd.begin(), xd.end(), xd.begin(), 0.0);}
+    auto tac = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {sink += BCG::norm_modSquareSum_real(xd.begin(), xd.end());}
+    auto toc = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {sink += std::transform_reduce(xf.begin(), xf.end(), 0.0, std::plus<>(), [] (float x) {return std::abs(double(x));});}
+    auto tuc = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {sink += BCG::norm_absSum_real(xf.begin(), xf.end());}
+    auto tyc = std::chrono::steady_clock::now();
+
+    auto throughput = [] (auto from, auto to) {return N * repetitions / std::chrono::duration<double, std::nano>(to - from).count();};
+    std::cout << "modSquareSum, double, transform_reduce: " << throughput(tic, tac) << " G/s" << std::endl;
+    std::cout << "modSquareSum, double, SIMD kernel     : " << throughput(tac, toc) << " G/s" << std::endl;
+    std::cout << "absSum,       float,  transform_reduce: " << throughput(toc, tuc) << " G/s" << std::endl;
+    std::cout << "absSum,       float,  SIMD kernel     : " << throughput(tuc, tyc) << " G/s" << std::endl;
+    std::cout << "(checksum " << sink << ")" << std::endl;
+  }
+
+  std::cout << std::endl;
+  std::cout << "summation modes:" << std::endl;
+  {
+    const std::vector<std::pair<BCG::SummationMode, const char *>> modes = {
+      {BCG::SummationMode::Naive,    "naive   "},
+      {BCG::SummationMode::Pairwise, "pairwise"},
+      {BCG::SummationMode::Neumaier, "Neumaier"}
+    };
+
+    // compensated long double sum as reference
+    auto reference = [] (const auto & x, auto term) {
+      long double sum = 0, compensation = 0;
+      for (const auto elm : x) {
+        const long double y = term((long double) elm), t = sum + y;
+        compensation += (sum >= y) ? (sum - t) + y : (y - t) + sum;
+        sum = t;
+      }
+      return sum + compensation;
+    };
+    auto square = [] (long double x) {return x * x;};
+    auto absolute = [] (long double x) {return std::abs(x);};
+    auto deviation = [] (double value, long double reference) {return double(std::abs(value - reference) / reference);};
+
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+
+    // a long random vector, and one large value followed by many small ones,
+    // each of which is below half an ulp of the large value's square
+    std::vector<double> random(10000019), spread(1000003, 1e-4);
+    for (auto & x : random) {x = distribution(engine);}
+    spread[0] = 1e4;
+
+    const long double randomSquares = reference(random, square), randomAbs = reference(random, absolute);
+    const long double spreadSquares = reference(spread, square), spreadAbs = reference(spread, absolute);
+
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "relative error  | random, squares | random, abs | spread, squares | spread, abs" << std::endl;
+    for (const auto & [mode, label] : modes) {
+      std::cout << label << "        | "
+                << deviation(BCG::norm_modSquareSum_real(random.begin(), random.end(), mode), randomSquares) << "        | "
+                << deviation(BCG::norm_absSum_real      (random.begin(), random.end(), mode), randomAbs    ) << "    | "
+                << deviation(BCG::norm_modSquareSum_real(spread.begin(), spread.end(), mode), spreadSquares) << "        | "
+                << deviation(BCG::norm_absSum_real      (spread.begin(), spread.end(), mode), spreadAbs    ) << std::endl;
+    }
+
+    // the scalar fallback for ranges without contiguous storage
+    std::list<double> spreadList(spread.begin(), spread.end());
+    for (const auto & [mode, label] : modes) {
+      std::cout << label << ", list  | "
+                << "                | "
+                << "            | "
+                << deviation(BCG::norm_modSquareSum_real(spreadList.begin(), spreadList.end(), mode), spreadSquares) << "        | "
+                << deviation(BCG::norm_absSum_real      (spreadList.begin(), spreadList.end(), mode), spreadAbs    ) << std::endl;
+    }
+
+    std::vector<BCG::complex_d_t> spreadComplex(spread.size());
+    for (size_t i = 0; i < spread.size(); ++i) {spreadComplex[i] = BCG::complex_d_t(0.6, 0.8) * spread[i];}
+    std::cout << "complex, Neumaier, rel. error of mod. squares: "
+              << deviation(BCG::norm_modSquareSum(spreadComplex.begin(), spreadComplex.end(), BCG::SummationMode::Neumaier), spreadSquares) << std::endl;
+    std::cout << std::fixed;
+
+    // throughput in and out of cache
+    for (const auto & [N, repetitions] : {std::pair<size_t, size_t>(100000, 2000), std::pair<size_t, size_t>(10000000, 20)}) {
+      std::vector<double> x(random.begin(), random.begin() + N);
+
+      double naiveTime = 0.0, sink = 0.0;
+      for (const auto & [mode, label] : modes) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < repetitions; ++r) {sink += BCG::norm_modSquareSum_real(x.begin(), x.end(), mode);}
+        const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (mode == BCG::SummationMode::Naive) {naiveTime = elapsed;}
+
+        std::cout << "modSquareSum, N = " << std::setw(8) << N << ", " << label << ": "
+                  << N * repetitions / elapsed << " G/s (" << elapsed / naiveTime << " x naive time)" << std::endl;
+      }
+      std::cout << "(checksum " << sink << ")" << std::endl;
+    }
+  }
+
+  std::cout << std::endl;
+  std::cout << "split complex vectors:" << std::endl;
+  {
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+
+    auto randomComplex = [&] (const size_t N) {
+      std::vector<BCG::complex_d_t> reVal(N);
+      for (auto & z : reVal) {z = BCG::complex_d_t(distribution(engine), distribution(engine));}
+      return reVal;
+    };
+
+    // all tail lengths of the kernels
+    double maxDeviation = 0.0;
+    for (size_t N = 0; N < 40; ++N) {
+      const auto x = randomComplex(N), y = randomComplex(N);
+      const BCG::ComplexVector X(x), Y(y.begin(), y.end());
+
+      std::complex<long double> dot = 0, vdot = 0;
+      long double squares = 0;
+      for (size_t i = 0; i < N; ++i) {
+        dot     += std::complex<long double>(x[i]) * std::complex<long double>(y[i]);
+        vdot    += std::conj(std::complex<long double>(x[i])) * std::complex<long double>(y[i]);
+        squares += std::norm(std::complex<long double>(x[i]));
+      }
+
+      auto product = BCG::multiply(X, Y).to_interleaved();
+      auto inPlace = X;
+      BCG::multiply(inPlace, Y, inPlace);
+      auto axpy    = Y;
+      BCG::axpy(BCG::complex_d_t(0.5, -2.0), X, axpy);
+
+      for (size_t i = 0; i < N; ++i) {
+        maxDeviation = std::max({maxDeviation,
+                                 std::abs(product[i] - x[i] * y[i]),
+                                 std::abs(inPlace[i] - x[i] * y[i]),
+                                 std::abs(axpy[i] - (BCG::complex_d_t(0.5, -2.0) * x[i] + y[i]))
+                                });
+      }
+      maxDeviation = std::max({maxDeviation,
+                               double(std::abs(std::complex<long double>(BCG::dot (X, Y)) - dot )),
+                               double(std::abs(std::complex<long double>(BCG::vdot(X, Y)) - vdot)),
+                               double(std::abs(BCG::norm_modSquareSum(X) - squares))
+                              });
+    }
+    std::cout << "max. deviation from the interleaved computation: " << std::scientific << maxDeviation << std::fixed << std::endl;
+
+    const auto roundTrip = randomComplex(17);
+    std::cout << "interleaved -> split -> interleaved is lossless  : " << (BCG::ComplexVector(roundTrip).to_interleaved() == roundTrip ? "yes" : "NO") << std::endl;
+
+    try {
+      BCG::dot(BCG::ComplexVector(3), BCG::ComplexVector(4));
+      std::cout << "vectors of different length: no exception" << std::endl;
+    } catch (const std::invalid_argument &) {
+      std::cout << "vectors of different length: std::invalid_argument" << std::endl;
+    }
+
+    // throughput against std::vector<complex_d_t>, in cache and from memory
+    BCG::complex_d_t sink = 0;
+    for (const size_t N : {1000, 100000}) {
+      const size_t repetitions = 100000000 / N;
+      const auto x = randomComplex(N);
+      auto       y = randomComplex(N);
+      auto       z = y;
+      const BCG::ComplexVector X(x);
+      BCG::ComplexVector       Y(y), Z(N);
+      const BCG::complex_d_t   a(1e-9, 1e-9);
+
+      auto benchmark = [&] (const char * label, auto && interleaved, auto && split) {
+        auto tic = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < repetitions; ++r) {interleaved();}
+        auto tac = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < repetitions; ++r) {split();}
+        auto toc = std::chrono::steady_clock::now();
+
+        const double timeInterleaved = std::chrono::duration<double, std::nano>(tac - tic).count();
+        const double timeSplit       = std::chrono::duration<double, std::nano>(toc - tac).count();
+        std::cout << label << N * repetitions / timeInterleaved << " G/s interleaved, "
+                           << N * repetitions / timeSplit       << " G/s split (" << timeInterleaved / timeSplit << " x)" << std::endl;
+      };
+
+      std::cout << "N = " << N << ":" << std::endl;
+      benchmark("norm_modSquareSum: ",
+        [&] () {sink += BCG::norm_modSquareSum(x.begin(), x.end());},
+        [&] () {sink += BCG::norm_modSquareSum(X);}
+      );
+      benchmark("vdot             : ",
+        [&] () {sink += std::transform_reduce(x.begin(), x.end(), y.begin(), BCG::complex_d_t(0), std::plus<>(), [] (auto u, auto v) {return std::conj(u) * v;});},
+        [&] () {sink += BCG::vdot(X, Y);}
+      );
+      benchmark("axpy             : ",
+        [&] () {for (size_t i = 0; i < N; ++i) {y[i] += a * x[i];}},
+        [&] () {BCG::axpy(a, X, Y);}
+      );
+      benchmark("multiply         : ",
+        [&] () {for (size_t i = 0; i < N; ++i) {z[i] = x[i] * y[i];} sink += z[N / 2];},
+        [&] () {BCG::multiply(X, Y, Z); sink += Z[N / 2];}
+      );
+      sink += y[N / 2] + Y[N / 2];
+    }
+    std::cout << "(checksum " << sink << ")" << std::endl;
+  }
+
+  std::cout << std::endl;
+  std::cout << "k-d tree:" << std::endl;
+  {
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+
+    auto randomPoints = [&] (const size_t N, const size_t dim) {
+      std::vector<std::vector<double>> reVal(N, std::vector<double>(dim));
+      for (auto & point : reVal) {for (auto & x : point) {x = distribution(engine);}}
+      return reVal;
+    };
+
+    const std::vector<std::vector<double>> square = {{0, 0}, {1, 0}, {0, 1}, {1, 1}, {0, 0}};
+    const BCG::KDTree tree(square);
+    std::cout << "first point near (0.9, 0.1), expected 1       : " << tree.findNearbyIdx(std::vector<double>{0.9, 0.1}, 0.5) << std::endl;
+    std::cout << "first point near (0.5, 0.5), expected -1      : " << tree.findNearbyIdx(std::vector<double>{0.5, 0.5}, 0.5) << std::endl;
+    std::cout << "all points near (0, 0), expected 0, 4         : ";
+    for (const auto index : tree.findAllNearbyIdx(std::vector<double>{0, 0}, 0.5)) {std::cout << index << " ";}
+    std::cout << std::endl;
+    std::cout << "3 nearest to (0.1, 0.2), expected 0, 4, 2     : ";
+    for (const auto & neighbour : tree.findNearest(std::vector<double>{0.1, 0.2}, 3)) {std::cout << neighbour.index << " (" << neighbour.distance << ") ";}
+    std::cout << std::endl;
+
+    try {
+      tree.findNearbyIdx(std::vector<double>{0, 0, 0}, 0.5);
+      std::cout << "query of wrong dimension: no exception" << std::endl;
+    } catch (const std::invalid_argument &) {
+      std::cout << "query of wrong dimension: std::invalid_argument" << std::endl;
+    }
+
+    // against a linear scan, with duplicates and tiny leaves to exercise the tie breaking
+    auto mismatches = [&] (auto norm, const size_t dim, const double epsilon) {
+      auto points = randomPoints(5000, dim);
+      for (size_t i = 0; i < 500; ++i) {points.push_back(points[i * 7]);}
+      const auto queries = randomPoints(300, dim);
+
+      const BCG::KDTree cloud(points, norm, 3);
+      const auto first   = cloud.findNearbyIdx(queries, epsilon, 4);
+      const auto nearest = cloud.findNearest  (queries, 10, 4);
+
+      size_t reVal = 0;
+      for (size_t q = 0; q < queries.size(); ++q) {
+        std::vector<BCG::Neighbour> expected;
+        for (size_t i = 0; i < points.size(); ++i) {
+          expected.push_back({i, BCG::vector_distance(queries[q].begin(), queries[q].end(), points[i].begin(), points[i].end(), norm)});
+        }
+
+        ptrdiff_t           expectedFirst = -1;
+        std::vector<size_t> expectedAll;
+        for (const auto & candidate : expected) {
+          if (candidate.distance < epsilon) {
+            if (expectedFirst == -1) {expectedFirst = candidate.index;}
+            expectedAll.push_back(candidate.index);
+          }
+        }
+
+        std::stable_sort(expected.begin(), expected.end(), [] (const auto & lhs, const auto & rhs) {return lhs.distance < rhs.distance;});
+        bool sameNearest = nearest[q].size() == 10;
+        for (size_t n = 0; sameNearest && n < 10; ++n) {sameNearest = nearest[q][n].index == expected[n].index && nearest[q][n].distance == expected[n].distance;}
+
+        reVal += (first[q] != expectedFirst) + (cloud.findAllNearbyIdx(queries[q], epsilon) != expectedAll) + !sameNearest;
+      }
+      return reVal;
+    };
+
+    std::cout << "mismatches against linear scan, Euclidean, 3D : " << mismatches(BCG::NormEuclidean(), 3, 0.1) << std::endl;
+    std::cout << "mismatches against linear scan, Euclidean, 8D : " << mismatches(BCG::NormEuclidean(), 8, 0.6) << std::endl;
+    std::cout << "mismatches against linear scan, maximum, 5D   : " << mismatches(BCG::NormMax      (), 5, 0.2) << std::endl;
+    std::cout << "mismatches against linear scan, taxicab, 4D   : " << mismatches(BCG::NormAbsSum   (), 4, 0.3) << std::endl;
+
+    // throughput against a linear scan in the style of findNearbyIdx
+    for (const size_t dim : {3, 8}) {
+      constexpr size_t N = 1000000, nQueries = 100000, nScans = 20;
+      const double epsilon = dim == 3 ? 0.01 : 0.1;
+
+      const auto points  = randomPoints(N, dim);
+      const auto queries = randomPoints(nQueries, dim);
+
+      auto tic = std::chrono::steady_clock::now();
+      ptrdiff_t checksum = 0;
+      for (size_t q = 0; q < nScans; ++q) {
+        for (size_t i = 0; i < N; ++i) {
+          if (BCG::vector_distance(points[i], queries[q]) < epsilon) {checksum += i; break;}
+        }
+      }
+      auto tac = std::chrono::steady_clock::now();
+      const BCG::KDTree cloud(points);
+      auto toc = std::chrono::steady_clock::now();
+      const auto first = cloud.findNearbyIdx(queries, epsilon);
+      auto tuc = std::chrono::steady_clock::now();
+      const auto nearest = cloud.findNearest(queries, 8);
+      auto tec = std::chrono::steady_clock::now();
+
+      const double timeScan    = std::chrono::duration<double, std::micro>(tac - tic).count() / nScans;
+      const double timeBuild   = std::chrono::duration<double>            (toc - tac).count();
+      const double timeQuery   = std::chrono::duration<double, std::micro>(tuc - toc).count() / nQueries;
+      const double timeNearest = std::chrono::duration<double, std::micro>(tec - tuc).count() / nQueries;
+      std::cout << "10^6 points in " << dim << "D: linear scan " << timeScan << " us/query, build " << timeBuild << " s, findNearbyIdx "
+                << timeQuery << " us/query (" << timeScan / timeQuery << " x), 8 nearest " << timeNearest << " us/query" << std::endl;
+      std::cout << "(checksum " << checksum + std::accumulate(first.begin(), first.end(), ptrdiff_t(0)) + nearest[0][0].index << ")" << std::endl;
+    }
+  }
 
-  // use this as a basis if you want to fix the issue
-//   std::cout << std::endl;
-//   std::cout << vd_test_full(v.begin(), v.end(),
-//                             w.begin(), w.end() ) << std::endl;
-//
-//   std::cout << std::defaultfloat;
   std::cout << std::endl << "DONE."<< std::endl << std::endl;
 }
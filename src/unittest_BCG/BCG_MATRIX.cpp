@@ -0,0 +1,185 @@
+// ========================================================================== //
+// dependencies
+
+// STL
+#include <iostream>
+#include <iomanip>
+
+#include <vector>
+#include <complex>
+#include <random>
+#include <chrono>
+
+// own
+#define BCG_MATRIX
+#define BCG_VECTOR
+#include "BCG.hpp"
+
+// ========================================================================== //
+// helpers
+
+template<class T>
+BCG::Matrix<T> randomMatrix(const size_t rows, const size_t cols, std::mt19937 & engine) {
+  std::uniform_real_distribution<> distribution(-1.0, 1.0);
+
+  BCG::Matrix<T> reVal(rows, cols);
+  for (size_t i = 0; i < reVal.size(); ++i) {
+    if constexpr (BCG::is_complex_v<T>) {reVal.data()[i] = T(distribution(engine), distribution(engine));}
+    else                                {reVal.data()[i] = T(distribution(engine));}
+  }
+  return reVal;
+}
+
+// textbook triple loop on the nested vector layout
+template<class T>
+std::vector<std::vector<T>> multiplyNaive(const std::vector<std::vector<T>> & A, const std::vector<std::vector<T>> & B) {
+  std::vector<std::vector<T>> reVal(A.size(), std::vector<T>(B[0].size(), T(0)));
+  for     (size_t i = 0; i < A.size(); ++i) {
+    for   (size_t k = 0; k < B.size(); ++k) {
+      for (size_t j = 0; j < B[0].size(); ++j) {reVal[i][j] += A[i][k] * B[k][j];}
+    }
+  }
+  return reVal;
+}
+
+template<class T>
+double maxDeviation(const BCG::Matrix<T> & A, const std::vector<std::vector<T>> & B) {
+  double reVal = 0.0;
+  for   (size_t i = 0; i < A.rows(); ++i) {
+    for (size_t j = 0; j < A.cols(); ++j) {reVal = std::max<double>(reVal, std::abs(A(i, j) - B[i][j]));}
+  }
+  return reVal;
+}
+
+// ========================================================================== //
+// unittest
+
+void unittest_BCG_MATRIX() {
+  BCG::init();
+
+  std::cout << ("\x1b[93m");
+  std::cout << "+------------------------------------------------------------------------------+" << std::endl;
+  std::cout << "| Testing BCG Matrix Module                                                    |" << std::endl;
+  std::cout << "+------------------------------------------------------------------------------+" << std::endl;
+  std::cout << ("\x1b[0m")  ;
+  std::cout << std::fixed << std::setprecision(4);
+
+  std::cout << "construction and views:" << std::endl;
+  const BCG::Matrix<double> A = {{1, -2}, {3, 4}};
+  const BCG::Matrix<double> B(std::vector<std::vector<double>>{{1, 0, 2}, {-1, 3, 1}});
+  std::cout << "A                           : " << BCG::vecvec_to_string(A.to_vecvec()) << std::endl;
+  std::cout << "B                           : " << BCG::vecvec_to_string(B.to_vecvec()) << std::endl;
+  std::cout << "A * B                       : " << BCG::vecvec_to_string(BCG::multiply(A, B).to_vecvec()) << std::endl;
+  std::cout << "transpose(B)                : " << BCG::vecvec_to_string(BCG::transpose(B).to_vecvec()) << std::endl;
+  std::cout << "B^T as view, copied         : " << BCG::vecvec_to_string(BCG::Matrix<double>(B.view().transposed()).to_vecvec()) << std::endl;
+  std::cout << "block (0, 1, 2, 2) of B     : " << BCG::vecvec_to_string(BCG::Matrix<double>(B.block(0, 1, 2, 2)).to_vecvec()) << std::endl;
+  std::cout << "A * x, x = (1, 1)           : " << BCG::vector_to_string(BCG::multiply(A, std::vector<double>{1, 1})) << std::endl;
+
+  try {
+    BCG::Matrix<double> ragged(std::vector<std::vector<double>>{{1, 2}, {3}});
+    std::cout << "ragged rows                 : no exception" << std::endl;
+  } catch (const std::invalid_argument &) {
+    std::cout << "ragged rows                 : std::invalid_argument" << std::endl;
+  }
+  try {
+    BCG::multiply(B, A);
+    std::cout << "incompatible product        : no exception" << std::endl;
+  } catch (const std::invalid_argument &) {
+    std::cout << "incompatible product        : std::invalid_argument" << std::endl;
+  }
+  std::cout << std::endl;
+
+  std::cout << "norms of A (expected 5.4772, 6, 7, 5.1167):" << std::endl;
+  std::cout << "Frobenius, 1, inf, 2        : " << BCG::norm_Frobenius(A) << ", " << BCG::norm_1(A) << ", " << BCG::norm_inf(A) << ", " << BCG::norm_2(A) << std::endl;
+  std::cout << "same on A^T as view         : " << BCG::norm_Frobenius(A.view().transposed()) << ", " << BCG::norm_1(A.view().transposed()) << ", "
+                                                << BCG::norm_inf(A.view().transposed()) << ", " << BCG::norm_2(A.view().transposed()) << std::endl;
+
+  const BCG::Matrix<BCG::complex_d_t> Z = {{{0, 3}, {0, 0}}, {{0, 0}, {1, 1}}};
+  std::cout << "diag(3i, 1+i), expected 3.3166, 3, 3, 3:" << std::endl;
+  std::cout << "Frobenius, 1, inf, 2        : " << BCG::norm_Frobenius(Z) << ", " << BCG::norm_1(Z) << ", " << BCG::norm_inf(Z) << ", " << BCG::norm_2(Z) << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "against the textbook triple loop on odd sizes:" << std::endl;
+  {
+    std::mt19937 engine(42);
+
+    const auto X  = randomMatrix<double>(157, 203, engine);
+    const auto Y  = randomMatrix<double>(203, 131, engine);
+    const auto YT = BCG::transpose(Y);
+    const auto reference = multiplyNaive(X.to_vecvec(), Y.to_vecvec());
+
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "double                      : " << maxDeviation(BCG::multiply(X, Y), reference) << std::endl;
+    std::cout << "double, B as transposed view: " << maxDeviation(BCG::multiply(X, YT.view().transposed()), reference) << std::endl;
+    std::cout << "double, 2 threads           : " << maxDeviation(BCG::multiply(X, Y, 2), reference) << std::endl;
+
+    const auto x = randomMatrix<double>(203, 1, engine).to_vecvec();
+    std::vector<double> xVec(203);
+    for (size_t i = 0; i < xVec.size(); ++i) {xVec[i] = x[i][0];}
+    const auto referenceVec = multiplyNaive(X.to_vecvec(), x);
+    const auto matvec       = BCG::multiply(X, xVec);
+    const auto matvecT      = BCG::multiply(BCG::transpose(X).view().transposed(), xVec);
+    double deviation = 0.0;
+    for (size_t i = 0; i < matvec.size(); ++i) {deviation = std::max({deviation, std::abs(matvec[i] - referenceVec[i][0]), std::abs(matvecT[i] - referenceVec[i][0])});}
+    std::cout << "matrix vector, both layouts : " << deviation << std::endl;
+
+    const auto XC = randomMatrix<BCG::complex_d_t>(37, 45, engine);
+    const auto YC = randomMatrix<BCG::complex_d_t>(45, 29, engine);
+    std::cout << "complex                     : " << maxDeviation(BCG::multiply(XC, YC), multiplyNaive(XC.to_vecvec(), YC.to_vecvec())) << std::endl;
+
+    // the spectral norm of a unitary matrix times 2 is 2
+    const double c = std::cos(0.3), s = std::sin(0.3);
+    const BCG::Matrix<BCG::complex_d_t> U = {{{2 * c, 0}, {0, 2 * s}}, {{0, 2 * s}, {2 * c, 0}}};
+    std::cout << "|norm_2(2 U) - 2|           : " << std::abs(BCG::norm_2(U) - 2.0) << std::endl;
+    std::cout << "|Frobenius - (row sums)|    : " << std::abs(BCG::norm_Frobenius(X.block(3, 5, 100, 100)) - BCG::norm_Frobenius(BCG::Matrix<double>(X.block(3, 5, 100, 100)))) << std::endl;
+    std::cout << std::fixed << std::setprecision(4);
+  }
+  std::cout << std::endl;
+
+  std::cout << "throughput, one thread:" << std::endl;
+  {
+    std::mt19937 engine(42);
+    constexpr size_t N = 512;
+    const auto X = randomMatrix<double>(N, N, engine);
+    const auto Y = randomMatrix<double>(N, N, engine);
+    const auto XV = X.to_vecvec(), YV = Y.to_vecvec();
+
+    auto tic = std::chrono::steady_clock::now();
+    const auto naive = multiplyNaive(XV, YV);
+    auto tac = std::chrono::steady_clock::now();
+    const auto blocked = BCG::multiply(X, Y, 1);
+    auto toc = std::chrono::steady_clock::now();
+
+    const double flop = 2.0 * N * N * N;
+    const double timeNaive   = std::chrono::duration<double>(tac - tic).count();
+    const double timeBlocked = std::chrono::duration<double>(toc - tac).count();
+    std::cout << "512 x 512 product, vecvec   : " << flop / timeNaive   * 1e-9 << " GFLOP/s" << std::endl;
+    std::cout << "512 x 512 product, Matrix   : " << flop / timeBlocked * 1e-9 << " GFLOP/s (" << timeNaive / timeBlocked << " x)" << std::endl;
+    std::cout << "(max. deviation " << std::scientific << std::setprecision(2) << maxDeviation(blocked, naive) << std::fixed << std::setprecision(4) << ")" << std::endl;
+
+    constexpr size_t M = 1024, repetitions = 10;
+    const auto T  = randomMatrix<double>(M, M, engine);
+    const auto TV = T.to_vecvec();
+
+    std::vector<std::vector<double>> transposedV;
+    BCG::Matrix<double>              transposed;
+
+    tic = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {
+      transposedV.assign(M, std::vector<double>(M));
+      for   (size_t i = 0; i < M; ++i) {
+        for (size_t j = 0; j < M; ++j) {transposedV[j][i] = TV[i][j];}
+      }
+    }
+    tac = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {transposed = BCG::transpose(T);}
+    toc = std::chrono::steady_clock::now();
+
+    const double timeNaiveT   = std::chrono::duration<double, std::milli>(tac - tic).count() / repetitions;
+    const double timeBlockedT = std::chrono::duration<double, std::milli>(toc - tac).count() / repetitions;
+    std::cout << "1024 x 1024 transpose       : " << timeNaiveT << " ms vecvec, " << timeBlockedT << " ms Matrix ("
+              << timeNaiveT / timeBlockedT << " x, " << (transposed.to_vecvec() == transposedV ? "identical" : "DIFFERENT") << ")" << std::endl;
+  }
+
+  std::cout << std::endl << "DONE."<< std::endl << std::endl;
+}
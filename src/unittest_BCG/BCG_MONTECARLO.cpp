@@ -0,0 +1,95 @@
+// ========================================================================== //
+// dependencies
+
+// STL
+#include <iostream>
+#include <iomanip>
+
+#include <vector>
+#include <random>
+#include <chrono>
+
+// own
+#define BCG_MONTECARLO
+#include "BCG.hpp"
+
+// ========================================================================== //
+// helpers
+
+// pi by hit or miss
+double samplePi(std::mt19937 & engine) {
+  const double x = BCG::get_randPercentage(engine);
+  const double y = BCG::get_randPercentage(engine);
+  return 4.0 * (x * x + y * y < 1.0);
+}
+
+void printResult(const std::string & label, const BCG::MonteCarloResult & result, const double ms) {
+  std::cout << label << result.mean << " +/- " << result.standardError
+            << " after " << result.samples << " samples"
+            << (result.converged ? " (converged)" : "")
+            << ", " << ms << " ms" << std::endl;
+}
+
+// ========================================================================== //
+// unittest
+
+void unittest_BCG_MONTECARLO() {
+  BCG::init();
+
+  std::cout << ("\x1b[93m");
+  std::cout << "+------------------------------------------------------------------------------+" << std::endl;
+  std::cout << "| Testing BCG Monte Carlo Module                                               |" << std::endl;
+  std::cout << "+------------------------------------------------------------------------------+" << std::endl;
+  std::cout << ("\x1b[0m")  ;
+  std::cout << std::setprecision(8);
+
+  std::cout << "running statistics:" << std::endl;
+  BCG::RunningStatistics all, lower, upper;
+  for (int i = 0; i < 1000; ++i) {
+    const double x = 1e9 + i;                                                   // large offset, small spread
+    all.add(x);
+    (i < 300 ? lower : upper).add(x);
+  }
+  lower.merge(upper);
+  std::cout << "mean, variance serial       : " << all  .mean() << ", " << all  .variance() << std::endl;
+  std::cout << "mean, variance merged       : " << lower.mean() << ", " << lower.variance() << std::endl;
+  std::cout << "expected                    : " << 1e9 + 499.5 << ", " << 1000.0 * 1001.0 / 12.0 << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "pi by hit or miss:" << std::endl;
+  auto tic = std::chrono::steady_clock::now();
+  auto serial = BCG::monteCarlo(samplePi, {.maxSamples = 20000000, .threads = 1});
+  auto tac = std::chrono::steady_clock::now();
+  auto parallel = BCG::monteCarlo(samplePi, {.maxSamples = 20000000, .threads = 4});     // more threads than cores still exercises the out-of-order merging
+  auto toc = std::chrono::steady_clock::now();
+
+  printResult("1 thread                    : ", serial  , std::chrono::duration<double, std::milli>(tac - tic).count());
+  printResult("4 threads                   : ", parallel, std::chrono::duration<double, std::milli>(toc - tac).count());
+  std::cout << "bit-identical               : " << ((serial.mean == parallel.mean && serial.variance == parallel.variance) ? "yes" : "NO") << std::endl;
+
+  const BCG::MonteCarloSettings early = {.maxSamples = 1000000000, .targetError = 5e-4, .chunkSize = 10000, .threads = 4};
+  tic = std::chrono::steady_clock::now();
+  auto earlySerial = BCG::monteCarlo(samplePi, {.maxSamples = early.maxSamples, .targetError = early.targetError, .chunkSize = early.chunkSize, .threads = 1});
+  tac = std::chrono::steady_clock::now();
+  auto earlyParallel = BCG::monteCarlo(samplePi, early);
+  toc = std::chrono::steady_clock::now();
+
+  printResult("early stop, 1 thread        : ", earlySerial  , std::chrono::duration<double, std::milli>(tac - tic).count());
+  printResult("early stop, 4 threads       : ", earlyParallel, std::chrono::duration<double, std::milli>(toc - tac).count());
+  std::cout << "bit-identical               : " << ((earlySerial.mean == earlyParallel.mean && earlySerial.samples == earlyParallel.samples) ? "yes" : "NO") << std::endl;
+  std::cout << std::endl;
+
+  std::cout << "with progress bar:" << std::endl;
+  BCG::writeScale(80, 10);
+  BCG::monteCarlo(samplePi, {.maxSamples = 50000000, .showProgress = true});
+
+  try {
+    BCG::monteCarlo(samplePi, {.chunkSize = 0});
+    std::cout << "chunk size 0                : FAILED" << std::endl;
+  } catch (const std::invalid_argument &) {
+    std::cout << "chunk size 0 rejected       : ok" << std::endl;
+  }
+
+  std::cout << std::defaultfloat;
+  std::cout << std::endl << "DONE."<< std::endl << std::endl;
+}
@@ -0,0 +1,84 @@
+// ========================================================================== //
+// dependencies
+
+// STL
+#include <iostream>
+#include <iomanip>
+
+#include <vector>
+#include <numeric>
+#include <cmath>
+#include <chrono>
+
+// own
+#define BCG_PARALLEL
+#include "BCG.hpp"
+
+// ========================================================================== //
+// unittest
+
+void unittest_BCG_PARALLEL() {
+  BCG::init();
+
+  std::cout << ("\x1b[93m");
+  std::cout << "+------------------------------------------------------------------------------+" << std::endl;
+  std::cout << "| Testing BCG Parallel Module                                                  |" << std::endl;
+  std::cout << "+------------------------------------------------------------------------------+" << std::endl;
+  std::cout << ("\x1b[0m")  ;
+
+  std::cout << "threads used by default     : " << BCG::nThreads << std::endl;
+
+  constexpr size_t nChunks = 64, chunkSize = 1000000;
+  std::vector<double> partialSums(nChunks);
+  auto work = [&] (const size_t chunk) {
+    double sum = 0.0;
+    for (size_t i = 0; i < chunkSize; ++i) {sum += std::sqrt(static_cast<double>(chunk * chunkSize + i));}
+    partialSums[chunk] = sum;
+  };
+
+  auto tic = std::chrono::steady_clock::now();
+  BCG::parallel_for(nChunks, work, 1);
+  auto tac = std::chrono::steady_clock::now();
+  const auto serialSums = partialSums;
+  std::fill(partialSums.begin(), partialSums.end(), 0.0);
+  BCG::parallel_for(nChunks, work, 4);
+  auto toc = std::chrono::steady_clock::now();
+
+  std::cout << "parallel matches serial     : " << ((partialSums == serialSums) ? "yes" : "NO") << std::endl;
+  std::cout << "1 thread  sum of roots      : " << std::chrono::duration<double, std::milli>(tac - tic).count() << " ms" << std::endl;
+  std::cout << "4 threads sum of roots      : " << std::chrono::duration<double, std::milli>(toc - tac).count() << " ms" << std::endl;
+
+  int nCalls = 0;
+  BCG::parallel_for(0, [&] (size_t) {++nCalls;});
+  std::cout << "no work items, no calls     : " << (nCalls == 0 ? "yes" : "NO") << std::endl;
+
+  try {
+    BCG::parallel_for(nChunks, [] (const size_t chunk) {
+      if (chunk == 7) {throw std::runtime_error("failure in chunk 7");}
+    }, 4);
+    std::cout << "exception in worker         : NOT PROPAGATED" << std::endl;
+  } catch (const std::runtime_error & e) {
+    std::cout << "exception in worker         : propagated (" << e.what() << ")" << std::endl;
+  }
+
+  // a sum that is sensitive to the order of summation
+  std::vector<double> values(1000003);
+  for (size_t i = 0; i < values.size(); ++i) {values[i] = std::sin(static_cast<double>(i)) * std::pow(10.0, static_cast<double>(i % 17));}
+
+  auto blockSum = [&] (const size_t first, const size_t last) {return std::accumulate(values.begin() + first, values.begin() + last, 0.0);};
+  auto reduce   = [&] (const BCG::ReductionMode mode, const unsigned int threads) {
+    return BCG::parallel_reduce(values.size(), 0.0, blockSum, std::plus<>(), mode, threads);
+  };
+
+  bool reproducible = true, fastDiffers = false;
+  const double reference = reduce(BCG::ReductionMode::Reproducible, 1);
+  for (unsigned int threads : {2, 3, 4, 7}) {
+    reproducible &= (reduce(BCG::ReductionMode::Reproducible, threads) == reference);
+    fastDiffers  |= (reduce(BCG::ReductionMode::Fast, threads) != reduce(BCG::ReductionMode::Fast, 1));
+  }
+  std::cout << "reproducible reduction      : " << (reproducible ? "bit-identical for 1, 2, 3, 4, 7 threads" : "DIFFERS") << std::endl;
+  std::cout << "fast reduction              : " << (fastDiffers  ? "depends on the number of threads" : "identical for all threads") << std::endl;
+  std::cout << "empty reduction             : " << BCG::parallel_reduce(0, -1.0, blockSum, std::plus<>()) << std::endl;
+
+  std::cout << std::endl << "DONE."<< std::endl << std::endl;
+}
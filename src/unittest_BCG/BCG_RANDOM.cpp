@@ -5,10 +5,47 @@
 #include <iostream>
 #include <iomanip>
 
+#include <vector>
+#include <complex>
+#include <thread>
+#include <chrono>
+#include <numeric>
+#include <algorithm>
+
 // own
 #define BCG_RANDOM
 #include "BCG.hpp"
 
+// ========================================================================== //
+// helpers
+
+// prints mean, variance, skewness, excess kurtosis and the fraction beyond 3 sigma
+void printNormalMoments(const std::string & label, const std::vector<double> & samples) {
+  double m1 = 0., m2 = 0., m3 = 0., m4 = 0., beyond3 = 0.;
+  for (auto x : samples) {
+    m1 += x;
+    m2 += x * x;
+    m3 += x * x * x;
+    m4 += x * x * x * x;
+    beyond3 += (std::abs(x) > 3.0);
+  }
+  const double N = samples.size();
+  std::cout << label << m1 / N << ", " << m2 / N << ", " << m3 / N << ", " << m4 / N - 3.0 << ", " << beyond3 / N << std::endl;
+}
+
+void printPoint(const std::vector<double> & point) {
+  std::cout << "(";
+  for (size_t i = 0; i < point.size(); ++i) {std::cout << (i ? ", " : "") << point[i];}
+  std::cout << ") ";
+}
+
+// Sobol' g-function with a_i = i, which integrates to 1 over the unit hypercube
+double sobolG(const double * x, const size_t dims) {
+  double reVal = 1.0;
+  for (size_t i = 0; i < dims; ++i) {reVal *= (std::abs(4.0 * x[i] - 2.0) + i) / (1.0 + i);}
+  return reVal;
+}
+
 // ========================================================================== //
 // unittest
 
@@ -43,6 +80,368 @@ void unittest_BCG_RANDOM() {
     std::cout << BCG::get_randPercentage() << "\t" << BCG::get_randPhase() << std::endl;
   }
 
+  std::cout << std::endl;
+  std::cout << "independent streams, derived from the seed:" << std::endl;
+  auto stream0 = BCG::get_PRNG_stream(0);
+  auto stream1 = BCG::get_PRNG_stream(1);
+  std::cout << "stream 0                    : " << stream0() << std::endl;
+  std::cout << "stream 1                    : " << stream1() << std::endl;
+  std::cout << "stream 0, recreated         : " << BCG::get_PRNG_stream(0)() << std::endl;
+
+  const int nThreads = 4;
+  std::vector<unsigned int> fromThreads(nThreads);
+  std::vector<std::thread>  workers;
+  for (int i = 0; i < nThreads; ++i) {
+    workers.emplace_back([&fromThreads, i] () {
+      BCG::reset_threadPRNG(i);
+      BCG::get_randPercentage(BCG::threadPRNG);
+      fromThreads[i] = BCG::threadPRNG();
+    });
+  }
+  for (auto & worker : workers) {worker.join();}
+
+  bool reproduced = true;
+  for (int i = 0; i < nThreads; ++i) {
+    auto stream = BCG::get_PRNG_stream(i);
+    BCG::get_randPercentage(stream);
+    reproduced &= (stream() == fromThreads[i]);
+  }
+  std::cout << "threadPRNG matches streams  : " << (reproduced ? "yes" : "NO") << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "jump ahead for MT19937:" << std::endl;
+  for (auto consumed : {0, 1, 623, 624, 5000}) {
+    const unsigned long long distance = 12345678ull;
+    std::mt19937 discarded(BCG::seedRNG), jumped(BCG::seedRNG);
+    discarded.discard(consumed + distance);
+    jumped   .discard(consumed);
+
+    auto tic = std::chrono::steady_clock::now();
+    BCG::jump_mt19937(jumped, distance);
+    auto toc = std::chrono::steady_clock::now();
+
+    // the states may be represented differently, hence compare the outputs
+    bool matches = true;
+    for (int i = 0; i < 2000; ++i) {matches &= (jumped() == discarded());}
+
+    std::cout << "jump after " << std::setw(4) << consumed << " outputs matches discard: " << (matches ? "yes" : "NO")
+              << " (" << std::chrono::duration<double, std::milli>(toc - tic).count() << " ms)" << std::endl;
+  }
+
+  auto tic = std::chrono::steady_clock::now();
+  auto farAway = BCG::get_PRNG_substream(1000000000ull, 1000000000ull);
+  auto toc = std::chrono::steady_clock::now();
+  std::cout << "jump by 1e18 outputs        : " << std::chrono::duration<double, std::milli>(toc - tic).count() << " ms, next output " << farAway() << std::endl;
+
+  auto twoJumps = BCG::get_PRNG_substream(1, 1000000000000ull);
+  BCG::jump_mt19937(twoJumps, 1000000000000ull);
+  std::cout << "jump by 1e12 twice vs 2e12  : " << ((twoJumps() == BCG::get_PRNG_substream(2, 1000000000000ull)()) ? "matches" : "DIFFERS") << std::endl;
+
+  BCG::reset_PRNG(BCG::seedRNG);
+  BCG::PRNG.discard(3 * 10000000ull);
+  auto substream = BCG::get_PRNG_substream(3, 10000000ull);
+  bool substreamMatches = true;
+  for (int i = 0; i < 2000; ++i) {substreamMatches &= (substream() == BCG::PRNG());}
+  std::cout << "substream 3 of length 1e7   : " << (substreamMatches ? "matches" : "DIFFERS") << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "counter based engine Philox4x32-10:" << std::endl;
+  auto kat = BCG::Philox4x32::block({0u, 0u, 0u, 0u}, {0u, 0u});
+  std::cout << "known answer test           : " << ((kat == std::array<uint32_t, 4>{0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u}) ? "ok" : "FAILED") << std::endl;
+
+  BCG::reset_CBRNG(BCG::seedRNG);
+  for (int i = 0; i < 1001; ++i) {BCG::CBRNG();}
+  auto sample1001 = BCG::CBRNG();
+  std::cout << "sample 1001, sequential     : " << sample1001 << std::endl;
+  std::cout << "sample 1001, random access  : " << BCG::CBRNG.at(1001) << std::endl;
+  BCG::CBRNG.set_counter(1001);
+  std::cout << "sample 1001, after jump     : " << BCG::CBRNG() << std::endl;
+
+  const int nBench = 10000000;
+  unsigned int checksum = 0u;
+  tic = std::chrono::steady_clock::now();
+  for (int i = 0; i < nBench; ++i) {checksum ^= BCG::PRNG();}
+  auto tac = std::chrono::steady_clock::now();
+  for (int i = 0; i < nBench; ++i) {checksum ^= BCG::CBRNG();}
+  toc = std::chrono::steady_clock::now();
+
+  std::cout << "throughput mt19937          : " << nBench / std::chrono::duration<double, std::micro>(tac - tic).count() << " M/s" << std::endl;
+  std::cout << "throughput Philox4x32-10    : " << nBench / std::chrono::duration<double, std::micro>(toc - tac).count() << " M/s" << std::endl;
+  std::cout << "(checksum " << checksum << ")" << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "bulk generation:" << std::endl;
+  std::vector<double> bulk(nBench);
+
+  BCG::reset_CBRNG(BCG::seedRNG);
+  BCG::CBRNG();
+  BCG::CBRNG();                                                                 // start in the middle of a block
+  BCG::fill_randPercentage(std::span(bulk).first(5));
+  BCG::fill_randPercentage(std::span(bulk).subspan(5));
+  auto bulkCounter = BCG::CBRNG.get_counter();
+
+  bool bulkMatches = true;
+  BCG::CBRNG.set_counter(2);
+  for (int i = 0; i < 1000; ++i) {
+    const uint64_t hi = BCG::CBRNG();
+    const uint64_t lo = BCG::CBRNG();
+    bulkMatches &= (bulk[i] == ((hi << 32u | lo) >> 12u) * 0x1.0p-52);
+  }
+  std::cout << "bulk matches single draws   : " << (bulkMatches ? "yes" : "NO") << std::endl;
+  std::cout << "counter after bulk fill     : " << bulkCounter << std::endl;
+
+  double bulkMin = 1., bulkMax = 0., bulkMean = 0.;
+  for (auto x : bulk) {bulkMin = std::min(bulkMin, x); bulkMax = std::max(bulkMax, x); bulkMean += x;}
+  std::cout << "min, max, mean of 1e7 values: " << bulkMin << ", " << bulkMax << ", " << bulkMean / nBench << std::endl;
+
+  double scalarSum = 0.;
+  tic = std::chrono::steady_clock::now();
+  for (int i = 0; i < nBench; ++i) {scalarSum += BCG::get_randPercentage();}
+  tac = std::chrono::steady_clock::now();
+  BCG::fill_randPhase(bulk);
+  toc = std::chrono::steady_clock::now();
+
+  std::cout << "throughput get_randPercentage: " << nBench / std::chrono::duration<double, std::micro>(tac - tic).count() << " M/s" << std::endl;
+  std::cout << "throughput fill_randPhase    : " << nBench / std::chrono::duration<double, std::micro>(toc - tac).count() << " M/s" << std::endl;
+  std::cout << "(checksum " << scalarSum + bulk[0] << ")" << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "random phase factors:" << std::endl;
+  const int nPhases = nBench / 4;
+  std::vector<std::complex<double>> phaseFactors(nPhases);
+
+  tic = std::chrono::steady_clock::now();
+  for (auto & z : phaseFactors) {z = std::polar(1.0, BCG::get_randPhase());}
+  tac = std::chrono::steady_clock::now();
+  BCG::fill_randPhaseFactor(phaseFactors);
+  toc = std::chrono::steady_clock::now();
+
+  double maxModDeviation = 0.;
+  std::complex<double> phaseMean = 0., phaseSquareMean = 0.;
+  for (auto & z : phaseFactors) {
+    maxModDeviation  = std::max(maxModDeviation, std::abs(std::abs(z) - 1.0));
+    phaseMean       += z;
+    phaseSquareMean += z * z;
+  }
+  std::cout << "max. deviation of |z| from 1: " << std::scientific << maxModDeviation << std::fixed << std::endl;
+  std::cout << "mean of z, z^2 (expect 0)   : " << phaseMean / double(nPhases) << ", " << phaseSquareMean / double(nPhases) << std::endl;
+
+  std::vector<double> phaseRe(5), phaseIm(5);
+  BCG::fill_randPhaseFactor(phaseRe, phaseIm);
+  std::cout << "split real and imag parts   : " << phaseRe[0] << " + " << phaseIm[0] << "i" << std::endl;
+
+  std::cout << "throughput polar(1, phase)  : " << nPhases / std::chrono::duration<double, std::micro>(tac - tic).count() << " M/s" << std::endl;
+  std::cout << "throughput fill_randPhaseFactor: " << nPhases / std::chrono::duration<double, std::micro>(toc - tac).count() << " M/s" << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "normal distribution (Ziggurat):" << std::endl;
+  std::vector<double> normals(nBench), zigguratNormals(nBench), bulkNormals(nBench);
+  std::normal_distribution<> stdNormal;
+
+  tic = std::chrono::steady_clock::now();
+  for (auto & x : normals) {x = stdNormal(BCG::PRNG);}
+  tac = std::chrono::steady_clock::now();
+  for (auto & x : zigguratNormals) {x = BCG::get_randNormal();}
+  toc = std::chrono::steady_clock::now();
+  BCG::fill_randNormal(bulkNormals);
+  auto tuc = std::chrono::steady_clock::now();
+
+  printNormalMoments("std::normal_distribution: mean, var, skew, exkurt, P(|x|>3): ", normals);
+  printNormalMoments("get_randNormal          : mean, var, skew, exkurt, P(|x|>3): ", zigguratNormals);
+  printNormalMoments("fill_randNormal         : mean, var, skew, exkurt, P(|x|>3): ", bulkNormals);
+  std::cout <<       "expected                : mean, var, skew, exkurt, P(|x|>3): 0, 1, 0, 0, 0.002700" << std::endl;
+
+  std::cout << "throughput std::normal_distribution: " << nBench / std::chrono::duration<double, std::micro>(tac - tic).count() << " M/s" << std::endl;
+  std::cout << "throughput get_randNormal          : " << nBench / std::chrono::duration<double, std::micro>(toc - tac).count() << " M/s" << std::endl;
+  std::cout << "throughput fill_randNormal         : " << nBench / std::chrono::duration<double, std::micro>(tuc - toc).count() << " M/s" << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "alias method and multinomial counts:" << std::endl;
+  BCG::AliasTable aliasTable({1.0, 2.0, 0.0, 3.0, 4.0});
+  std::vector<int> histogram(aliasTable.size());
+  for (int i = 0; i < nBench; ++i) {++histogram[aliasTable()];}
+  std::cout << "frequencies, 1e7 draws      : ";
+  for (size_t i = 0; i < histogram.size(); ++i) {std::cout << double(histogram[i]) / nBench << " ";}
+  std::cout << std::endl;
+  std::cout << "expected                    : ";
+  for (size_t i = 0; i < histogram.size(); ++i) {std::cout << aliasTable.probability(i) << " ";}
+  std::cout << std::endl;
+
+  auto counts = BCG::get_randMultinomial(nBench, {1.0, 2.0, 0.0, 3.0, 4.0});
+  std::cout << "multinomial, 1e7 trials     : ";
+  for (auto c : counts) {std::cout << double(c) / nBench << " ";}
+  std::cout << std::endl;
+
+  try {
+    BCG::AliasTable invalid({1.0, -1.0});
+    std::cout << "negative weight accepted    : FAILED" << std::endl;
+  } catch (const std::invalid_argument &) {
+    std::cout << "negative weight rejected    : ok" << std::endl;
+  }
+
+  const std::vector<double> manyWeights(1000000, 1.0);
+  tic = std::chrono::steady_clock::now();
+  auto manyCounts = BCG::get_randMultinomial(1000000000ull, manyWeights);
+  tac = std::chrono::steady_clock::now();
+  unsigned long long manyTotal = 0u;
+  for (auto c : manyCounts) {manyTotal += c;}
+  std::cout << "1e9 trials over 1e6 categories: " << manyTotal << " trials in " << std::chrono::duration<double, std::milli>(tac - tic).count() << " ms" << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "shuffling and sampling:" << std::endl;
+  {
+    constexpr size_t N = 50000000;
+    std::vector<uint32_t> stdShuffled(N), shuffled(N), reshuffled(N);
+    std::iota(stdShuffled.begin(), stdShuffled.end(), 0u);
+    std::iota(shuffled   .begin(), shuffled   .end(), 0u);
+    std::iota(reshuffled .begin(), reshuffled .end(), 0u);
+
+    tic = std::chrono::steady_clock::now();
+    std::shuffle(stdShuffled.begin(), stdShuffled.end(), BCG::PRNG);
+    tac = std::chrono::steady_clock::now();
+    BCG::parallel_shuffle(shuffled.begin(), shuffled.end());
+    toc = std::chrono::steady_clock::now();
+    BCG::parallel_shuffle(reshuffled.begin(), reshuffled.end(), 0, 3);
+
+    // elements that stay in the same eighth of the range: 1/8 for a uniform permutation
+    size_t sameEighth = 0;
+    for (size_t i = 0; i < N; ++i) {sameEighth += (8 * i / N == 8 * size_t(shuffled[i]) / N);}
+
+    std::cout << "reproducible with 3 threads : " << ((shuffled == reshuffled) ? "yes" : "NO") << std::endl;
+    std::cout << "stayed in the same eighth   : " << double(sameEighth) / N << " (expected 0.125)" << std::endl;
+    std::sort(reshuffled.begin(), reshuffled.end());
+    std::cout << "is a permutation            : " << ((reshuffled[0] == 0 && reshuffled[N - 1] == N - 1 && std::adjacent_find(reshuffled.begin(), reshuffled.end()) == reshuffled.end()) ? "yes" : "NO") << std::endl;
+    std::cout << "std::shuffle, 5e7 elements     : " << std::chrono::duration<double, std::milli>(tac - tic).count() << " ms" << std::endl;
+    std::cout << "parallel_shuffle, 5e7 elements : " << std::chrono::duration<double, std::milli>(toc - tac).count() << " ms" << std::endl;
+  }
+
+  std::vector<int> firstPosition(5, 0);
+  for (int i = 0; i < 100000; ++i) {
+    std::array<int, 5> small = {0, 1, 2, 3, 4};
+    BCG::parallel_shuffle(small.begin(), small.end(), i);
+    ++firstPosition[small[0]];
+  }
+  std::cout << "first of 5 elements, 1e5 runs: ";
+  for (auto c : firstPosition) {std::cout << c / 1e5 << " ";}
+  std::cout << std::endl;
+
+  std::vector<int> indexHistogram(20, 0);
+  for (int i = 0; i < 10000; ++i) {
+    for (auto idx : BCG::sample_indices(1, 20)) {++indexHistogram[idx];}                  // Floyd
+    for (auto idx : BCG::sample_indices(5, 20)) {++indexHistogram[idx];}                  // Vitter's Algorithm A
+  }
+  std::cout << "6 of 20 indices, frequencies: ";
+  for (auto c : indexHistogram) {std::cout << c / 1e4 << " ";}
+  std::cout << "(expected 0.3 each)" << std::endl;
+
+  tic = std::chrono::steady_clock::now();
+  auto someIndices = BCG::sample_indices(1000000, 1000000000);
+  tac = std::chrono::steady_clock::now();
+  auto manyIndices = BCG::sample_indices(10000000, 100000000);
+  toc = std::chrono::steady_clock::now();
+  std::cout << "1e6 of 1e9 indices          : " << std::chrono::duration<double, std::milli>(tac - tic).count() << " ms, sorted and unique: "
+            << ((std::adjacent_find(someIndices.begin(), someIndices.end(), std::greater_equal<>()) == someIndices.end()) ? "yes" : "NO") << std::endl;
+  std::cout << "1e7 of 1e8 indices          : " << std::chrono::duration<double, std::milli>(toc - tac).count() << " ms, sorted and unique: "
+            << ((std::adjacent_find(manyIndices.begin(), manyIndices.end(), std::greater_equal<>()) == manyIndices.end()) ? "yes" : "NO") << std::endl;
+  manyIndices = std::vector<size_t>();
+
+  std::vector<int> reservoirHistogram(100, 0);
+  std::vector<int> stream(100);
+  std::iota(stream.begin(), stream.end(), 0);
+  for (int i = 0; i < 10000; ++i) {
+    BCG::ReservoirSampler<int> sampler(10, i);
+    for (auto x : stream) {sampler.add(x);}
+    for (auto x : sampler.sample()) {++reservoirHistogram[x];}
+  }
+  std::cout << "reservoir 10 of 100, freq.  : " << *std::min_element(reservoirHistogram.begin(), reservoirHistogram.end()) / 1e4
+            << " .. " << *std::max_element(reservoirHistogram.begin(), reservoirHistogram.end()) / 1e4 << " (expected 0.1)" << std::endl;
+
+  BCG::ReservoirSampler<int> itemwise(5, 42), skipping(5, 42);
+  std::vector<int> longStream(10000000);
+  std::iota(longStream.begin(), longStream.end(), 0);
+  for (auto x : longStream) {itemwise.add(x);}
+  tic = std::chrono::steady_clock::now();
+  skipping.add(longStream.begin(), longStream.end());
+  tac = std::chrono::steady_clock::now();
+  std::cout << "range add matches items     : " << ((itemwise.sample() == skipping.sample() && skipping.count() == longStream.size()) ? "yes" : "NO")
+            << ", " << std::chrono::duration<double, std::micro>(tac - tic).count() << " us for 1e7 items" << std::endl;
+
+  std::cout << std::endl;
+  std::cout << "low discrepancy sequences:" << std::endl;
+  BCG::SobolSequence  sobol (5), scrambledSobol (5, 42u), seekSobol (5, 42u);
+  BCG::HaltonSequence halton(5), scrambledHalton(5, 42u), seekHalton(5, 42u);
+
+  std::cout << "first Sobol points          : ";
+  for (int i = 0; i < 4; ++i) {printPoint(sobol());}
+  std::cout << std::endl;
+  std::cout << "first Halton points         : ";
+  for (int i = 0; i < 4; ++i) {printPoint(halton());}
+  std::cout << std::endl;
+
+  for (int i = 0; i < 12345; ++i) {scrambledSobol(); scrambledHalton();}
+  seekSobol .set_index(12345);
+  seekHalton.set_index(12345);
+  std::cout << "Sobol  set_index matches    : " << ((scrambledSobol () == seekSobol ()) ? "yes" : "NO") << std::endl;
+  std::cout << "Halton set_index matches    : " << ((scrambledHalton() == seekHalton()) ? "yes" : "NO") << std::endl;
+
+  std::vector<double> block(5 * 100);
+  seekSobol.set_index(0);
+  seekSobol.fill(block);
+  scrambledSobol.set_index(0);
+  bool fillMatches = true;
+  for (int i = 0; i < 100; ++i) {fillMatches &= (scrambledSobol() == std::vector<double>(block.begin() + 5 * i, block.begin() + 5 * i + 5));}
+  std::cout << "Sobol  fill matches scalar  : " << (fillMatches ? "yes" : "NO") << std::endl;
+
+  try {
+    seekSobol.set_index(BCG::SobolSequence::max_index - 1);
+    seekSobol();
+    seekSobol();
+    std::cout << "exhausted Sobol sequence    : FAILED" << std::endl;
+  } catch (const std::out_of_range &) {
+    std::cout << "exhausted Sobol sequence    : ok" << std::endl;
+  }
+
+  tic = std::chrono::steady_clock::now();
+  BCG::SobolSequence  wideSobol (1000, 7u);
+  BCG::HaltonSequence wideHalton(1000, 7u);
+  tac = std::chrono::steady_clock::now();
+  std::vector<double> widePoints(1000 * 4096);
+  wideSobol.fill(widePoints);
+  double wideMean = 0.0;
+  for (auto x : widePoints) {wideMean += x;}
+  std::cout << "1000 dimensions, setup      : " << std::chrono::duration<double, std::milli>(tac - tic).count() << " ms, "
+            << "largest Halton base " << wideHalton.base(999) << ", "
+            << "mean Sobol coordinate " << wideMean / widePoints.size() << std::endl;
+
+  std::cout << "convergence of the 10D Sobol' g-function, |error| after N points:" << std::endl;
+  std::cout << "      N       PRNG      Sobol  scr.Sobol     Halton scr.Halton" << std::endl;
+  {
+    constexpr size_t dims = 10;
+    BCG::SobolSequence  cSobol(dims), cScrambledSobol(dims, 3u);
+    BCG::HaltonSequence cHalton(dims), cScrambledHalton(dims, 3u);
+
+    std::vector<double> point(dims);
+    std::array<double, 5> sums = {};
+    size_t N = 0;
+
+    std::cout << std::scientific << std::setprecision(2);
+    for (size_t target = 1u << 10u; target <= (1u << 20u); target <<= 2u) {
+      for (; N < target; ++N) {
+        for (auto & x : point) {x = BCG::get_randPercentage();}
+        sums[0] += sobolG(point.data(), dims);
+
+        cSobol          .fill(point); sums[1] += sobolG(point.data(), dims);
+        cScrambledSobol .fill(point); sums[2] += sobolG(point.data(), dims);
+        cHalton         .fill(point); sums[3] += sobolG(point.data(), dims);
+        cScrambledHalton.fill(point); sums[4] += sobolG(point.data(), dims);
+      }
+
+      std::cout << std::setw(7) << N;
+      for (auto sum : sums) {std::cout << std::setw(11) << std::abs(sum / N - 1.0);}
+      std::cout << std::endl;
+    }
+  }
+
   std::cout << std::defaultfloat;
   std::cout << std::endl << "DONE."<< std::endl << std::endl;
 }
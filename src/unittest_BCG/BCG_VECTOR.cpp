@@ -5,7 +5,19 @@
 #include <iostream>
 #include <iomanip>
 
+#include <vector>
+#include <list>
+#include <complex>
+#include <string>
+#include <functional>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+
 #define BCG_VECTOR
+#define BCG_MATHS
 #include "BCG.hpp"
 
 // ========================================================================== //
@@ -51,6 +63,339 @@ void unittest_BCG_VECTOR() {
   std::cout << "21 values between -5 and +5                    : " << BCG::vector_to_string( BCG::linspace(-5, 5, 21) ) << std::endl;
   std::cout << "values between -5 and +5 with an increment of 2: " << BCG::vector_to_string( BCG::arange  (-5, 5, 2 ) ) << std::endl;
 
+  std::cout << std::endl;
+  std::cout << "lazy vector arithmetic:" << std::endl;
+  {
+    const auto u = BCG::linspace(0, 1, 5);
+    const auto v = BCG::linspace(1, 2, 5);
+    std::cout << std::setprecision(2);
+
+    const std::vector<double> w = BCG::lazy(u) * 2.0 + v;
+    std::cout << "u * 2 + v                   : " << BCG::vector_to_string(w) << std::endl;
+    std::cout << "abs(u - v)                  : " << BCG::vector_to_string(BCG::abs(BCG::lazy(u) - v).evaluate()) << std::endl;
+    std::cout << "1 / sqrt(v) - exp(-u)       : " << BCG::vector_to_string((1.0 / BCG::sqrt(v) - BCG::exp(-BCG::lazy(u))).evaluate()) << std::endl;
+    std::cout << "map(u, x -> x^2)            : " << BCG::vector_to_string(BCG::map(u, [] (double x) {return x * x;}).evaluate()) << std::endl;
+    {
+      using namespace BCG;
+      const std::vector<double> difference = v - u;
+      std::cout << "v - u, using namespace BCG  : " << vector_to_string(difference) << std::endl;
+    }
+
+    const std::vector<BCG::complex_d_t> z = {{1, 1}, {0, 2}};
+    const std::vector<BCG::complex_d_t> iz = BCG::lazy(z) * BCG::complex_d_t(0, 1);
+    std::cout << "i * (1+i, 2i)               : " << BCG::vector_to_string(iz) << std::endl;
+
+    auto inPlace = u;
+    BCG::assign(inPlace, BCG::lazy(inPlace) * inPlace + 1.0);
+    std::cout << "u = u * u + 1, in place     : " << BCG::vector_to_string(inPlace) << std::endl;
+
+    const auto expression = BCG::lazy(u) + v;
+    std::cout << "sum via iterators           : " << std::accumulate(expression.begin(), expression.end(), 0.0) << std::endl;
+    std::cout << "norm_Euclidean(u - v)       : " << BCG::norm_Euclidean(BCG::lazy(u) - v) << " (expected " << std::sqrt(5.0) << ")" << std::endl;
+
+    try {
+      const std::vector<double> mismatch = BCG::lazy(u) + BCG::linspace(0, 1, 4);
+      std::cout << "vectors of different size   : no exception" << std::endl;
+    } catch (const std::invalid_argument &) {
+      std::cout << "vectors of different size   : std::invalid_argument" << std::endl;
+    }
+
+    // chained std::transform with temporaries against one fused loop
+    constexpr size_t N = 1000000, repetitions = 50;
+    const auto a = BCG::linspace(-1, 1, N);
+    const auto c = BCG::linspace( 2, 3, N);
+    std::vector<double> result(N);
+
+    auto tic = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {
+      std::vector<double> scaled(N), shifted(N);
+      std::transform(a.begin(), a.end(), scaled.begin(), [] (double x) {return x * 2.0;});
+      std::transform(scaled.begin(), scaled.end(), c.begin(), shifted.begin(), std::plus<>());
+      std::transform(shifted.begin(), shifted.end(), result.begin(), [] (double x) {return std::abs(x);});
+    }
+    auto tac = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {BCG::assign(result, BCG::abs(BCG::lazy(a) * 2.0 + c));}
+    auto toc = std::chrono::steady_clock::now();
+
+    double timeChained = std::chrono::duration<double, std::milli>(tac - tic).count() / repetitions;
+    double timeLazy    = std::chrono::duration<double, std::milli>(toc - tac).count() / repetitions;
+    std::cout << "abs(a * 2 + c), 1e6 elements: " << timeChained << " ms with temporaries, " << timeLazy << " ms lazy (" << timeChained / timeLazy << " x)" << std::endl;
+
+    double sink = 0.0;
+    tic = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {
+      std::vector<double> delta(N);
+      std::transform(a.begin(), a.end(), c.begin(), delta.begin(), std::minus<>());
+      sink += BCG::norm_Euclidean(delta.begin(), delta.end());
+    }
+    tac = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {sink -= BCG::norm_Euclidean(BCG::lazy(a) - c);}
+    toc = std::chrono::steady_clock::now();
+
+    timeChained = std::chrono::duration<double, std::milli>(tac - tic).count() / repetitions;
+    timeLazy    = std::chrono::duration<double, std::milli>(toc - tac).count() / repetitions;
+    std::cout << "norm_Euclidean(a - c)       : " << timeChained << " ms with temporary,   " << timeLazy << " ms lazy (" << timeChained / timeLazy << " x)" << std::endl;
+    std::cout << "(difference of the results " << std::scientific << sink / repetitions << std::fixed << ")" << std::endl;
+  }
+
+  std::cout << std::endl;
+  std::cout << "vectorized findNearby:" << std::endl;
+  {
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+
+    // against the generic loop, with a lambda as absfunc such that the SIMD version is not used
+    auto mismatches = [&] (auto zero) {
+      using T = decltype(zero);
+      auto random = [&] () {
+        if constexpr (std::is_same_v<T, std::complex<double>>) {return T(distribution(engine), distribution(engine));}
+        else                                                   {return T(distribution(engine));}
+      };
+
+      std::vector<T> x(1013);
+      for (auto & element : x) {element = random();}
+
+      size_t reVal = 0;
+      for (size_t trial = 0; trial < 2000; ++trial) {
+        // alternately random thresholds and exact distances to an element, to hit the boundary
+        const T      value   = random();
+        const double epsilon = trial % 2 ? 1e-3 * (trial % 50) : std::abs(x[trial % x.size()] - value);
+        const auto   generic = BCG::findNearbyIdx(x.begin(), x.end(), value, epsilon, [] (const auto & d) -> double {return std::abs(d);});
+        reVal += BCG::findNearbyIdx(x.begin(), x.end(), value, epsilon) != generic;
+      }
+      return reVal;
+    };
+    std::cout << "mismatches against generic loop, double : " << mismatches(0.0) << std::endl;
+    std::cout << "mismatches against generic loop, float  : " << mismatches(0.0f) << std::endl;
+    std::cout << "mismatches against generic loop, complex: " << mismatches(std::complex<double>(0.0)) << std::endl;
+
+    const std::vector<double> z = {1.0, 2.0, 3.0};
+    const std::function<double(double)>         absfunc  = [] (double d) {return std::abs(d);};
+    const std::function<double(double, double)> difffunc = std::minus<double>();
+    std::cout << "std::function arguments, index of 2.1  : " << BCG::findNearbyIdx(z.begin(), z.end(), 2.1, 0.5, absfunc, difffunc) << std::endl;
+
+    const std::vector<double> w = {0.0, 2.9, 5.0};
+    std::cout << "integer 2 in 0, 2.9, 5 within 0.5      : " << BCG::findNearbyIdx(w.begin(), w.end(), 2, 0.5) << " (expected -1)" << std::endl;
+
+    // throughput on 1e7 elements, searching a value that is only present at the end
+    constexpr size_t N = 10000000, repetitions = 5;
+    auto benchmark = [&] (const std::string & label, auto zero) {
+      using T = decltype(zero);
+      std::vector<T> x(N);
+      for (auto & element : x) {element = T(distribution(engine));}
+      const T needle = T(5.0);
+      x.back() = needle;
+
+      const std::function<double(T)> absfunc  = [] (T d) {return std::abs(d);};
+      const std::function<T(T, T)>   difffunc = std::minus<T>();
+
+      int sink = 0;
+      auto tic = std::chrono::steady_clock::now();
+      for (size_t r = 0; r < repetitions; ++r) {sink += BCG::findNearbyIdx(x.begin(), x.end(), needle, 1e-3, absfunc, difffunc);}
+      auto tac = std::chrono::steady_clock::now();
+      for (size_t r = 0; r < repetitions; ++r) {sink += BCG::findNearbyIdx(x.begin(), x.end(), needle, 1e-3, [] (T d) -> double {return std::abs(d);});}
+      auto toc = std::chrono::steady_clock::now();
+      for (size_t r = 0; r < repetitions; ++r) {sink += BCG::findNearbyIdx(x.begin(), x.end(), needle, 1e-3);}
+      auto tuc = std::chrono::steady_clock::now();
+
+      const double timeFunction = std::chrono::duration<double, std::milli>(tac - tic).count() / repetitions;
+      const double timeLambda   = std::chrono::duration<double, std::milli>(toc - tac).count() / repetitions;
+      const double timeSIMD     = std::chrono::duration<double, std::milli>(tuc - toc).count() / repetitions;
+      std::cout << label << timeFunction << " ms std::function, " << timeLambda << " ms lambda, " << timeSIMD << " ms SIMD ("
+                << timeFunction / timeSIMD << " x, found " << sink / 3 / repetitions << ")" << std::endl;
+    };
+    std::cout << std::setprecision(2);
+    benchmark("1e7 double : ", 0.0);
+    benchmark("1e7 float  : ", 0.0f);
+    benchmark("1e7 complex: ", std::complex<double>(0.0));
+  }
+
+  std::cout << std::endl;
+  std::cout << "findNearby on sorted grids:" << std::endl;
+  {
+    std::mt19937 engine(42);
+
+    const auto grid  = BCG::linspace(-5, 5, 1000001);
+    const double eps = 0.6e-5;
+    std::uniform_real_distribution<> distribution(-5.1, 5.1);
+
+    std::vector<double> values(1000);
+    for (auto & value : values) {value = distribution(engine);}
+    // exactly on the boundary of the run, and outside the grid
+    values[0] = grid[123456] + eps;
+    values[1] = grid[123456] - eps;
+    values[2] = -7.0;
+    values[3] = std::nan("");
+
+    auto tic = std::chrono::steady_clock::now();
+    std::vector<int> linear;
+    for (const auto value : values) {linear.push_back(BCG::findNearbyIdx(grid.begin(), grid.end(), value, eps));}
+    auto tac = std::chrono::steady_clock::now();
+    std::vector<int> sorted, uniform;
+    for (const auto value : values) {sorted .push_back(BCG::findNearbyIdxSorted (grid.begin(), grid.end(), value, eps));}
+    auto toc = std::chrono::steady_clock::now();
+    for (const auto value : values) {uniform.push_back(BCG::findNearbyIdxUniform(grid.begin(), grid.end(), value, eps));}
+    auto tuc = std::chrono::steady_clock::now();
+    const auto batch = BCG::findNearbyIdxSorted(grid.begin(), grid.end(), values, eps);
+    auto tec = std::chrono::steady_clock::now();
+
+    const std::list<double> gridList(grid.begin(), grid.end());
+    const auto batchList = BCG::findNearbyIdxSorted(gridList.begin(), gridList.end(), values, eps);
+
+    const auto stepped = BCG::arange(0, 10, 0.1);
+    size_t mismatchesArange = 0;
+    for (size_t i = 0; i < 2000; ++i) {
+      const double value = distribution(engine) + 5;
+      mismatchesArange += BCG::findNearbyIdxUniform(stepped.begin(), stepped.end(), value, 0.02) != BCG::findNearbyIdx(stepped.begin(), stepped.end(), value, 0.02);
+    }
+
+    std::cout << "indices at the boundary, outside, NaN    : " << linear[0] << ", " << linear[1] << ", " << linear[2] << ", " << linear[3] << std::endl;
+    std::cout << "mismatches against findNearbyIdx         : " << (sorted != linear) + (uniform != linear) + (batch != linear) + (batchList != linear)
+              << " (sorted, uniform, batch, batch on std::list), " << mismatchesArange << " (uniform on arange)" << std::endl;
+
+    // NaN between values out of order must not hide the disorder
+    const auto tenths = BCG::linspace(0, 1, 11);
+    const std::vector<double> withNaN = {1.0, std::nan(""), 0.5};
+    std::cout << "integer 1, expected 6, 10, [10]          : " << BCG::findNearbyIdxSorted(tenths.begin(), tenths.end(), 1, 0.5) << ", "
+              << BCG::findNearbyIdxUniform(tenths.begin(), tenths.end(), 1, 0.05) << ", "
+              << BCG::vector_to_string(BCG::findNearbyIdxSorted(tenths.begin(), tenths.end(), std::vector<int>{1}, 0.05)) << std::endl;
+    std::cout << "batch on 1, NaN, 0.5, expected 10, -1, 5 : " << BCG::vector_to_string(BCG::findNearbyIdxSorted(tenths.begin(), tenths.end(), withNaN, 0.01)) << std::endl;
+
+    const double perQuery = 1.0 / values.size();
+    std::cout << std::setprecision(3);
+    std::cout << "per query on 10^6 elements, linear       : " << std::chrono::duration<double, std::micro>(tac - tic).count() * perQuery << " us" << std::endl;
+    std::cout << "per query on 10^6 elements, sorted       : " << std::chrono::duration<double, std::micro>(toc - tac).count() * perQuery << " us" << std::endl;
+    std::cout << "per query on 10^6 elements, uniform      : " << std::chrono::duration<double, std::micro>(tuc - toc).count() * perQuery << " us" << std::endl;
+    std::cout << "per query on 10^6 elements, batch        : " << std::chrono::duration<double, std::micro>(tec - tuc).count() * perQuery << " us" << std::endl;
+
+    // many queries: the batch sweep against one binary search each
+    std::vector<double> many(1000000);
+    for (auto & value : many) {value = distribution(engine);}
+    tic = std::chrono::steady_clock::now();
+    std::vector<int> manySorted(many.size());
+    for (size_t i = 0; i < many.size(); ++i) {manySorted[i] = BCG::findNearbyIdxSorted(grid.begin(), grid.end(), many[i], eps);}
+    tac = std::chrono::steady_clock::now();
+    const auto manyBatch = BCG::findNearbyIdxSorted(grid.begin(), grid.end(), many, eps);
+    toc = std::chrono::steady_clock::now();
+    std::sort(many.begin(), many.end());
+    tuc = std::chrono::steady_clock::now();
+    const auto manyBatchSorted = BCG::findNearbyIdxSorted(grid.begin(), grid.end(), many, eps);
+    tec = std::chrono::steady_clock::now();
+
+    std::cout << "10^6 queries, sorted one by one          : " << std::chrono::duration<double, std::milli>(tac - tic).count() << " ms" << std::endl;
+    std::cout << "10^6 queries, batch                      : " << std::chrono::duration<double, std::milli>(toc - tac).count() << " ms ("
+              << (manyBatch == manySorted ? "identical" : "DIFFERENT") << "), "
+              << std::chrono::duration<double, std::milli>(tec - tuc).count() << " ms for presorted queries (checksum "
+              << std::accumulate(manyBatchSorted.begin(), manyBatchSorted.end(), 0ll) << ")" << std::endl;
+  }
+
+  std::cout << std::endl;
+  std::cout << "deduplication and grouping:" << std::endl;
+  {
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+
+    // the quadratic loop that unique_within replaces
+    auto uniqueNaive = [] (const std::vector<double> & values, const double epsilon) {
+      std::vector<double> reVal;
+      for (const auto value : values) {
+        if (BCG::findNearby(reVal.begin(), reVal.end(), value, epsilon) == reVal.end()) {reVal.push_back(value);}
+      }
+      return reVal;
+    };
+
+    // labels of the connected components of "closer than epsilon", numbered by first appearance
+    auto groupNaive = [] (const size_t N, auto isNear) {
+      std::vector<size_t> reVal(N, N);
+      size_t nGroups = 0;
+      for (size_t i = 0; i < N; ++i) {
+        if (reVal[i] != N) {continue;}
+        std::vector<size_t> stack = {i};
+        reVal[i] = nGroups;
+        while (!stack.empty()) {
+          const size_t j = stack.back();
+          stack.pop_back();
+          for (size_t k = 0; k < N; ++k) {
+            if (reVal[k] == N && isNear(j, k)) {reVal[k] = nGroups; stack.push_back(k);}
+          }
+        }
+        ++nGroups;
+      }
+      return reVal;
+    };
+
+    std::vector<double> values(3000);
+    for (auto & value : values) {value = distribution(engine);}
+    for (size_t i = 0; i < 100; ++i) {values[i * 29] = values[i * 13] + 1e-4 * distribution(engine);}
+    values[7] = std::nan("");
+
+    const std::vector<double> small = {1.0, 1.3, 1.6, 5.0, 1.1, 4.8};
+    std::cout << "unique_within(1, 1.3, 1.6, 5, 1.1, 4.8; 0.5): " << BCG::vector_to_string(BCG::unique_within(small.begin(), small.end(), 0.5)) << std::endl;
+    std::cout << "group_within (same)                         : " << BCG::vector_to_string(BCG::group_within (small.begin(), small.end(), 0.5)) << std::endl;
+
+    size_t mismatches = 0;
+    for (const double epsilon : {1e-3, 1e-2, 0.3}) {
+      const auto unique = BCG::unique_within(values.begin(), values.end(), epsilon);
+      const auto naive  = uniqueNaive(values, epsilon);
+      mismatches += !std::equal(unique.begin(), unique.end(), naive.begin(), naive.end(), [] (double a, double b) {return a == b || (a != a && b != b);});
+      mismatches += BCG::group_within(values.begin(), values.end(), epsilon) != groupNaive(values.size(), [&] (size_t j, size_t k) {return std::abs(values[j] - values[k]) < epsilon;});
+    }
+
+    for (const size_t dim : {1, 2, 3, 5}) {
+      std::vector<std::vector<double>> points(2000, std::vector<double>(dim));
+      for (auto & point : points) {for (auto & x : point) {x = distribution(engine);}}
+      for (size_t i = 0; i < 200; ++i) {
+        points[i * 9] = points[i * 4];
+        for (auto & x : points[i * 9]) {x += 0.01 * distribution(engine);}
+      }
+      points[5][0] = std::nan("");
+
+      const double epsilon = 0.05 * dim;
+      auto isNear = [&] (const size_t j, const size_t k) {
+        double sum = 0.0;
+        for (size_t c = 0; c < dim; ++c) {sum += (points[j][c] - points[k][c]) * (points[j][c] - points[k][c]);}
+        return std::sqrt(sum) < epsilon;
+      };
+
+      std::vector<size_t> naive;
+      for (size_t i = 0; i < points.size(); ++i) {
+        if (std::none_of(naive.begin(), naive.end(), [&] (const size_t j) {return isNear(j, i);})) {naive.push_back(i);}
+      }
+      mismatches += BCG::unique_within(points, epsilon, 2) != naive;
+      mismatches += BCG::group_within (points, epsilon, 2) != groupNaive(points.size(), isNear);
+    }
+    std::cout << "mismatches against quadratic loops          : " << mismatches << std::endl;
+
+    try {
+      BCG::unique_within(std::vector<std::vector<double>>{{1, 2}, {3}}, 0.1);
+      std::cout << "points of different dimension: no exception" << std::endl;
+    } catch (const std::invalid_argument &) {
+      std::cout << "points of different dimension: std::invalid_argument" << std::endl;
+    }
+
+    // throughput
+    std::vector<double> many(50000);
+    for (auto & value : many) {value = std::round(distribution(engine) * 20000) * 1e-4 + 1e-9 * distribution(engine);}
+    auto tic = std::chrono::steady_clock::now();
+    const auto naive = uniqueNaive(many, 1e-6);
+    auto tac = std::chrono::steady_clock::now();
+    const auto unique = BCG::unique_within(many.begin(), many.end(), 1e-6);
+    auto toc = std::chrono::steady_clock::now();
+    std::cout << std::setprecision(2);
+    std::cout << "5 * 10^4 values, findNearby loop            : " << std::chrono::duration<double, std::milli>(tac - tic).count() << " ms, unique_within "
+              << std::chrono::duration<double, std::milli>(toc - tac).count() << " ms (" << unique.size() << " values, " << (unique == naive ? "identical" : "DIFFERENT") << ")" << std::endl;
+
+    std::vector<std::vector<double>> cloud(1000000, std::vector<double>(3));
+    for (auto & point : cloud) {for (auto & x : point) {x = std::round(distribution(engine) * 50) * 0.02 + 1e-6 * distribution(engine);}}
+    tic = std::chrono::steady_clock::now();
+    const auto uniquePoints = BCG::unique_within(cloud, 1e-4);
+    tac = std::chrono::steady_clock::now();
+    const auto groups = BCG::group_within(cloud, 1e-4);
+    toc = std::chrono::steady_clock::now();
+    std::cout << "10^6 points in 3D, unique_within            : " << std::chrono::duration<double, std::milli>(tac - tic).count() << " ms (" << uniquePoints.size() << " points)" << std::endl;
+    std::cout << "10^6 points in 3D, group_within             : " << std::chrono::duration<double, std::milli>(toc - tac).count() << " ms (" << *std::max_element(groups.begin(), groups.end()) + 1 << " groups)" << std::endl;
+  }
+
   std::cout << std::defaultfloat;
   std::cout << std::endl << "DONE."<< std::endl << std::endl;
 }